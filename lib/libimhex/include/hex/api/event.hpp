@@ -2,8 +2,10 @@
 
 #include <hex.hpp>
 
+#include <algorithm>
 #include <list>
 #include <map>
+#include <span>
 #include <string_view>
 #include <functional>
 
@@ -147,6 +149,18 @@ namespace hex {
             #endif
         }
 
+        /**
+         * @brief Checks if anything is subscribed to an event
+         * @tparam E Event
+         * @return True if posting the event would call at least one subscriber
+         */
+        template<typename E>
+        [[nodiscard]] static bool hasSubscribers() noexcept {
+            return std::any_of(getEvents().begin(), getEvents().end(), [](const auto &item) {
+                return item.first == E::Id;
+            });
+        }
+
         /**
          * @brief Unsubscribe all subscribers from all events
          */
@@ -198,9 +212,26 @@ namespace hex {
     EVENT_DEF(EventProviderClosed,  prv::Provider *);
     EVENT_DEF(EventProviderDeleted, prv::Provider *);
     EVENT_DEF(EventProviderSaved,   prv::Provider *);
+
+    /**
+     * @brief Called when a provider replaced all of its data after it got opened, e.g. because it finished loading it in the background
+     */
+    EVENT_DEF(EventProviderDataReloaded, prv::Provider *);
     EVENT_DEF(EventWindowInitialized);
     EVENT_DEF(EventBookmarkCreated, ImHexApi::Bookmarks::Entry&);
+
+    /**
+     * @brief Called once for every byte that got patched
+     * @note Prefer EventPatchRangeCreated. This event is only posted if anything is subscribed to it
+     */
     EVENT_DEF(EventPatchCreated, u64, u8, u8);
+
+    /**
+     * @brief Called once for every range of bytes that got patched
+     * The parameters are the address of the range, the original data and the new data. The spans are only valid during the call
+     */
+    EVENT_DEF(EventPatchRangeCreated, u64, std::span<const u8>, std::span<const u8>);
+
     EVENT_DEF(EventPatternExecuted, const std::string&);
     EVENT_DEF(EventPatternEditorChanged, const std::string&);
     EVENT_DEF(EventStoreContentDownloaded, const std::fs::path&);
@@ -255,6 +255,13 @@ namespace hex {
              */
             const std::vector<prv::Provider *> &getProviders();
 
+            /**
+             * @brief Gets a loaded data provider by its ID
+             * @param id ID of the provider
+             * @return The provider with that ID, or nullptr if it isn't loaded (anymore)
+             */
+            prv::Provider *getById(u32 id);
+
             /**
              * @brief Sets the currently selected data provider
              * @param index Index of the provider to select
@@ -147,6 +147,7 @@ namespace hex {
 
         /**
          * @brief Creates a new synchronous task that will execute the given function at the start of the next frame
+         * Functions called this way may defer further calls themselves, those get executed in the frame after
          * @param function Function to be executed
          */
         static void doLater(const std::function<void()> &function);
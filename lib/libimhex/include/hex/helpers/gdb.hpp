@@ -0,0 +1,120 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <wolv/net/socket_client.hpp>
+
+#include <chrono>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace hex::gdb {
+
+    /**
+     * @brief Client side of the GDB Remote Serial Protocol
+     *
+     * When connecting, the features of the stub are queried using qSupported so memory can be read with packets as large
+     * as the stub allows and with the binary `x` packet instead of the hex encoded `m` packet if the stub supports it.
+     * Large reads are split into multiple requests that are all sent out before waiting for the replies, so the
+     * round trip time to the target only has to be paid once per batch of requests instead of once per request.
+     * The client isn't thread safe, only one request may be made at a time
+     */
+    class Client {
+    public:
+        // Number of bytes read with one request if the stub doesn't tell us how large its packets may be
+        constexpr static size_t DefaultReadSize = 0x1000;
+
+        // Maximum number of read requests that are sent out before waiting for their replies
+        constexpr static size_t MaxPendingRequests = 8;
+
+        // Time to wait for a reply before considering the connection broken
+        constexpr static auto ReplyTimeout = std::chrono::seconds(10);
+
+        struct MemoryRange {
+            u64 address;
+            size_t size;
+        };
+
+        Client() = default;
+
+        Client(const Client &) = delete;
+        Client &operator=(const Client &) = delete;
+
+        /**
+         * @brief Connects to a stub and negotiates the features used for all further requests
+         * @return True if the connection was established and the stub answered
+         */
+        bool connect(const std::string &address, u16 port);
+
+        /**
+         * @brief Closes the connection. May be called from another thread to abort a request that's waiting for a reply
+         */
+        void disconnect();
+
+        [[nodiscard]] bool isConnected() const;
+
+        /**
+         * @brief Reads memory of the target
+         * @param address Address to start reading at
+         * @param size Number of bytes to read
+         * @return Bytes read or an empty vector if any part of the range couldn't be read
+         */
+        [[nodiscard]] std::vector<u8> readMemory(u64 address, size_t size);
+
+        /**
+         * @brief Reads multiple ranges of memory of the target, pipelining the requests of all of them together
+         * @param ranges Ranges to read
+         * @return Bytes read for each range. Empty for every range that couldn't be read completely
+         */
+        [[nodiscard]] std::vector<std::vector<u8>> readMemory(std::span<const MemoryRange> ranges);
+
+        /**
+         * @brief Writes memory of the target
+         * @return True if the stub acknowledged all writes
+         */
+        bool writeMemory(u64 address, const void *buffer, size_t size);
+
+        void continueExecution();
+
+        /**
+         * @brief Gets the largest packet size the stub advertised or std::nullopt if it didn't advertise one
+         */
+        [[nodiscard]] std::optional<size_t> getPacketSize() const { return this->m_packetSize; }
+
+        /**
+         * @brief Checks if memory is read using the binary `x` packet
+         */
+        [[nodiscard]] bool isBinaryUploadSupported() const { return this->m_binaryUpload; }
+
+        /**
+         * @brief Gets the number of bytes read with a single request
+         */
+        [[nodiscard]] size_t getMaxReadSize() const;
+
+    private:
+        void sendPacket(const std::string &data);
+
+        /**
+         * @brief Waits for the next packet sent by the stub
+         * @return Payload of the packet with escaped characters and run length encoding already decoded or std::nullopt if the connection broke
+         */
+        std::optional<std::string> receivePacket();
+
+        /**
+         * @brief Waits for the reply to a memory access, skipping any stop replies sent by a running target in between
+         */
+        std::optional<std::string> receiveMemoryReply();
+
+        bool receiveData();
+
+        wolv::net::SocketClient m_socket;
+        std::string m_receiveBuffer;
+
+        std::optional<size_t> m_packetSize;
+        bool m_binaryUpload = false;
+        bool m_noAckMode = false;
+    };
+
+}
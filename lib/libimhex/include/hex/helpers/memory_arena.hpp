@@ -0,0 +1,114 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/intrinsics.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace hex {
+
+    /**
+     * @brief Bump allocator handing out memory that's all freed at once
+     *
+     * Allocating only moves a pointer forward, freeing single allocations does nothing. reset() makes all memory
+     * available again without giving it back to the system. If more than one chunk was needed until then, they get
+     * replaced by a single chunk large enough for all of them, so after a few resets the arena doesn't allocate anymore
+     */
+    class MemoryArena {
+    public:
+        constexpr static size_t DefaultChunkSize = 0x1'0000;
+
+        explicit MemoryArena(size_t chunkSize = DefaultChunkSize);
+
+        MemoryArena(const MemoryArena &) = delete;
+        MemoryArena &operator=(const MemoryArena &) = delete;
+
+        [[nodiscard]] void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        /**
+         * @brief Makes all memory of the arena available again. Everything allocated from it so far must not be used anymore
+         */
+        void reset();
+
+        [[nodiscard]] size_t getUsedSize() const;
+        [[nodiscard]] size_t getCapacity() const;
+
+        /**
+         * @brief Gets the number of chunks that were allocated from the system since the arena was created
+         */
+        [[nodiscard]] u64 getChunkAllocationCount() const { return this->m_chunkAllocationCount; }
+
+    private:
+        struct Chunk {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+        void addChunk(size_t size);
+
+        size_t m_chunkSize;
+        std::vector<Chunk> m_chunks;
+        size_t m_currChunk = 0, m_currOffset = 0;
+        u64 m_chunkAllocationCount = 0;
+    };
+
+    /**
+     * @brief Allocator for standard containers that takes its memory from a MemoryArena
+     */
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(MemoryArena &arena) : m_arena(&arena) { }
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) : m_arena(other.getArena()) { }
+
+        [[nodiscard]] T *allocate(size_t count) {
+            return static_cast<T *>(this->m_arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *pointer, size_t count) {
+            // Freed once the arena gets reset
+            hex::unused(pointer, count);
+        }
+
+        [[nodiscard]] MemoryArena *getArena() const { return this->m_arena; }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U> &other) const { return this->m_arena == other.getArena(); }
+
+    private:
+        MemoryArena *m_arena;
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    /**
+     * @brief Arena for temporary allocations of UI code that only need to live until the end of the current frame.
+     *   Gets reset once the frame has ended. Must only be used from the main thread
+     */
+    class FrameArena {
+    public:
+        FrameArena() = delete;
+
+        [[nodiscard]] static MemoryArena &get();
+        static void reset();
+
+        /**
+         * @brief Creates an empty vector using the frame arena with space for a given number of elements reserved
+         */
+        template<typename T>
+        [[nodiscard]] static ArenaVector<T> createVector(size_t capacity = 0) {
+            ArenaVector<T> result { ArenaAllocator<T>(get()) };
+            result.reserve(capacity);
+
+            return result;
+        }
+    };
+
+}
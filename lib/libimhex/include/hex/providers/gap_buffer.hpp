@@ -0,0 +1,64 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Byte buffer that keeps a gap of unused space at the position that was last inserted into or removed from
+     *
+     * Inserting or removing bytes only moves the data between the previous and the new edit position instead of
+     * everything after it, so a series of edits close to each other stays cheap no matter how large the buffer is.
+     * The data is stored in one block of memory, so reads are at most two copies
+     */
+    class GapBuffer {
+    public:
+        // Smallest amount of space the gap is grown by, to not have to grow it again for every small insertion
+        constexpr static size_t MinGapSize = 0x1'0000;
+
+        GapBuffer() = default;
+        explicit GapBuffer(std::vector<u8> data) : m_buffer(std::move(data)), m_gapStart(m_buffer.size()), m_gapEnd(m_buffer.size()) { }
+
+        [[nodiscard]] u64 getSize() const { return this->m_buffer.size() - this->getGapSize(); }
+        [[nodiscard]] u64 getGapSize() const { return this->m_gapEnd - this->m_gapStart; }
+
+        void read(u64 offset, u8 *buffer, size_t size) const;
+        void write(u64 offset, const u8 *buffer, size_t size);
+
+        /**
+         * @brief Inserts zero bytes
+         */
+        void insert(u64 offset, size_t size);
+        void remove(u64 offset, size_t size);
+        void resize(u64 size);
+
+        /**
+         * @brief Gets a range of bytes without copying them
+         * @return Span of the bytes or std::nullopt if the range is split up by the gap
+         */
+        [[nodiscard]] std::optional<std::span<const u8>> getSpan(u64 offset, size_t size) const;
+
+        /**
+         * @brief Copies the entire content into one contiguous vector
+         */
+        [[nodiscard]] std::vector<u8> toVector() const;
+
+    private:
+        /**
+         * @brief Converts an offset in the data into an index into the buffer, skipping over the gap
+         */
+        [[nodiscard]] u64 toIndex(u64 offset) const { return offset < this->m_gapStart ? offset : offset + this->getGapSize(); }
+
+        void moveGap(u64 offset);
+        void growGap(size_t size);
+        void shrinkGap();
+
+        std::vector<u8> m_buffer;
+        u64 m_gapStart = 0, m_gapEnd = 0;
+    };
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <memory>
+#include <mutex>
+#include <span>
+
+namespace hex::prv {
+
+    /**
+     * @brief Read engine that keeps multiple reads of a file in flight at once using io_uring
+     *
+     * Large reads are split into chunks which are all queued up at the same time so the device can work on
+     * several of them in parallel instead of waiting for one read after another. io_uring is only available
+     * on Linux and may be disabled by the kernel or a sandbox, so always check isValid() and fall back
+     * to regular blocking reads if it's not available
+     */
+    class IoRing {
+    public:
+        constexpr static u32 DefaultQueueDepth = 8;
+        constexpr static size_t DefaultChunkSize = 0x2'0000;
+
+        struct ReadRequest {
+            u64 offset;
+            void *buffer;
+            size_t size;
+        };
+
+        explicit IoRing(u32 queueDepth = DefaultQueueDepth);
+        ~IoRing();
+
+        IoRing(const IoRing &) = delete;
+        IoRing &operator=(const IoRing &) = delete;
+
+        /**
+         * @brief Checks if io_uring is supported by the system and the ring could be set up
+         */
+        [[nodiscard]] bool isValid() const { return this->m_ring != nullptr; }
+
+        [[nodiscard]] u32 getQueueDepth() const { return this->m_queueDepth; }
+
+        /**
+         * @brief Reads a range of a file by splitting it into chunks and keeping up to queue depth many of them in flight
+         * @param fd File descriptor to read from
+         * @param offset Offset in the file to start reading at
+         * @param buffer Buffer to read the data into
+         * @param size Number of bytes to read
+         * @param chunkSize Size of the individual reads. Needs to be a multiple of the sector size for devices that require aligned reads
+         * @return True if all bytes were read, false if a read failed, the end of the file was reached or the ring isn't valid
+         */
+        bool read(int fd, u64 offset, void *buffer, size_t size, size_t chunkSize = DefaultChunkSize);
+
+        /**
+         * @brief Reads multiple ranges of a file, keeping the chunks of all of them in flight together
+         * @param fd File descriptor to read from
+         * @param requests Ranges to read and the buffers to read them into
+         * @param chunkSize Size of the individual reads. Needs to be a multiple of the sector size for devices that require aligned reads
+         * @return True if all bytes of all requests were read, false if a read failed, the end of the file was reached or the ring isn't valid
+         */
+        bool read(int fd, std::span<const ReadRequest> requests, size_t chunkSize = DefaultChunkSize);
+
+    private:
+        // Kernel side ring buffers. Only exists if io_uring could be set up
+        struct Ring;
+
+        std::unique_ptr<Ring> m_ring;
+        u32 m_queueDepth = 0;
+
+        // A ring can only be used by one thread at a time
+        std::mutex m_mutex;
+    };
+
+}
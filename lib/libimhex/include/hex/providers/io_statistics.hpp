@@ -0,0 +1,128 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hex::prv {
+
+    class Provider;
+
+    /**
+     * @brief Collects statistics about the reads done on a provider, split up by who did them
+     *
+     * Collecting is turned off by default, reads then only cost a check of a global flag. Reads get attributed to the
+     * caller set for the thread they're done on, which is the view that's currently being drawn on the main thread and
+     * the running task on worker threads. Cache hits and misses are counted for providers reading through a ProviderCache.
+     * Optionally, the most recent reads can be recorded as a trace
+     */
+    class IoStatistics {
+    public:
+        /**
+         * @brief Bucket n of the latency histogram counts reads that took less than 2^n microseconds. The last one counts all slower reads
+         */
+        constexpr static size_t LatencyBucketCount = 16;
+        constexpr static size_t MaxTraceSize = 0x1'0000;
+
+        struct CallerStatistics {
+            u64 calls = 0;
+            u64 bytes = 0;
+            u64 cacheHits = 0;
+            u64 cacheMisses = 0;
+            std::chrono::nanoseconds totalDuration = { };
+            std::array<u64, LatencyBucketCount> latencyHistogram = { };
+        };
+
+        struct TraceEntry {
+            std::chrono::system_clock::time_point time;
+            u64 offset;
+            size_t size;
+            std::chrono::nanoseconds duration;
+            std::string caller;
+        };
+
+        /**
+         * @brief Measures a single read. Create one at the start of a provider's read function.
+         *   Reads a provider does on itself while another one of its reads is being measured aren't counted separately
+         */
+        class ReadScope {
+        public:
+            ReadScope(Provider *provider, u64 offset, size_t size);
+            ~ReadScope();
+
+            ReadScope(const ReadScope &) = delete;
+            ReadScope &operator=(const ReadScope &) = delete;
+
+        private:
+            friend class IoStatistics;
+
+            IoStatistics *m_statistics = nullptr;
+            ReadScope *m_parent = nullptr;
+
+            u64 m_offset = 0;
+            size_t m_size = 0;
+            u64 m_cacheHits = 0, m_cacheMisses = 0;
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        /**
+         * @brief Sets the caller reads on the current thread get attributed to for as long as it exists
+         * @param caller Name of the caller. Has to stay valid until the scope ends
+         */
+        class CallerScope {
+        public:
+            explicit CallerScope(std::string_view caller);
+            ~CallerScope();
+
+            CallerScope(const CallerScope &) = delete;
+            CallerScope &operator=(const CallerScope &) = delete;
+
+        private:
+            std::string_view m_previousCaller;
+        };
+
+        IoStatistics() = default;
+
+        IoStatistics(const IoStatistics &) = delete;
+        IoStatistics &operator=(const IoStatistics &) = delete;
+
+        static void setEnabled(bool enabled);
+        [[nodiscard]] static bool isEnabled();
+
+        static void setTracingEnabled(bool enabled);
+        [[nodiscard]] static bool isTracingEnabled();
+
+        /**
+         * @brief Counts a cache access towards the read that's currently being measured on this thread, if any
+         */
+        static void recordCacheAccess(bool hit);
+
+        /**
+         * @brief Gets the statistics of all callers. Reads done without a caller set are listed under an empty name
+         */
+        [[nodiscard]] std::map<std::string, CallerStatistics> getCallerStatistics() const;
+
+        /**
+         * @brief Gets the most recent reads in the order they were done in. Only filled while tracing is enabled
+         */
+        [[nodiscard]] std::vector<TraceEntry> getTrace() const;
+
+        void reset();
+
+    private:
+        void record(const ReadScope &scope, std::chrono::nanoseconds duration);
+
+        mutable std::mutex m_mutex;
+        std::map<std::string, CallerStatistics, std::less<>> m_callers;
+        std::deque<TraceEntry> m_trace;
+    };
+
+}
@@ -2,23 +2,142 @@
 
 #include <hex.hpp>
 
+#include <array>
+#include <map>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace hex::prv {
 
+    class OverlayIndex;
+
     class Overlay {
     public:
         Overlay() = default;
+        ~Overlay();
+
+        Overlay(const Overlay &) = delete;
+        Overlay &operator=(const Overlay &) = delete;
 
-        void setAddress(u64 address) { this->m_address = address; }
+        void setAddress(u64 address);
         [[nodiscard]] u64 getAddress() const { return this->m_address; }
 
-        [[nodiscard]] u64 getSize() const { return this->m_data.size(); }
-        [[nodiscard]] std::vector<u8> &getData() { return this->m_data; }
+        [[nodiscard]] u64 getSize() const { return this->m_size; }
+        void resize(size_t size);
+
+        void setData(const std::vector<u8> &data);
+        void setData(const void *buffer, size_t size);
+
+        /**
+         * @brief Writes data into the overlay
+         * @param offset Offset relative to the start of the overlay
+         * @param buffer Data to write
+         * @param size Number of bytes to write
+         */
+        void write(u64 offset, const void *buffer, size_t size);
+
+        /**
+         * @brief Reads data from the overlay
+         * @param offset Offset relative to the start of the overlay
+         * @param buffer Buffer to read the data into
+         * @param size Number of bytes to read
+         */
+        void read(u64 offset, void *buffer, size_t size) const;
 
     private:
+        friend class OverlayIndex;
+
+        /**
+         * @brief Overlay data is split into multiple chunks so large overlays don't require a single huge allocation
+         */
+        constexpr static size_t ChunkSize = 0x10'0000;
+
         u64 m_address = 0;
-        std::vector<u8> m_data;
+        u64 m_size = 0;
+        std::vector<std::vector<u8>> m_chunks;
+
+        OverlayIndex *m_index = nullptr;
+    };
+
+    /**
+     * @brief Index of all overlays of a provider ordered by their address
+     *
+     * Overlays are grouped by the magnitude of their size and every group is sorted by start address.
+     * That way, finding all overlays intersecting a region only requires a single lookup per group.
+     * The order in which overlays were added is kept so overlapping overlays can still be applied in the correct stacking order
+     */
+    class OverlayIndex {
+    public:
+        OverlayIndex() = default;
+        ~OverlayIndex();
+
+        OverlayIndex(const OverlayIndex &) = delete;
+        OverlayIndex &operator=(const OverlayIndex &) = delete;
+
+        void insert(Overlay *overlay);
+        void remove(Overlay *overlay);
+
+        /**
+         * @brief Updates the position of an overlay after its address or size changed
+         * @param overlay Overlay that changed
+         */
+        void update(Overlay *overlay);
+
+        /**
+         * @brief Calls a function for every overlay that intersects a region, in the order the overlays were added
+         * @param region Region to search in
+         * @param callback Function taking a pointer to the overlay
+         */
+        template<typename F>
+        void forEachOverlapping(const Region &region, F &&callback) const {
+            for (const auto overlay : this->findOverlapping(region))
+                callback(overlay);
+        }
+
+        /**
+         * @brief Finds the lowest start address of all overlays that start after a given address
+         * @param address Address to search from
+         * @return Start address of the next overlay or std::nullopt if there is none
+         */
+        [[nodiscard]] std::optional<u64> findNextStart(u64 address) const;
+
+        /**
+         * @brief Checks if any overlay intersects a region
+         * @param region Region to check
+         * @return True if at least one overlay intersects the region
+         */
+        [[nodiscard]] bool overlaps(const Region &region) const;
+
+        [[nodiscard]] bool empty() const { return this->m_entries.empty(); }
+
+    private:
+        constexpr static size_t SizeClassCount = 65;
+
+        using Key = std::pair<u64, u64>;
+
+        struct Entry {
+            u64 sequence;
+            u64 address;
+            u64 size;
+        };
+
+        [[nodiscard]] static size_t getSizeClass(u64 size);
+        [[nodiscard]] std::vector<Overlay *> findOverlapping(const Region &region) const;
+
+        /**
+         * @brief Calls a function for every overlay intersecting a region in no particular order. Stops as soon as the function returns false
+         * @return False if the search was stopped early
+         */
+        template<typename F>
+        bool visitOverlapping(const Region &region, F &&callback) const;
+
+        void addToSizeClass(Overlay *overlay, const Entry &entry);
+        void removeFromSizeClass(const Entry &entry);
+
+        std::array<std::map<Key, Overlay *>, SizeClassCount> m_sizeClasses;
+        std::unordered_map<Overlay *, Entry> m_entries;
+        u64 m_sequence = 0;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/providers/patch_store.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Undo / Redo history of the patches of a provider
+     *
+     * Instead of keeping a full copy of all patches for every undo point, each undo point only records
+     * the patches that were in place before the modified ranges got changed. Undoing a change restores
+     * these ranges and remembers their current content so the change can be redone again later on.
+     * Creating an undo point therefore only costs O(size of the change)
+     */
+    class PatchHistory {
+    public:
+        PatchHistory() = default;
+
+        [[nodiscard]] PatchStore &getPatches() { return this->m_patches; }
+        [[nodiscard]] const PatchStore &getPatches() const { return this->m_patches; }
+
+        /**
+         * @brief Records a change to a range of patches in the current undo point
+         * @param address Address of the first byte that will be modified
+         * @param size Number of bytes that will be modified
+         * @return Patch store that may be modified within the given range
+         */
+        [[nodiscard]] PatchStore &change(u64 address, size_t size);
+
+        void shift(u64 address, i64 amount);
+        void replace(PatchStore patches);
+
+        /**
+         * @brief Starts a new undo point. All changes made after this get undone together.
+         * Any changes that could previously be redone are discarded
+         */
+        void createUndoPoint();
+
+        void undo();
+        void redo();
+
+        [[nodiscard]] bool canUndo() const;
+        [[nodiscard]] bool canRedo() const;
+
+        /**
+         * @brief Regions of patched bytes that get modified by the next call to undo() or redo()
+         */
+        [[nodiscard]] std::vector<Region> getUndoRegions() const;
+        [[nodiscard]] std::vector<Region> getRedoRegions() const;
+
+        /**
+         * @brief Number of bytes currently used by the recorded undo points
+         */
+        [[nodiscard]] size_t getMemoryUsage() const { return this->m_memoryUsage; }
+
+        /**
+         * @brief Sets the maximum amount of memory all undo points of a provider are allowed to use.
+         * When this limit gets exceeded, the oldest undo points are dropped
+         * @param limit Limit in bytes
+         */
+        static void setMemoryLimit(size_t limit);
+        [[nodiscard]] static size_t getMemoryLimit();
+
+    private:
+        struct Change {
+            u64 address;
+            size_t size;
+            PatchStore before, after;
+        };
+
+        struct UndoPoint {
+            std::vector<Change> changes;
+            size_t memoryUsage = 0;
+        };
+
+        void enforceMemoryLimit();
+
+        /**
+         * @brief Collects the patched regions within all changes of an undo point, both in the current patches and in the given state of each change
+         */
+        [[nodiscard]] std::vector<Region> getChangedRegions(const UndoPoint &undoPoint, PatchStore Change::*state) const;
+
+        PatchStore m_patches;
+
+        std::deque<UndoPoint> m_undoPoints;
+        size_t m_appliedUndoPoints = 0;
+        size_t m_memoryUsage = 0;
+    };
+
+}
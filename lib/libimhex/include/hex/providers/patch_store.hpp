@@ -0,0 +1,224 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace hex::prv {
+
+    /**
+     * @brief Stores the patches of a provider as a set of non-overlapping runs of contiguous patched bytes
+     *
+     * Runs are indexed by their start address so overlap queries only cost O(log n + k) where k is the number
+     * of runs that intersect the queried region. Adjacent runs are merged on insertion so the memory usage is
+     * proportional to the number of runs rather than to the number of individually patched bytes.
+     * Runs can also consist of a short pattern that is repeated over a large range, e.g. when filling a region.
+     * Such runs are only expanded chunk by chunk when they're being read.
+     */
+    class PatchStore {
+    public:
+        /**
+         * @brief A single run of patched bytes. Either holds all of its bytes or a pattern that gets repeated until the run's size is reached
+         */
+        class Extent {
+        public:
+            Extent() = default;
+            explicit Extent(std::vector<u8> data) : m_data(std::move(data)), m_size(m_data.size()) { }
+            Extent(std::vector<u8> pattern, size_t size) : m_data(std::move(pattern)), m_size(size) { }
+
+            [[nodiscard]] size_t size() const { return this->m_size; }
+            [[nodiscard]] bool isPattern() const { return this->m_data.size() != this->m_size; }
+
+            /**
+             * @brief Returns all bytes of the run, or the repeated pattern if this is a pattern run
+             */
+            [[nodiscard]] const std::vector<u8> &getData() const { return this->m_data; }
+
+            [[nodiscard]] u8 operator[](u64 offset) const { return this->m_data[offset % this->m_data.size()]; }
+
+            /**
+             * @brief Copies bytes of the run into a buffer, expanding the pattern if necessary
+             * @param offset Offset within the run
+             * @param buffer Buffer to copy the bytes to
+             * @param size Number of bytes to copy
+             */
+            void copyTo(u64 offset, u8 *buffer, size_t size) const;
+
+            /**
+             * @brief Creates a new run containing part of this one
+             * @param offset Offset within the run
+             * @param size Size of the new run
+             * @return The new run. Small parts of pattern runs are converted to regular runs
+             */
+            [[nodiscard]] Extent slice(u64 offset, size_t size) const;
+
+            bool operator==(const Extent &other) const = default;
+
+        private:
+            friend class PatchStore;
+
+            /**
+             * @brief Checks if another pattern run continues this one seamlessly so both can be merged
+             */
+            [[nodiscard]] bool isContinuedBy(const Extent &other) const;
+
+            std::vector<u8> m_data;
+            size_t m_size = 0;
+        };
+
+        using Extents = std::map<u64, Extent>;
+
+        PatchStore() = default;
+
+        /**
+         * @brief Sets the patched value of a range of bytes, replacing any previous patches in that range
+         * @param address Address of the first byte
+         * @param buffer Patched values
+         * @param size Number of bytes
+         */
+        void set(u64 address, const void *buffer, size_t size);
+
+        /**
+         * @brief Sets a range of bytes to a repeating pattern, replacing any previous patches in that range
+         * @param address Address of the first byte
+         * @param pattern Pattern to repeat. The first byte of the pattern is placed at address
+         * @param patternSize Size of the pattern
+         * @param size Number of bytes to fill
+         */
+        void setPattern(u64 address, const void *pattern, size_t patternSize, size_t size);
+
+        /**
+         * @brief Removes all patches in a range of bytes
+         * @param address Address of the first byte
+         * @param size Number of bytes
+         */
+        void erase(u64 address, size_t size = 1);
+
+        /**
+         * @brief Moves all patches at or after a given address by a signed amount.
+         * If moving patches backwards makes them overlap existing patches, the existing ones are kept
+         * @param address First address that gets moved
+         * @param amount Number of bytes to move the patches by
+         */
+        void shift(u64 address, i64 amount);
+
+        void clear();
+
+        /**
+         * @brief Creates a new store containing only the patches within a range of bytes
+         * @param address Address of the first byte
+         * @param size Number of bytes
+         * @return Store with all patches inside the range
+         */
+        [[nodiscard]] PatchStore copyRange(u64 address, size_t size) const;
+
+        /**
+         * @brief Replaces all patches within a range of bytes with the ones from another store
+         * @param address Address of the first byte
+         * @param size Number of bytes
+         * @param patches Store containing the new patches. Patches outside of the range are ignored
+         */
+        void replaceRange(u64 address, size_t size, const PatchStore &patches);
+
+        /**
+         * @brief Copies all patched bytes within a range onto a buffer
+         * @param address Address the buffer starts at
+         * @param buffer Buffer to write the patched bytes to
+         * @param size Size of the buffer
+         */
+        void apply(u64 address, void *buffer, size_t size) const;
+
+        [[nodiscard]] std::optional<u8> get(u64 address) const;
+        [[nodiscard]] bool contains(u64 address) const;
+
+        /**
+         * @brief Finds the first run that contains or comes after a given address
+         * @param address Address to start searching at
+         * @return Region of the run or std::nullopt if there are no more patches after this address
+         */
+        [[nodiscard]] std::optional<Region> findNext(u64 address) const;
+
+        /**
+         * @brief Calls a function for every run that overlaps a given region, clipped to that region.
+         * Pattern runs are expanded and passed to the callback in multiple chunks
+         * @param region Region to search in
+         * @param callback Function taking the address and the bytes of each overlapping part of a run
+         */
+        template<typename F>
+        void forEachOverlapping(const Region &region, F &&callback) const {
+            if (region.getSize() == 0)
+                return;
+
+            std::vector<u8> expandedPattern;
+            for (auto it = this->findFirstOverlapping(region.getStartAddress()); it != this->m_extents.end() && it->first <= region.getEndAddress(); ++it) {
+                const auto &[extentAddress, extent] = *it;
+
+                const u64 start = std::max(extentAddress, region.getStartAddress());
+                const u64 end   = std::min<u64>(extentAddress + extent.size() - 1, region.getEndAddress());
+
+                if (!extent.isPattern()) {
+                    callback(start, extent.getData().data() + (start - extentAddress), size_t((end - start) + 1));
+                    continue;
+                }
+
+                for (u64 chunkStart = start; chunkStart <= end;) {
+                    const auto chunkSize = size_t(std::min<u64>(PatternChunkSize, (end - chunkStart) + 1));
+
+                    expandedPattern.resize(chunkSize);
+                    extent.copyTo(chunkStart - extentAddress, expandedPattern.data(), chunkSize);
+                    callback(chunkStart, static_cast<const u8 *>(expandedPattern.data()), chunkSize);
+
+                    chunkStart += chunkSize;
+                    if (chunkStart == 0)
+                        break;
+                }
+            }
+        }
+
+        /**
+         * @brief Number of patched bytes
+         */
+        [[nodiscard]] size_t size() const { return this->m_size; }
+        [[nodiscard]] bool empty() const { return this->m_extents.empty(); }
+
+        /**
+         * @brief Number of bytes actually needed to store the patches
+         */
+        [[nodiscard]] size_t getStoredSize() const;
+
+        [[nodiscard]] const Extents &getExtents() const { return this->m_extents; }
+
+        /**
+         * @brief Converts the patches to a map of single bytes as used by the patch file exporters
+         */
+        [[nodiscard]] std::map<u64, u8> toMap() const;
+        static PatchStore fromMap(const std::map<u64, u8> &patches);
+
+        [[nodiscard]] auto begin() const { return this->m_extents.begin(); }
+        [[nodiscard]] auto end() const { return this->m_extents.end(); }
+
+        bool operator==(const PatchStore &other) const = default;
+
+    private:
+        /**
+         * @brief Pattern runs are expanded in chunks of this size when iterating over them
+         */
+        constexpr static size_t PatternChunkSize = 0x1'0000;
+
+        [[nodiscard]] Extents::const_iterator findFirstOverlapping(u64 address) const;
+        void splitAt(u64 address);
+        void insert(u64 address, const Extent &extent);
+
+        Extents m_extents;
+        size_t m_size = 0;
+    };
+
+    void to_json(nlohmann::json &j, const PatchStore &patches);
+    void from_json(const nlohmann::json &j, PatchStore &patches);
+
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Describes the content of a provider that had bytes inserted or removed in terms of its original data
+     *
+     * The data is made up of pieces that either reference a range of the original data or hold newly inserted bytes.
+     * Inserting or removing bytes only splits and shifts pieces, the original data itself is never touched.
+     * Inserted bytes are zero until something is written to them, so large insertions don't need any memory
+     */
+    class PieceTable {
+    public:
+        struct Piece {
+            u64 address;
+            u64 size;
+
+            /**
+             * @brief Address of the piece's data in the original data. Not set for inserted bytes
+             */
+            std::optional<u64> originalAddress;
+
+            /**
+             * @brief Content of inserted bytes. Empty if the bytes were never written and are still zero
+             */
+            std::vector<u8> data;
+        };
+
+        PieceTable() = default;
+        explicit PieceTable(u64 size) { this->reset(size); }
+
+        /**
+         * @brief Drops all edits. Afterwards the data is the same as the original data again
+         * @param size Size of the original data
+         */
+        void reset(u64 size);
+
+        void insert(u64 address, u64 size);
+        void remove(u64 address, u64 size);
+
+        [[nodiscard]] u64 getSize() const { return this->m_size; }
+        [[nodiscard]] u64 getOriginalSize() const { return this->m_originalSize; }
+
+        /**
+         * @brief Checks if any bytes were inserted or removed since the last reset
+         */
+        [[nodiscard]] bool isModified() const;
+
+        [[nodiscard]] const std::vector<Piece> &getPieces() const { return this->m_pieces; }
+
+        /**
+         * @brief Finds the piece containing an address
+         * @return Pointer to the piece or nullptr if the address is past the end of the data
+         */
+        [[nodiscard]] const Piece *getPiece(u64 address) const;
+
+        /**
+         * @brief Finds where a range of bytes is located in the original data
+         * @param address Address of the range
+         * @param size Size of the range
+         * @return Original address of the range or std::nullopt if the range isn't one contiguous run of original data
+         */
+        [[nodiscard]] std::optional<u64> findOriginalAddress(u64 address, u64 size) const;
+
+        /**
+         * @brief Reads a range of bytes
+         * @param address Address to start reading at
+         * @param buffer Buffer to read the bytes into
+         * @param size Number of bytes to read
+         * @param readOriginal Function taking an original address, a buffer and a size that reads from the original data
+         */
+        template<typename F>
+        void read(u64 address, u8 *buffer, u64 size, F &&readOriginal) const {
+            for (auto it = this->findPiece(address); it != this->m_pieces.end() && it->address < address + size; ++it) {
+                const u64 start = std::max(address, it->address);
+                const u64 end   = std::min(address + size, it->address + it->size);
+                u8 *target      = buffer + (start - address);
+
+                if (it->originalAddress.has_value())
+                    readOriginal(*it->originalAddress + (start - it->address), target, end - start);
+                else if (it->data.empty())
+                    std::fill_n(target, end - start, 0x00);
+                else
+                    std::copy_n(it->data.begin() + (start - it->address), end - start, target);
+            }
+        }
+
+        /**
+         * @brief Writes a range of bytes. Writes to original data are passed on, writes to inserted bytes are stored in the table
+         * @param address Address to start writing at
+         * @param buffer Bytes to write
+         * @param size Number of bytes to write
+         * @param writeOriginal Function taking an original address, a buffer and a size that writes to the original data
+         */
+        template<typename F>
+        void write(u64 address, const u8 *buffer, u64 size, F &&writeOriginal) {
+            if (size == 0 || address >= this->m_size)
+                return;
+
+            size = std::min(size, this->m_size - address);
+
+            // Only keep the part of a zero piece that's actually written to in memory
+            this->splitAt(address);
+            this->splitAt(address + size);
+
+            for (auto it = this->findPiece(address); it != this->m_pieces.end() && it->address < address + size; ++it) {
+                const u8 *source = buffer + (it->address - address);
+
+                if (it->originalAddress.has_value())
+                    writeOriginal(*it->originalAddress, source, it->size);
+                else
+                    it->data.assign(source, source + it->size);
+            }
+
+            this->mergeAt(address + size);
+            this->mergeAt(address);
+        }
+
+    private:
+        [[nodiscard]] std::vector<Piece>::const_iterator findPiece(u64 address) const;
+        [[nodiscard]] std::vector<Piece>::iterator findPiece(u64 address);
+
+        /**
+         * @brief Makes sure a piece starts at the given address
+         * @return Index of the piece starting at the address
+         */
+        size_t splitAt(u64 address);
+
+        /**
+         * @brief Merges the piece starting at the given address with its predecessor if both are adjacent in the original data
+         * or both are unwritten inserted bytes
+         */
+        void mergeAt(u64 address);
+
+        std::vector<Piece> m_pieces;
+        u64 m_size = 0;
+        u64 m_originalSize = 0;
+    };
+
+}
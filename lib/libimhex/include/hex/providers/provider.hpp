@@ -2,20 +2,27 @@
 
 #include <hex.hpp>
 
+#include <functional>
 #include <list>
 #include <map>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include <hex/api/imhex_api.hpp>
 #include <hex/providers/overlay.hpp>
+#include <hex/providers/io_statistics.hpp>
+#include <hex/providers/patch_history.hpp>
 #include <hex/helpers/fs.hpp>
 
 #include <nlohmann/json.hpp>
 
 namespace hex::prv {
 
+    class Snapshot;
+
     /**
      * @brief Represent the data source for a tab in the UI
      */
@@ -31,6 +38,29 @@ namespace hex::prv {
             std::function<void()> callback;
         };
 
+        /**
+         * @brief A single read operation of a batch passed to readv()
+         */
+        struct ReadRequest {
+            u64 offset;
+            size_t size;
+            void *buffer;
+        };
+
+        /**
+         * @brief A fill whose data was gathered by prepareFill() and that still needs to be applied using fill()
+         */
+        struct PreparedFill {
+            u64 offset;
+            size_t size;
+            std::vector<u8> pattern;
+
+            /**
+             * @brief Values the filled bytes had before. Only gathered by providers that store fills as patches and only if anybody listens to patch events
+             */
+            std::vector<u8> originalValues;
+        };
+
         constexpr static size_t MaxPageSize = 0x1000'0000;
 
         Provider();
@@ -61,6 +91,14 @@ namespace hex::prv {
          */
         [[nodiscard]] virtual bool isDumpable() const;
 
+        /**
+         * @brief Controls whether the data of this provider only ever changes through its own functions.
+         *   Snapshots of such providers keep reading unchanged data from them instead of copying everything up front.
+         *   Must be false for providers whose data may change by itself, e.g. memory of a running process or files modified by other programs.
+         *   Default implementation returns false.
+         */
+        [[nodiscard]] virtual bool isDataStable() const;
+
         /**
          * @brief Read data from this provider, applying overlays and patches
          * @param offset offset to start reading the data
@@ -70,6 +108,48 @@ namespace hex::prv {
          */
         virtual void read(u64 offset, void *buffer, size_t size, bool overlays = true);
         
+        /**
+         * @brief Read multiple ranges of data from this provider at once, applying overlays and patches
+         * Requests that are close to each other get merged so they can be served by a single read
+         * @param requests list of ranges to read and the buffers to read them into
+         * @param overlays apply overlays and patches is true
+         */
+        virtual void readv(std::span<const ReadRequest> requests, bool overlays = true);
+
+        /**
+         * @brief Tries to access data of this provider directly without copying it
+         * @param offset offset of the data
+         * @param size number of bytes to access
+         * @return span pointing directly into the provider's memory, or std::nullopt if the data isn't available that way,
+         *   e.g. because it's not held in memory or because patches or overlays modify it.
+         *   The span is only valid until the provider gets modified, resized or closed
+         */
+        [[nodiscard]] virtual std::optional<std::span<const u8>> tryGetSpan(u64 offset, size_t size);
+
+        /**
+         * @brief Read data from this provider, applying overlays and patches, without copying it if possible
+         * @param offset offset to start reading the data
+         * @param size number of bytes to read
+         * @param buffer buffer the data gets read into if it can't be accessed directly
+         * @return span containing the data. Points either into the provider's memory or into buffer
+         */
+        [[nodiscard]] std::span<const u8> readSpan(u64 offset, size_t size, std::vector<u8> &buffer);
+
+        /**
+         * @brief Checks if a region can be read right away without having to wait for a slow backend
+         * Default implementation returns true
+         * @param offset offset of the region
+         * @param size size of the region
+         */
+        [[nodiscard]] virtual bool isDataAvailable(u64 offset, size_t size) const;
+
+        /**
+         * @brief Hints that a region will likely be read soon so the provider can start loading it in the background
+         * Default implementation does nothing
+         * @param region region to load
+         */
+        virtual void prefetch(const Region &region);
+
         /**
          * @brief Write data to the patches of this provider. Will not directly modify provider.
          * @param offset offset to start writing the data
@@ -78,6 +158,24 @@ namespace hex::prv {
          */
         virtual void write(u64 offset, const void *buffer, size_t size);
 
+        /**
+         * @brief Gathers everything needed to fill a region of this provider with a repeating pattern.
+         *   Only reads from the provider so it may run on a worker thread while the provider stays open
+         * Default implementation doesn't read anything
+         * @param offset offset to start filling at
+         * @param size number of bytes to fill
+         * @param pattern bytes to repeat
+         * @param progressCallback called with the number of bytes processed so far. May throw to cancel the operation, in which case nothing was modified
+         * @return fill to pass to fill()
+         */
+        [[nodiscard]] virtual PreparedFill prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback = { });
+
+        /**
+         * @brief Fills a region of this provider with a repeating pattern. Has to be called on the main thread
+         * @param fill fill returned by prepareFill()
+         */
+        virtual void fill(const PreparedFill &fill);
+
         virtual void resize(size_t newSize);
         virtual void insert(u64 offset, size_t size);
         virtual void remove(u64 offset, size_t size);
@@ -103,8 +201,8 @@ namespace hex::prv {
 
         void applyOverlays(u64 offset, void *buffer, size_t size);
 
-        [[nodiscard]] std::map<u64, u8> &getPatches();
-        [[nodiscard]] const std::map<u64, u8> &getPatches() const;
+        [[nodiscard]] PatchStore &getPatches();
+        [[nodiscard]] const PatchStore &getPatches() const;
         void applyPatches();
 
         [[nodiscard]] Overlay *newOverlay();
@@ -138,7 +236,22 @@ namespace hex::prv {
         [[nodiscard]] virtual bool open() = 0;
         virtual void close() = 0;
 
+        /**
+         * @brief Drops resources like mappings, file handles and caches that can be recreated transparently on the next access.
+         *   Called on the main thread for providers in background tabs that haven't been looked at in a while, never while tasks are running.
+         *   Default implementation does nothing
+         */
+        virtual void releaseResources();
+
         void addPatch(u64 offset, const void *buffer, size_t size, bool createUndo = false);
+
+        /**
+         * @brief Patches a region with a repeating pattern without storing every single byte
+         * @param fill fill returned by preparePatchFill()
+         * @param createUndo true to start a new undo point before the fill
+         */
+        void addFillPatch(const PreparedFill &fill, bool createUndo = false);
+        void addFillPatch(u64 offset, size_t size, const std::vector<u8> &pattern, bool createUndo = false);
         void createUndoPoint();
 
         void undo();
@@ -172,19 +285,74 @@ namespace hex::prv {
 
         [[nodiscard]] virtual std::pair<Region, bool> getRegionValidity(u64 address) const;
 
+        /**
+         * @brief Checks if the bytes starting at an address are known to be zero without having to read them,
+         *   e.g. because they're part of a hole in a sparse file. Patches and overlays are taken into account
+         *   Default implementation never reports any known zero bytes
+         * @param address address to check
+         * @return region starting at the address whose bytes are either all known to be zero or not, and true if they are
+         */
+        [[nodiscard]] virtual std::pair<Region, bool> getZeroRegion(u64 address) const;
+
         void skipLoadInterface() { this->m_skipLoadInterface = true; }
         [[nodiscard]] bool shouldSkipLoadInterface() const { return this->m_skipLoadInterface; }
 
+        /**
+         * @brief Registers a snapshot that still reads unchanged data from this provider. Done by the snapshot itself
+         */
+        void attachSnapshot(Snapshot *snapshot);
+        void detachSnapshot(Snapshot *snapshot);
+
+        /**
+         * @brief Copies all data the snapshots of this provider still read from it into them. Must be called before the provider gets closed
+         */
+        void detachSnapshots();
+
         void setErrorMessage(const std::string &errorMessage) { this->m_errorMessage = errorMessage; }
         [[nodiscard]] const std::string& getErrorMessage() const { return this->m_errorMessage; }
 
+        /**
+         * @brief Gets the statistics about the reads done on this provider. Providers overriding read() or readv() need to measure their reads using an IoStatistics::ReadScope
+         */
+        [[nodiscard]] IoStatistics& getIoStatistics() { return this->m_ioStatistics; }
+        [[nodiscard]] const IoStatistics& getIoStatistics() const { return this->m_ioStatistics; }
+
+    protected:
+        /**
+         * @brief Checks if neither patches nor overlays modify any byte in a region
+         * @param offset offset of the region
+         * @param size size of the region
+         */
+        [[nodiscard]] bool isUnmodified(u64 offset, size_t size) const;
+
+        /**
+         * @brief Finds the first byte in a region that's modified by patches or overlays
+         * @param region region to search in
+         * @return address of the first modified byte or std::nullopt if the whole region is unmodified
+         */
+        [[nodiscard]] std::optional<u64> findFirstModification(const Region &region) const;
+
+        /**
+         * @brief Lets all snapshots of this provider copy a region before it gets modified
+         * @param region region about to be modified
+         */
+        void materializeSnapshots(const Region &region);
+
+        /**
+         * @brief prepareFill() implementation for providers that store fills using addFillPatch(). Reads the original values needed for the patch events
+         */
+        [[nodiscard]] PreparedFill preparePatchFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback = { });
+
+    private:
+        void postPatchEvents(u64 offset, std::span<const u8> originalValues, std::span<const u8> newValues);
+
     protected:
         u32 m_currPage    = 0;
         u64 m_baseAddress = 0;
 
-        std::list<std::map<u64, u8>> m_patches;
-        decltype(m_patches)::iterator m_currPatches;
+        PatchHistory m_patchHistory;
         std::list<Overlay *> m_overlays;
+        OverlayIndex m_overlayIndex;
 
         u32 m_id;
 
@@ -206,6 +374,12 @@ namespace hex::prv {
         std::string m_errorMessage;
 
         size_t m_pageSize = MaxPageSize;
+
+    private:
+        std::vector<Snapshot *> m_snapshots;
+        std::mutex m_snapshotMutex;
+
+        IoStatistics m_ioStatistics;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Thread-safe block cache that providers can put in front of slow backends
+     *
+     * Data is cached in fixed size blocks which are distributed over multiple independently locked shards
+     * so concurrent readers don't block each other. Each shard evicts its least recently used blocks once
+     * the byte budget of the cache is exceeded. Neighbouring blocks that aren't cached yet are fetched
+     * from the backend using a single read.
+     *
+     * Usage: Call read() from within the provider's readRaw() function and pass it a function that does
+     * the actual uncached read. Call invalidate() or clear() whenever the underlying data changes,
+     * e.g. in writeRaw() or resize(). Call prefetch() to load data into the cache on a background thread
+     * before it's needed. The read function then needs to be safe to call from multiple threads
+     */
+    class ProviderCache {
+    public:
+        constexpr static size_t DefaultBlockSize = 0x1000;
+        constexpr static size_t DefaultBudget    = 0x100'0000;
+
+        using ReadFunction = std::function<void(u64 offset, void *buffer, size_t size)>;
+
+        struct ReadRequest {
+            u64 offset;
+            size_t size;
+            void *buffer;
+        };
+
+        using ReadvFunction = std::function<void(std::span<const ReadRequest> requests)>;
+
+        struct Statistics {
+            u64 hits;
+            u64 misses;
+            u64 evictions;
+            size_t usedBytes;
+        };
+
+        explicit ProviderCache(size_t blockSize = DefaultBlockSize, size_t budget = DefaultBudget);
+
+        ProviderCache(const ProviderCache &) = delete;
+        ProviderCache &operator=(const ProviderCache &) = delete;
+
+        /**
+         * @brief Reads data through the cache
+         * @param offset Offset to start reading at
+         * @param buffer Buffer to read the data into
+         * @param size Number of bytes to read
+         * @param dataSize Total size of the underlying data. Nothing past this will be read or cached
+         * @param readFunction Function used to read data from the backend on cache misses
+         */
+        void read(u64 offset, void *buffer, size_t size, size_t dataSize, const ReadFunction &readFunction);
+
+        /**
+         * @brief Reads multiple ranges through the cache, fetching everything that's missing with a single backend call
+         * @param requests Ranges to read and the buffers to read them into
+         * @param dataSize Total size of the underlying data. Nothing past this will be read or cached
+         * @param readFunction Function used to read all missing ranges from the backend at once
+         */
+        void readv(std::span<const ReadRequest> requests, size_t dataSize, const ReadvFunction &readFunction);
+
+        /**
+         * @brief Loads data into the cache on a background thread.
+         * If more prefetch requests are queued up than can be served, the oldest ones are dropped
+         * @param offset Offset to start loading at
+         * @param size Number of bytes to load
+         * @param dataSize Total size of the underlying data. Nothing past this will be loaded
+         * @param readFunction Function used to read data from the backend
+         */
+        void prefetch(u64 offset, size_t size, size_t dataSize, ReadFunction readFunction);
+
+        /**
+         * @brief Checks if a range is completely held in the cache
+         * @param offset Offset of the range
+         * @param size Size of the range
+         * @param dataSize Total size of the underlying data. Bytes past this are ignored
+         * @return True if reading the range wouldn't require any backend reads
+         */
+        [[nodiscard]] bool contains(u64 offset, size_t size, size_t dataSize) const;
+
+        /**
+         * @brief Blocks until the prefetch that's currently running, if any, has finished
+         */
+        void waitForPrefetch();
+
+        /**
+         * @brief Drops all cached blocks that overlap a given range
+         * @param offset Offset of the range
+         * @param size Size of the range
+         */
+        void invalidate(u64 offset, size_t size);
+
+        /**
+         * @brief Drops all cached blocks
+         */
+        void clear();
+
+        /**
+         * @brief Changes the block size of the cache. This clears the cache and must not be called while other threads are reading from it
+         * @param blockSize New block size
+         */
+        void setBlockSize(size_t blockSize);
+        [[nodiscard]] size_t getBlockSize() const { return this->m_blockSize; }
+
+        /**
+         * @brief Changes the maximum number of bytes the cache may hold
+         * @param budget New budget in bytes
+         */
+        void setBudget(size_t budget);
+        [[nodiscard]] size_t getBudget() const { return this->m_budget; }
+
+        [[nodiscard]] Statistics getStatistics() const;
+        void resetStatistics();
+
+    private:
+        constexpr static size_t ShardCount = 8;
+        constexpr static size_t MaxPrefetchRequests = 16;
+
+        struct Block {
+            u64 index;
+            std::vector<u8> data;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<Block> blocks;
+            std::unordered_map<u64, std::list<Block>::iterator> lookup;
+            size_t usedBytes = 0;
+        };
+
+        struct PrefetchRequest {
+            u64 offset;
+            size_t size;
+            size_t dataSize;
+            ReadFunction readFunction;
+        };
+
+        [[nodiscard]] Shard &getShard(u64 blockIndex);
+        [[nodiscard]] const Shard &getShard(u64 blockIndex) const;
+        bool copyFromBlock(u64 blockIndex, u64 blockOffset, u8 *buffer, size_t size);
+        void insertBlock(u64 blockIndex, const u8 *data, size_t size);
+        void evict(Shard &shard, size_t shardBudget);
+
+        void processPrefetchRequests(const std::stop_token &stopToken);
+
+        std::array<Shard, ShardCount> m_shards;
+
+        std::atomic<size_t> m_blockSize;
+        std::atomic<size_t> m_budget;
+
+        std::atomic<u64> m_hits = 0, m_misses = 0, m_evictions = 0;
+
+        std::mutex m_prefetchMutex;
+        std::condition_variable_any m_prefetchRequested;
+        std::condition_variable m_prefetchFinished;
+        std::deque<PrefetchRequest> m_prefetchRequests;
+        bool m_prefetchRunning = false;
+
+        // Declared last so the prefetch thread gets stopped before anything it uses is destroyed
+        std::jthread m_prefetchThread;
+    };
+
+}
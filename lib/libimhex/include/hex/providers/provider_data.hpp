@@ -71,6 +71,7 @@ namespace hex {
 
     private:
         void onCreate() {
+            // Create the data as soon as a provider opens. get() is called from tasks too, so it must never have to insert anything
             EventManager::subscribe<EventProviderOpened>(this, [this](prv::Provider *provider) {
                 this->m_data.emplace(provider, T());
             });
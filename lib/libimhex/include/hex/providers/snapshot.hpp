@@ -0,0 +1,134 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace hex::prv {
+
+    class Provider;
+
+    /**
+     * @brief Frozen state of the data of a provider at the time the snapshot was taken
+     *
+     * The data is split up into fixed size blocks that never change once created and that are shared between snapshots by
+     * reference. Blocks only containing zeros or lying in address space the provider has nothing mapped at aren't stored at all.
+     *
+     * Providers whose data only changes through their own functions (see Provider::isDataStable()) aren't copied when the
+     * snapshot is taken. The snapshot keeps reading unchanged data from them and a block only gets copied right before the
+     * provider modifies it. The data of all other providers, e.g. ones showing the memory of a running target, may change
+     * at any time, so it's copied right away. Blocks that didn't change since an earlier snapshot of the same provider are
+     * shared with that snapshot instead of being stored again
+     */
+    class Snapshot {
+    public:
+        constexpr static size_t BlockSize = 0x1'0000;
+
+        /**
+         * @brief Takes a snapshot of a provider
+         * Snapshots of providers with stable data register themselves with the provider, so they have to be taken on the main thread.
+         * All others only read from the provider and may be taken on a worker thread
+         * @param provider Provider to take the snapshot of
+         * @param previous Earlier snapshot of the same provider to share unchanged blocks with, or nullptr
+         * @param progressCallback Called with the number of bytes processed so far. May throw to cancel taking the snapshot
+         */
+        explicit Snapshot(Provider *provider, const Snapshot *previous = nullptr, const std::function<void(u64)> &progressCallback = { });
+        ~Snapshot();
+
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        /**
+         * @brief Reads data of the snapshot
+         * @param offset Offset relative to the start of the data
+         */
+        void read(u64 offset, void *buffer, size_t size) const;
+
+        [[nodiscard]] u64 getSize() const { return this->m_size; }
+        [[nodiscard]] u64 getBaseAddress() const { return this->m_baseAddress; }
+
+        /**
+         * @brief Gets the provider unchanged data is still read from, or nullptr if the snapshot holds all of its data itself
+         */
+        [[nodiscard]] Provider *getSource() const;
+
+        /**
+         * @brief Same as Provider::getRegionValidity() but relative to the start of the data
+         */
+        [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 offset) const;
+
+        /**
+         * @brief Same as Provider::getZeroRegion() but relative to the start of the data
+         */
+        [[nodiscard]] std::pair<Region, bool> getZeroRegion(u64 offset) const;
+
+        /**
+         * @brief Gets the number of bytes starting at an offset that are the same in both snapshots because they share the blocks holding them
+         */
+        [[nodiscard]] u64 getSharedSize(const Snapshot &other, u64 offset) const;
+
+        /**
+         * @brief Gets the number of bytes starting at an offset that are still read from the source provider and therefore are the same in both
+         */
+        [[nodiscard]] u64 getSourceBackedSize(u64 offset) const;
+
+        /**
+         * @brief Gets the number of bytes held in blocks by this snapshot, including blocks shared with other snapshots
+         */
+        [[nodiscard]] u64 getStoredSize() const;
+
+        /**
+         * @brief Copies the current data of all blocks overlapping a region from the source provider into the snapshots that still read them from there.
+         *   Called by providers right before they modify the region
+         * @param snapshots Snapshots of the same provider
+         * @param region Region relative to the start of the data
+         */
+        static void materialize(std::span<Snapshot * const> snapshots, const Region &region);
+
+        /**
+         * @brief Copies all data that's still read from the source provider and stops reading from it. Called by providers before they get closed
+         */
+        static void detach(std::span<Snapshot * const> snapshots);
+
+    private:
+        using Block = std::shared_ptr<const std::vector<u8>>;
+
+        void capture(Provider *provider, const Snapshot *previous, const std::function<void(u64)> &progressCallback);
+
+        /**
+         * @brief Finds the valid region containing an offset or, if there's none, the first one after it
+         */
+        [[nodiscard]] std::vector<Region>::const_iterator findValidRegion(u64 offset) const;
+
+        /**
+         * @brief Reads a block from the source provider
+         * @return The block or nullptr if it only contains zeros
+         */
+        [[nodiscard]] Block readBlock(u64 index) const;
+
+        /**
+         * @brief Looks up a block
+         * @return Iterator to the block if it's held by this snapshot, or the end iterator if it's read from the source or only contains zeros
+         */
+        [[nodiscard]] std::map<u64, Block>::const_iterator findBlock(u64 index) const;
+
+        [[nodiscard]] u64 getBlockCount() const { return (this->m_size + BlockSize - 1) / BlockSize; }
+
+        Provider *m_source = nullptr;
+        u64 m_size = 0, m_baseAddress = 0;
+
+        // Sorted regions relative to the start of the data that the provider reported as valid
+        std::vector<Region> m_validRegions;
+
+        // Blocks held by this snapshot by their index. Null blocks only contain zeros.
+        // Blocks that are missing are read from the source provider if there still is one, otherwise they only contain zeros
+        std::map<u64, Block> m_blocks;
+        mutable std::mutex m_mutex;
+    };
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <vector>
+
+namespace hex::prv {
+
+    class Provider;
+
+    /**
+     * @brief Splits a region into the parts that need to be searched, leaving out the inside of runs of bytes the provider knows to be zero
+     * @param provider Provider to query the runs of zero bytes from. See Provider::getZeroRegion()
+     * @param searchRegion Region to split up
+     * @param margin Number of bytes at the edges of each run that are still searched so matches reaching into the run are found
+     * @param alignment Alignment of the search relative to the start of the region
+     * @return Parts of the region that need to be searched, sorted by their address
+     */
+    [[nodiscard]] std::vector<Region> getSearchableRegions(const Provider *provider, Region searchRegion, u64 margin, u64 alignment);
+
+}
@@ -244,6 +244,14 @@ namespace hex {
             return s_providers;
         }
 
+        prv::Provider *getById(u32 id) {
+            auto it = std::find_if(s_providers.begin(), s_providers.end(), [id](const prv::Provider *provider) {
+                return provider->getID() == id;
+            });
+
+            return it == s_providers.end() ? nullptr : *it;
+        }
+
         void setCurrentProvider(u32 index) {
             if (TaskManager::getRunningTaskCount() > 0)
                 return;
@@ -315,6 +323,7 @@ namespace hex {
             if (s_providers.empty())
                 EventManager::post<EventProviderChanged>(provider, nullptr);
 
+            provider->detachSnapshots();
             provider->close();
             EventManager::post<EventProviderClosed>(provider);
 
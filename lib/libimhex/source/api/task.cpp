@@ -2,6 +2,7 @@
 
 #include <hex/api/localization.hpp>
 #include <hex/helpers/logger.hpp>
+#include <hex/providers/io_statistics.hpp>
 
 #include <algorithm>
 
@@ -247,6 +248,10 @@ namespace hex {
 
             try {
                 setThreadName(LangEntry(task->m_unlocalizedName));
+
+                // Reads done by the task show up under its name in the I/O statistics of the providers
+                prv::IoStatistics::CallerScope caller(task->m_unlocalizedName);
+
                 task->m_function(*task);
                 log::debug("Finished task {}", task->m_unlocalizedName);
             } catch (const Task::TaskInterruptor &) {
@@ -330,12 +335,15 @@ namespace hex {
     }
 
     void TaskManager::runDeferredCalls() {
-        std::scoped_lock lock(s_deferredCallsMutex);
+        // Run the calls without holding the lock so they can defer further calls to the next frame themselves
+        std::list<std::function<void()>> calls;
+        {
+            std::scoped_lock lock(s_deferredCallsMutex);
+            calls.swap(s_deferredCalls);
+        }
 
-        for (const auto &call : s_deferredCalls)
+        for (const auto &call : calls)
             call();
-
-        s_deferredCalls.clear();
     }
 
     void TaskManager::runWhenTasksFinished(const std::function<void()> &function) {
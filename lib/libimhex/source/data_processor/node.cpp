@@ -137,7 +137,7 @@ namespace hex::dp {
             throwNodeError("Tried setting overlay data on a node that's not the end of a chain!");
 
         this->m_overlay->setAddress(address);
-        this->m_overlay->getData() = data;
+        this->m_overlay->setData(data);
     }
 
     void Node::setIdCounter(int id) {
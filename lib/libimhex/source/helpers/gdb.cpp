@@ -0,0 +1,374 @@
+#include <hex/helpers/gdb.hpp>
+
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <wolv/utils/string.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+namespace hex::gdb {
+
+    using namespace std::chrono_literals;
+
+    namespace {
+
+        u8 calculateChecksum(std::string_view data) {
+            u8 checksum = 0;
+
+            for (const auto &c : data)
+                checksum += u8(c);
+
+            return checksum;
+        }
+
+        /**
+         * @brief Undoes the run length encoding and the escaping of special characters stubs may use in their replies
+         */
+        std::string decodePayload(std::string_view payload) {
+            // Stubs run length encode the already escaped data, so runs have to be expanded before anything gets unescaped.
+            // An asterisk is never part of the escaped data itself as it gets escaped too
+            std::string expanded;
+            expanded.reserve(payload.size());
+
+            for (size_t i = 0; i < payload.size(); i++) {
+                const char c = payload[i];
+
+                if (c == '*' && i + 1 < payload.size() && !expanded.empty()) {
+                    // The character following the asterisk holds the number of repetitions of the previous character plus 29
+                    const auto count = u8(payload[++i]);
+                    if (count > 29)
+                        expanded.append(count - 29, expanded.back());
+                } else {
+                    expanded += c;
+                }
+            }
+
+            std::string result;
+            result.reserve(expanded.size());
+
+            for (size_t i = 0; i < expanded.size(); i++) {
+                if (expanded[i] == '}' && i + 1 < expanded.size())
+                    result += char(expanded[++i] ^ 0x20);
+                else
+                    result += expanded[i];
+            }
+
+            return result;
+        }
+
+        std::optional<std::vector<u8>> decodeMemoryReply(const std::string &reply, bool binary) {
+            if (binary) {
+                // Binary replies are prefixed with a 'b' so they can be told apart from error replies
+                if (reply.empty() || reply[0] != 'b')
+                    return std::nullopt;
+
+                return std::vector<u8>(reply.begin() + 1, reply.end());
+            } else {
+                // Error replies are always three characters long while hex encoded data has an even length
+                if (reply.size() % 2 != 0)
+                    return std::nullopt;
+
+                std::vector<u8> result(reply.size() / 2);
+                for (size_t i = 0; i < result.size(); i++) {
+                    const auto high = hexCharToValue(reply[i * 2 + 0]);
+                    const auto low  = hexCharToValue(reply[i * 2 + 1]);
+                    if (!high.has_value() || !low.has_value())
+                        return std::nullopt;
+
+                    result[i] = (*high << 4) | *low;
+                }
+
+                return result;
+            }
+        }
+
+        bool isStopReply(std::string_view reply) {
+            if (reply.empty())
+                return false;
+
+            switch (reply[0]) {
+                case 'S':
+                case 'T':
+                case 'W':
+                case 'X':
+                    return true;
+                case 'O':
+                    // Console output of the target, not to be confused with an OK reply
+                    return reply != "OK";
+                default:
+                    return false;
+            }
+        }
+
+    }
+
+    bool Client::connect(const std::string &address, u16 port) {
+        this->disconnect();
+
+        this->m_receiveBuffer.clear();
+        this->m_packetSize.reset();
+        this->m_binaryUpload = false;
+        this->m_noAckMode    = false;
+
+        this->m_socket = wolv::net::SocketClient(wolv::net::SocketClient::Type::TCP);
+        this->m_socket.connect(address, port);
+        if (!this->m_socket.isConnected())
+            return false;
+
+        this->sendPacket("qSupported:binary-upload+");
+        auto features = this->receivePacket();
+        if (!features.has_value()) {
+            this->disconnect();
+            return false;
+        }
+
+        bool noAckModeSupported = false;
+        for (const auto &feature : wolv::util::splitString(*features, ";")) {
+            if (feature.starts_with("PacketSize=")) {
+                size_t packetSize = 0;
+                const auto value = std::string_view(feature).substr(11);
+                if (auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), packetSize, 16); error == std::errc() && packetSize > 0)
+                    this->m_packetSize = packetSize;
+            } else if (feature == "binary-upload+") {
+                this->m_binaryUpload = true;
+            } else if (feature == "QStartNoAckMode+") {
+                noAckModeSupported = true;
+            }
+        }
+
+        // Acknowledgements are useless over TCP and would cost an additional packet for every reply
+        if (noAckModeSupported) {
+            this->sendPacket("QStartNoAckMode");
+            if (auto reply = this->receivePacket(); reply == "OK")
+                this->m_noAckMode = true;
+        }
+
+        return this->isConnected();
+    }
+
+    void Client::disconnect() {
+        this->m_socket.disconnect();
+    }
+
+    bool Client::isConnected() const {
+        return this->m_socket.isConnected();
+    }
+
+    size_t Client::getMaxReadSize() const {
+        if (!this->m_packetSize.has_value())
+            return DefaultReadSize;
+
+        // The packet size limits the number of characters in the reply, not counting the framing and checksum
+        if (this->m_binaryUpload)
+            return std::max<size_t>(*this->m_packetSize - 1, 1);
+        else
+            return std::max<size_t>(*this->m_packetSize / 2, 1);
+    }
+
+    std::vector<u8> Client::readMemory(u64 address, size_t size) {
+        const MemoryRange range = { address, size };
+
+        return std::move(this->readMemory(std::span(&range, 1)).front());
+    }
+
+    std::vector<std::vector<u8>> Client::readMemory(std::span<const MemoryRange> ranges) {
+        struct Request {
+            size_t range;
+            u64 offset;
+            size_t size;
+        };
+
+        std::vector<std::vector<u8>> result;
+        result.reserve(ranges.size());
+        for (const auto &range : ranges)
+            result.emplace_back(range.size);
+
+        const bool binary = this->m_binaryUpload;
+        const auto maxReadSize = this->getMaxReadSize();
+
+        // Stubs may return less data than requested. The rest gets requested again
+        std::deque<Request> pendingRequests, retries;
+        size_t nextRange = 0;
+        u64 nextOffset = 0;
+        std::vector<bool> failed(ranges.size(), false);
+
+        // Requests of all ranges are sent out one after another, no more get sent for ranges that couldn't be read
+        const auto getNextRequest = [&]() -> std::optional<Request> {
+            while (!retries.empty()) {
+                const auto request = retries.front();
+                retries.pop_front();
+
+                if (!failed[request.range])
+                    return request;
+            }
+
+            while (nextRange < ranges.size()) {
+                if (failed[nextRange] || nextOffset >= ranges[nextRange].size) {
+                    nextRange += 1;
+                    nextOffset = 0;
+                    continue;
+                }
+
+                const Request request = { nextRange, nextOffset, std::min<size_t>(maxReadSize, ranges[nextRange].size - nextOffset) };
+                nextOffset += request.size;
+
+                return request;
+            }
+
+            return std::nullopt;
+        };
+
+        while (true) {
+            while (pendingRequests.size() < MaxPendingRequests) {
+                const auto request = getNextRequest();
+                if (!request.has_value())
+                    break;
+
+                this->sendPacket(hex::format("{}{:X},{:X}", binary ? 'x' : 'm', ranges[request->range].address + request->offset, request->size));
+                pendingRequests.push_back(*request);
+            }
+
+            if (pendingRequests.empty())
+                break;
+
+            const auto request = pendingRequests.front();
+            pendingRequests.pop_front();
+
+            auto reply = this->receiveMemoryReply();
+            if (!reply.has_value())
+                return std::vector<std::vector<u8>>(ranges.size());
+
+            // Replies of requests that were sent already still need to be received to keep the connection in sync
+            auto data = decodeMemoryReply(*reply, binary);
+            if (!data.has_value() || data->empty() || data->size() > request.size) {
+                failed[request.range] = true;
+                continue;
+            }
+
+            std::memcpy(result[request.range].data() + request.offset, data->data(), data->size());
+
+            if (data->size() < request.size)
+                retries.push_back({ request.range, request.offset + data->size(), request.size - data->size() });
+        }
+
+        for (size_t i = 0; i < ranges.size(); i++) {
+            if (failed[i])
+                result[i].clear();
+        }
+
+        return result;
+    }
+
+    bool Client::writeMemory(u64 address, const void *buffer, size_t size) {
+        constexpr static auto HexDigits = "0123456789ABCDEF";
+
+        // Leave enough space for the command, address and size in front of the hex encoded data
+        constexpr static size_t MaxHeaderSize = 0x40;
+        const size_t maxWriteSize = this->m_packetSize.has_value() ? std::max<size_t>(*this->m_packetSize, MaxHeaderSize * 2) / 2 - MaxHeaderSize / 2 : DefaultReadSize;
+
+        auto bytes = static_cast<const u8 *>(buffer);
+        for (u64 offset = 0; offset < size; offset += maxWriteSize) {
+            const auto writeSize = std::min<size_t>(maxWriteSize, size - offset);
+
+            std::string packet = hex::format("M{:X},{:X}:", address + offset, writeSize);
+            packet.reserve(packet.size() + writeSize * 2);
+            for (size_t i = 0; i < writeSize; i++) {
+                packet += HexDigits[bytes[offset + i] >> 4];
+                packet += HexDigits[bytes[offset + i] & 0x0F];
+            }
+
+            this->sendPacket(packet);
+            if (this->receiveMemoryReply() != "OK")
+                return false;
+        }
+
+        return true;
+    }
+
+    void Client::continueExecution() {
+        this->sendPacket("vCont;c");
+    }
+
+    void Client::sendPacket(const std::string &data) {
+        this->m_socket.writeString(hex::format("${}#{:02x}", data, calculateChecksum(data)));
+    }
+
+    std::optional<std::string> Client::receivePacket() {
+        while (true) {
+            // Acknowledgements and anything else in front of the next packet aren't needed
+            if (const auto start = this->m_receiveBuffer.find_first_of("$%"); start == std::string::npos)
+                this->m_receiveBuffer.clear();
+            else
+                this->m_receiveBuffer.erase(0, start);
+
+            // Escaping makes sure the payload never contains a '#', so the first one marks the start of the checksum
+            if (const auto end = this->m_receiveBuffer.find('#'); end != std::string::npos && end + 2 < this->m_receiveBuffer.size()) {
+                const bool notification = this->m_receiveBuffer[0] == '%';
+                const auto payload      = this->m_receiveBuffer.substr(1, end - 1);
+                const auto high         = hexCharToValue(this->m_receiveBuffer[end + 1]);
+                const auto low          = hexCharToValue(this->m_receiveBuffer[end + 2]);
+
+                this->m_receiveBuffer.erase(0, end + 3);
+
+                // Asynchronous notifications are never acknowledged and aren't a reply to anything that was sent
+                if (notification)
+                    continue;
+
+                const bool valid = high.has_value() && low.has_value() && ((*high << 4) | *low) == calculateChecksum(payload);
+                if (!this->m_noAckMode) {
+                    this->m_socket.writeString(valid ? "+" : "-");
+
+                    // The stub will send the packet again
+                    if (!valid)
+                        continue;
+                }
+
+                // Without acknowledgements the stub never sends the packet again, so every following reply would be taken as the reply to the wrong request
+                if (!valid) {
+                    this->disconnect();
+                    return std::nullopt;
+                }
+
+                return decodePayload(payload);
+            }
+
+            if (!this->receiveData())
+                return std::nullopt;
+        }
+    }
+
+    std::optional<std::string> Client::receiveMemoryReply() {
+        while (true) {
+            auto reply = this->receivePacket();
+            if (!reply.has_value() || !isStopReply(*reply))
+                return reply;
+        }
+    }
+
+    bool Client::receiveData() {
+        const auto timeout = std::chrono::steady_clock::now() + ReplyTimeout;
+
+        while (this->m_socket.isConnected()) {
+            auto data = this->m_socket.readBytes(0x1'0000);
+            if (!data.empty()) {
+                this->m_receiveBuffer.append(data.begin(), data.end());
+                return true;
+            }
+
+            if (std::chrono::steady_clock::now() > timeout)
+                break;
+
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // A reply that arrives after giving up on it would be taken as the reply to the next request
+        this->disconnect();
+        return false;
+    }
+
+}
@@ -0,0 +1,85 @@
+#include <hex/helpers/memory_arena.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace hex {
+
+    MemoryArena::MemoryArena(size_t chunkSize) : m_chunkSize(std::max<size_t>(chunkSize, 1)) { }
+
+    void *MemoryArena::allocate(size_t size, size_t alignment) {
+        const auto alignedOffset = [&](const Chunk &chunk, size_t offset) {
+            const auto address = reinterpret_cast<uintptr_t>(chunk.data.get()) + offset;
+            return offset + ((alignment - (address % alignment)) % alignment);
+        };
+
+        // Move on to the next chunk that still has enough space left, chunks that are skipped stay unused until the next reset
+        while (this->m_currChunk < this->m_chunks.size()) {
+            const auto &chunk = this->m_chunks[this->m_currChunk];
+            const auto offset = alignedOffset(chunk, this->m_currOffset);
+
+            if (offset <= chunk.size && size <= chunk.size - offset) {
+                this->m_currOffset = offset + size;
+                return chunk.data.get() + offset;
+            }
+
+            this->m_currChunk += 1;
+            this->m_currOffset = 0;
+        }
+
+        this->addChunk(std::max(this->m_chunkSize, size + alignment));
+        this->m_currChunk = this->m_chunks.size() - 1;
+
+        const auto &chunk = this->m_chunks.back();
+        const auto offset = alignedOffset(chunk, 0);
+        this->m_currOffset = offset + size;
+
+        return chunk.data.get() + offset;
+    }
+
+    void MemoryArena::reset() {
+        // Merge all chunks into one so everything fits into a single chunk the next time
+        if (this->m_chunks.size() > 1) {
+            const auto capacity = this->getCapacity();
+
+            this->m_chunks.clear();
+            this->addChunk(capacity);
+        }
+
+        this->m_currChunk  = 0;
+        this->m_currOffset = 0;
+    }
+
+    size_t MemoryArena::getUsedSize() const {
+        size_t result = this->m_currOffset;
+        for (size_t i = 0; i < std::min(this->m_currChunk, this->m_chunks.size()); i++)
+            result += this->m_chunks[i].size;
+
+        return result;
+    }
+
+    size_t MemoryArena::getCapacity() const {
+        size_t result = 0;
+        for (const auto &chunk : this->m_chunks)
+            result += chunk.size;
+
+        return result;
+    }
+
+    void MemoryArena::addChunk(size_t size) {
+        this->m_chunks.push_back({ std::make_unique_for_overwrite<std::byte[]>(size), size });
+        this->m_chunkAllocationCount += 1;
+    }
+
+
+    MemoryArena &FrameArena::get() {
+        static MemoryArena arena;
+
+        return arena;
+    }
+
+    void FrameArena::reset() {
+        get().reset();
+    }
+
+}
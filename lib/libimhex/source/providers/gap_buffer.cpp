@@ -0,0 +1,139 @@
+#include <hex/providers/gap_buffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    void GapBuffer::read(u64 offset, u8 *buffer, size_t size) const {
+        if (size == 0 || offset > this->getSize() || size > this->getSize() - offset)
+            return;
+
+        // Part in front of the gap
+        if (offset < this->m_gapStart) {
+            const auto frontSize = std::min<u64>(size, this->m_gapStart - offset);
+            std::memcpy(buffer, this->m_buffer.data() + offset, frontSize);
+
+            offset += frontSize;
+            buffer += frontSize;
+            size   -= frontSize;
+        }
+
+        // Part behind the gap
+        if (size > 0)
+            std::memcpy(buffer, this->m_buffer.data() + this->toIndex(offset), size);
+    }
+
+    void GapBuffer::write(u64 offset, const u8 *buffer, size_t size) {
+        if (size == 0 || offset > this->getSize() || size > this->getSize() - offset)
+            return;
+
+        if (offset < this->m_gapStart) {
+            const auto frontSize = std::min<u64>(size, this->m_gapStart - offset);
+            std::memcpy(this->m_buffer.data() + offset, buffer, frontSize);
+
+            offset += frontSize;
+            buffer += frontSize;
+            size   -= frontSize;
+        }
+
+        if (size > 0)
+            std::memcpy(this->m_buffer.data() + this->toIndex(offset), buffer, size);
+    }
+
+    void GapBuffer::insert(u64 offset, size_t size) {
+        if (size == 0 || offset > this->getSize())
+            return;
+
+        this->moveGap(offset);
+        if (this->getGapSize() < size)
+            this->growGap(size);
+
+        std::memset(this->m_buffer.data() + this->m_gapStart, 0x00, size);
+        this->m_gapStart += size;
+    }
+
+    void GapBuffer::remove(u64 offset, size_t size) {
+        if (size == 0 || offset >= this->getSize())
+            return;
+
+        size = std::min<u64>(size, this->getSize() - offset);
+
+        this->moveGap(offset);
+        this->m_gapEnd += size;
+
+        this->shrinkGap();
+    }
+
+    void GapBuffer::resize(u64 size) {
+        const auto oldSize = this->getSize();
+
+        if (size > oldSize)
+            this->insert(oldSize, size - oldSize);
+        else if (size < oldSize)
+            this->remove(size, oldSize - size);
+    }
+
+    std::optional<std::span<const u8>> GapBuffer::getSpan(u64 offset, size_t size) const {
+        if (size == 0 || offset > this->getSize() || size > this->getSize() - offset)
+            return std::nullopt;
+
+        if (offset < this->m_gapStart && offset + size > this->m_gapStart)
+            return std::nullopt;
+
+        return std::span<const u8>(this->m_buffer).subspan(this->toIndex(offset), size);
+    }
+
+    std::vector<u8> GapBuffer::toVector() const {
+        std::vector<u8> result;
+        result.reserve(this->getSize());
+
+        result.insert(result.end(), this->m_buffer.begin(), this->m_buffer.begin() + this->m_gapStart);
+        result.insert(result.end(), this->m_buffer.begin() + this->m_gapEnd, this->m_buffer.end());
+
+        return result;
+    }
+
+    void GapBuffer::moveGap(u64 offset) {
+        if (offset < this->m_gapStart) {
+            // Move the bytes between the new and the old gap position to the back of the gap
+            const auto moveSize = this->m_gapStart - offset;
+            std::memmove(this->m_buffer.data() + this->m_gapEnd - moveSize, this->m_buffer.data() + offset, moveSize);
+
+            this->m_gapStart -= moveSize;
+            this->m_gapEnd   -= moveSize;
+        } else if (offset > this->m_gapStart) {
+            // Move the bytes between the old and the new gap position to the front of the gap
+            const auto moveSize = offset - this->m_gapStart;
+            std::memmove(this->m_buffer.data() + this->m_gapStart, this->m_buffer.data() + this->m_gapEnd, moveSize);
+
+            this->m_gapStart += moveSize;
+            this->m_gapEnd   += moveSize;
+        }
+    }
+
+    void GapBuffer::growGap(size_t size) {
+        // Grow proportionally to the data so repeated insertions only need to copy everything a few times
+        const auto newGapSize = std::max<u64>({ size, this->getSize() / 16, MinGapSize });
+        const auto backSize   = this->m_buffer.size() - this->m_gapEnd;
+
+        std::vector<u8> newBuffer(this->getSize() + newGapSize);
+        std::copy_n(this->m_buffer.begin(), this->m_gapStart, newBuffer.begin());
+        std::copy_n(this->m_buffer.begin() + this->m_gapEnd, backSize, newBuffer.end() - backSize);
+
+        this->m_buffer = std::move(newBuffer);
+        this->m_gapEnd = this->m_gapStart + newGapSize;
+    }
+
+    void GapBuffer::shrinkGap() {
+        // Give memory back after large removals. Small gaps are kept around for the next insertion
+        if (this->getGapSize() <= std::max<u64>(this->getSize(), MinGapSize * 0x100))
+            return;
+
+        this->moveGap(this->getSize());
+        this->m_buffer.resize(this->m_gapStart);
+        this->m_buffer.shrink_to_fit();
+        this->m_gapEnd = this->m_gapStart;
+    }
+
+}
@@ -0,0 +1,236 @@
+#include <hex/providers/io_ring.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <vector>
+
+#if defined(OS_LINUX)
+    #include <atomic>
+    #include <cstring>
+
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace hex::prv {
+
+#if defined(OS_LINUX)
+
+    struct IoRing::Ring {
+        struct Chunk {
+            u64 offset;
+            u8 *buffer;
+            size_t size;
+        };
+
+        int fd = -1;
+
+        void *submissionRing = nullptr, *completionRing = nullptr, *submissionEntries = nullptr;
+        size_t submissionRingSize = 0, completionRingSize = 0, submissionEntriesSize = 0;
+
+        u32 *submissionTail = nullptr, *submissionMask = nullptr, *submissionArray = nullptr;
+        u32 *completionHead = nullptr, *completionTail = nullptr, *completionMask = nullptr;
+        io_uring_cqe *completionEntries = nullptr;
+
+        ~Ring() {
+            if (this->submissionEntries != nullptr)
+                ::munmap(this->submissionEntries, this->submissionEntriesSize);
+            if (this->completionRing != nullptr && this->completionRing != this->submissionRing)
+                ::munmap(this->completionRing, this->completionRingSize);
+            if (this->submissionRing != nullptr)
+                ::munmap(this->submissionRing, this->submissionRingSize);
+
+            if (this->fd != -1)
+                ::close(this->fd);
+        }
+
+        template<typename T>
+        static T *getPointer(void *ring, u32 offset) {
+            return reinterpret_cast<T *>(static_cast<u8 *>(ring) + offset);
+        }
+
+        bool setup(u32 entries, u32 &queueDepth) {
+            io_uring_params params = { };
+
+            this->fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (this->fd < 0) {
+                this->fd = -1;
+                return false;
+            }
+
+            // IORING_OP_READ was added in the same kernel version as this feature flag
+            if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+                return false;
+
+            const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+            this->submissionRingSize    = params.sq_off.array + params.sq_entries * sizeof(u32);
+            this->completionRingSize    = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            this->submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+            // Newer kernels map both rings with a single mapping
+            if (singleMapping)
+                this->submissionRingSize = this->completionRingSize = std::max(this->submissionRingSize, this->completionRingSize);
+
+            const auto map = [this](size_t size, off_t offset) -> void * {
+                auto result = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, offset);
+                return result == MAP_FAILED ? nullptr : result;
+            };
+
+            this->submissionRing    = map(this->submissionRingSize, IORING_OFF_SQ_RING);
+            this->completionRing    = singleMapping ? this->submissionRing : map(this->completionRingSize, IORING_OFF_CQ_RING);
+            this->submissionEntries = map(this->submissionEntriesSize, IORING_OFF_SQES);
+
+            if (this->submissionRing == nullptr || this->completionRing == nullptr || this->submissionEntries == nullptr)
+                return false;
+
+            this->submissionTail    = getPointer<u32>(this->submissionRing, params.sq_off.tail);
+            this->submissionMask    = getPointer<u32>(this->submissionRing, params.sq_off.ring_mask);
+            this->submissionArray   = getPointer<u32>(this->submissionRing, params.sq_off.array);
+            this->completionHead    = getPointer<u32>(this->completionRing, params.cq_off.head);
+            this->completionTail    = getPointer<u32>(this->completionRing, params.cq_off.tail);
+            this->completionMask    = getPointer<u32>(this->completionRing, params.cq_off.ring_mask);
+            this->completionEntries = getPointer<io_uring_cqe>(this->completionRing, params.cq_off.cqes);
+
+            // Never have more reads in flight than the submission queue can hold
+            queueDepth = std::min(queueDepth, params.sq_entries);
+
+            return true;
+        }
+
+        void queueRead(int fileFd, const Chunk &chunk, u64 userData) {
+            // Only this thread ever writes the tail, so it can be read without any synchronization
+            const u32 tail  = *this->submissionTail;
+            const u32 index = tail & *this->submissionMask;
+
+            auto &entry = static_cast<io_uring_sqe *>(this->submissionEntries)[index];
+            std::memset(&entry, 0x00, sizeof(entry));
+            entry.opcode    = IORING_OP_READ;
+            entry.fd        = fileFd;
+            entry.off       = chunk.offset;
+            entry.addr      = reinterpret_cast<u64>(chunk.buffer);
+            entry.len       = static_cast<u32>(chunk.size);
+            entry.user_data = userData;
+
+            this->submissionArray[index] = index;
+            std::atomic_ref(*this->submissionTail).store(tail + 1, std::memory_order::release);
+        }
+
+        int submitAndWait(u32 submitCount) const {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, this->fd, submitCount, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        }
+
+        template<typename F>
+        void reapCompletions(F &&callback) {
+            u32 head = *this->completionHead;
+            const u32 tail = std::atomic_ref(*this->completionTail).load(std::memory_order::acquire);
+
+            for (; head != tail; head++)
+                callback(this->completionEntries[head & *this->completionMask]);
+
+            std::atomic_ref(*this->completionHead).store(head, std::memory_order::release);
+        }
+    };
+
+    IoRing::IoRing(u32 queueDepth) : m_queueDepth(std::max<u32>(queueDepth, 1)) {
+        auto ring = std::make_unique<Ring>();
+        if (ring->setup(this->m_queueDepth, this->m_queueDepth))
+            this->m_ring = std::move(ring);
+    }
+
+    bool IoRing::read(int fd, std::span<const ReadRequest> requests, size_t chunkSize) {
+        if (fd < 0)
+            return false;
+
+        std::scoped_lock lock(this->m_mutex);
+        if (this->m_ring == nullptr)
+            return false;
+
+        // A single read can't be larger than what fits into the length field of a submission
+        chunkSize = std::clamp<size_t>(chunkSize, 1, 0x4000'0000);
+
+        std::vector<Ring::Chunk> chunks;
+        for (const auto &request : requests) {
+            for (u64 chunkOffset = 0; chunkOffset < request.size; chunkOffset += chunkSize)
+                chunks.push_back({ request.offset + chunkOffset, static_cast<u8 *>(request.buffer) + chunkOffset, std::min<size_t>(chunkSize, request.size - chunkOffset) });
+        }
+
+        // Chunks that were only partially read get queued up again with the remaining part
+        std::deque<size_t> retries;
+        size_t nextChunk = 0;
+
+        u32 inFlight = 0, unsubmitted = 0;
+        bool failed = false;
+
+        while (true) {
+            while (!failed && inFlight < this->m_queueDepth && (!retries.empty() || nextChunk < chunks.size())) {
+                size_t chunkIndex;
+                if (!retries.empty()) {
+                    chunkIndex = retries.front();
+                    retries.pop_front();
+                } else {
+                    chunkIndex = nextChunk++;
+                }
+
+                this->m_ring->queueRead(fd, chunks[chunkIndex], chunkIndex);
+                inFlight += 1;
+                unsubmitted += 1;
+            }
+
+            if (inFlight == 0)
+                break;
+
+            if (const auto submitted = this->m_ring->submitAndWait(unsubmitted); submitted >= 0) {
+                unsubmitted -= std::min<u32>(submitted, unsubmitted);
+            } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY && inFlight == unsubmitted) {
+                // The ring stopped working. Only drop it while the kernel doesn't hold on to any of the buffers
+                this->m_ring.reset();
+                return false;
+            }
+
+            this->m_ring->reapCompletions([&](const io_uring_cqe &entry) {
+                auto &chunk = chunks[entry.user_data];
+                inFlight -= 1;
+
+                if (entry.res == -EINTR || entry.res == -EAGAIN) {
+                    retries.push_back(entry.user_data);
+                } else if (entry.res <= 0) {
+                    // Either a read error or the end of the file was reached. Let the remaining reads finish and stop there
+                    failed = true;
+                } else if (size_t(entry.res) < chunk.size) {
+                    chunk.offset += entry.res;
+                    chunk.buffer += entry.res;
+                    chunk.size   -= entry.res;
+                    retries.push_back(entry.user_data);
+                }
+            });
+        }
+
+        return !failed;
+    }
+
+#else
+
+    struct IoRing::Ring { };
+
+    IoRing::IoRing(u32 queueDepth) : m_queueDepth(std::max<u32>(queueDepth, 1)) {
+    }
+
+    bool IoRing::read(int, std::span<const ReadRequest>, size_t) {
+        return false;
+    }
+
+#endif
+
+    bool IoRing::read(int fd, u64 offset, void *buffer, size_t size, size_t chunkSize) {
+        const ReadRequest request = { offset, buffer, size };
+
+        return this->read(fd, std::span(&request, 1), chunkSize);
+    }
+
+    IoRing::~IoRing() = default;
+
+}
@@ -0,0 +1,126 @@
+#include <hex/providers/io_statistics.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+namespace hex::prv {
+
+    namespace {
+
+        std::atomic<bool> s_enabled = false, s_tracingEnabled = false;
+
+        thread_local std::string_view s_caller;
+        thread_local IoStatistics::ReadScope *s_currentRead = nullptr;
+
+    }
+
+    IoStatistics::ReadScope::ReadScope(Provider *provider, u64 offset, size_t size) {
+        if (!s_enabled.load(std::memory_order_relaxed)) [[likely]]
+            return;
+
+        auto &statistics = provider->getIoStatistics();
+
+        // Reads done by the provider itself as part of a read that's already being measured, e.g. the chunks of a merged readv
+        if (s_currentRead != nullptr && s_currentRead->m_statistics == &statistics)
+            return;
+
+        this->m_statistics = &statistics;
+        this->m_parent     = s_currentRead;
+        this->m_offset     = offset;
+        this->m_size       = size;
+        this->m_start      = std::chrono::steady_clock::now();
+
+        s_currentRead = this;
+    }
+
+    IoStatistics::ReadScope::~ReadScope() {
+        if (this->m_statistics == nullptr)
+            return;
+
+        s_currentRead = this->m_parent;
+
+        this->m_statistics->record(*this, std::chrono::steady_clock::now() - this->m_start);
+    }
+
+    IoStatistics::CallerScope::CallerScope(std::string_view caller) : m_previousCaller(s_caller) {
+        s_caller = caller;
+    }
+
+    IoStatistics::CallerScope::~CallerScope() {
+        s_caller = this->m_previousCaller;
+    }
+
+    void IoStatistics::setEnabled(bool enabled) {
+        s_enabled = enabled;
+    }
+
+    bool IoStatistics::isEnabled() {
+        return s_enabled;
+    }
+
+    void IoStatistics::setTracingEnabled(bool enabled) {
+        s_tracingEnabled = enabled;
+    }
+
+    bool IoStatistics::isTracingEnabled() {
+        return s_tracingEnabled;
+    }
+
+    void IoStatistics::recordCacheAccess(bool hit) {
+        if (s_currentRead == nullptr)
+            return;
+
+        if (hit)
+            s_currentRead->m_cacheHits += 1;
+        else
+            s_currentRead->m_cacheMisses += 1;
+    }
+
+    std::map<std::string, IoStatistics::CallerStatistics> IoStatistics::getCallerStatistics() const {
+        std::scoped_lock lock(this->m_mutex);
+
+        return { this->m_callers.begin(), this->m_callers.end() };
+    }
+
+    std::vector<IoStatistics::TraceEntry> IoStatistics::getTrace() const {
+        std::scoped_lock lock(this->m_mutex);
+
+        return { this->m_trace.begin(), this->m_trace.end() };
+    }
+
+    void IoStatistics::reset() {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->m_callers.clear();
+        this->m_trace.clear();
+    }
+
+    void IoStatistics::record(const ReadScope &scope, std::chrono::nanoseconds duration) {
+        const auto microseconds = u64(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+        const auto bucket       = std::min<size_t>(std::bit_width(microseconds), LatencyBucketCount - 1);
+
+        std::scoped_lock lock(this->m_mutex);
+
+        auto callerStatistics = this->m_callers.find(s_caller);
+        if (callerStatistics == this->m_callers.end())
+            callerStatistics = this->m_callers.emplace(std::string(s_caller), CallerStatistics { }).first;
+
+        auto &statistics = callerStatistics->second;
+        statistics.calls         += 1;
+        statistics.bytes         += scope.m_size;
+        statistics.cacheHits     += scope.m_cacheHits;
+        statistics.cacheMisses   += scope.m_cacheMisses;
+        statistics.totalDuration += duration;
+        statistics.latencyHistogram[bucket] += 1;
+
+        if (s_tracingEnabled) {
+            if (this->m_trace.size() >= MaxTraceSize)
+                this->m_trace.pop_front();
+
+            this->m_trace.push_back({ std::chrono::system_clock::now(), scope.m_offset, scope.m_size, duration, std::string(s_caller) });
+        }
+    }
+
+}
@@ -0,0 +1,209 @@
+#include <hex/providers/overlay.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace hex::prv {
+
+    Overlay::~Overlay() {
+        if (this->m_index != nullptr)
+            this->m_index->remove(this);
+    }
+
+    void Overlay::setAddress(u64 address) {
+        this->m_address = address;
+
+        if (this->m_index != nullptr)
+            this->m_index->update(this);
+    }
+
+    void Overlay::resize(size_t size) {
+        const auto chunkCount = (size + ChunkSize - 1) / ChunkSize;
+
+        this->m_chunks.resize(chunkCount);
+        for (size_t i = 0; i < chunkCount; i++)
+            this->m_chunks[i].resize(std::min<size_t>(ChunkSize, size - i * ChunkSize));
+
+        this->m_size = size;
+
+        if (this->m_index != nullptr)
+            this->m_index->update(this);
+    }
+
+    void Overlay::setData(const std::vector<u8> &data) {
+        this->setData(data.data(), data.size());
+    }
+
+    void Overlay::setData(const void *buffer, size_t size) {
+        this->resize(size);
+        this->write(0, buffer, size);
+    }
+
+    void Overlay::write(u64 offset, const void *buffer, size_t size) {
+        if (offset >= this->m_size)
+            return;
+
+        size = std::min<size_t>(size, this->m_size - offset);
+
+        auto bytes = static_cast<const u8 *>(buffer);
+        while (size > 0) {
+            auto &chunk = this->m_chunks[offset / ChunkSize];
+            const auto chunkOffset = offset % ChunkSize;
+            const auto copySize    = std::min<size_t>(size, chunk.size() - chunkOffset);
+
+            std::memcpy(chunk.data() + chunkOffset, bytes, copySize);
+
+            bytes  += copySize;
+            offset += copySize;
+            size   -= copySize;
+        }
+    }
+
+    void Overlay::read(u64 offset, void *buffer, size_t size) const {
+        if (offset >= this->m_size)
+            return;
+
+        size = std::min<size_t>(size, this->m_size - offset);
+
+        auto bytes = static_cast<u8 *>(buffer);
+        while (size > 0) {
+            const auto &chunk = this->m_chunks[offset / ChunkSize];
+            const auto chunkOffset = offset % ChunkSize;
+            const auto copySize    = std::min<size_t>(size, chunk.size() - chunkOffset);
+
+            std::memcpy(bytes, chunk.data() + chunkOffset, copySize);
+
+            bytes  += copySize;
+            offset += copySize;
+            size   -= copySize;
+        }
+    }
+
+
+    OverlayIndex::~OverlayIndex() {
+        for (auto &[overlay, entry] : this->m_entries)
+            overlay->m_index = nullptr;
+    }
+
+    size_t OverlayIndex::getSizeClass(u64 size) {
+        // Overlays in size class N are at most 2^N bytes large
+        return std::bit_width(size - 1);
+    }
+
+    void OverlayIndex::addToSizeClass(Overlay *overlay, const Entry &entry) {
+        if (entry.size == 0)
+            return;
+
+        this->m_sizeClasses[getSizeClass(entry.size)].emplace(Key { entry.address, entry.sequence }, overlay);
+    }
+
+    void OverlayIndex::removeFromSizeClass(const Entry &entry) {
+        if (entry.size == 0)
+            return;
+
+        this->m_sizeClasses[getSizeClass(entry.size)].erase(Key { entry.address, entry.sequence });
+    }
+
+    void OverlayIndex::insert(Overlay *overlay) {
+        Entry entry = { this->m_sequence++, overlay->getAddress(), overlay->getSize() };
+
+        this->m_entries[overlay] = entry;
+        this->addToSizeClass(overlay, entry);
+
+        overlay->m_index = this;
+    }
+
+    void OverlayIndex::remove(Overlay *overlay) {
+        auto it = this->m_entries.find(overlay);
+        if (it == this->m_entries.end())
+            return;
+
+        this->removeFromSizeClass(it->second);
+        this->m_entries.erase(it);
+
+        overlay->m_index = nullptr;
+    }
+
+    void OverlayIndex::update(Overlay *overlay) {
+        auto it = this->m_entries.find(overlay);
+        if (it == this->m_entries.end())
+            return;
+
+        auto &entry = it->second;
+        this->removeFromSizeClass(entry);
+
+        entry.address = overlay->getAddress();
+        entry.size    = overlay->getSize();
+        this->addToSizeClass(overlay, entry);
+    }
+
+    template<typename F>
+    bool OverlayIndex::visitOverlapping(const Region &region, F &&callback) const {
+        if (region.getSize() == 0)
+            return true;
+
+        for (size_t sizeClass = 0; sizeClass < SizeClassCount; sizeClass++) {
+            const auto &overlays = this->m_sizeClasses[sizeClass];
+            if (overlays.empty())
+                continue;
+
+            // Overlays in this class can't start further than their maximum size in front of the region and still overlap it
+            const u64 maxSize     = sizeClass >= 64 ? std::numeric_limits<u64>::max() : (u64(1) << sizeClass);
+            const u64 lookBack    = maxSize - 1;
+            const u64 searchStart = region.getStartAddress() > lookBack ? region.getStartAddress() - lookBack : 0;
+
+            for (auto it = overlays.lower_bound({ searchStart, 0 }); it != overlays.end() && it->first.first <= region.getEndAddress(); ++it) {
+                const auto overlay = it->second;
+                if (overlay->getAddress() + (overlay->getSize() - 1) >= region.getStartAddress()) {
+                    if (!callback(it->first.second, overlay))
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<Overlay *> OverlayIndex::findOverlapping(const Region &region) const {
+        std::vector<std::pair<u64, Overlay *>> result;
+
+        this->visitOverlapping(region, [&](u64 sequence, Overlay *overlay) {
+            result.emplace_back(sequence, overlay);
+            return true;
+        });
+
+        // Restore the order in which the overlays were added
+        std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+        std::vector<Overlay *> overlays;
+        overlays.reserve(result.size());
+        for (const auto &[sequence, overlay] : result)
+            overlays.push_back(overlay);
+
+        return overlays;
+    }
+
+    bool OverlayIndex::overlaps(const Region &region) const {
+        return !this->visitOverlapping(region, [](u64, Overlay *) {
+            return false;
+        });
+    }
+
+    std::optional<u64> OverlayIndex::findNextStart(u64 address) const {
+        std::optional<u64> result;
+
+        for (const auto &overlays : this->m_sizeClasses) {
+            auto it = overlays.upper_bound({ address, std::numeric_limits<u64>::max() });
+            if (it == overlays.end())
+                continue;
+
+            if (!result.has_value() || it->first.first < *result)
+                result = it->first.first;
+        }
+
+        return result;
+    }
+
+}
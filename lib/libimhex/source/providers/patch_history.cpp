@@ -0,0 +1,174 @@
+#include <hex/providers/patch_history.hpp>
+
+#include <hex/helpers/literals.hpp>
+
+#include <atomic>
+#include <limits>
+
+namespace hex::prv {
+
+    using namespace hex::literals;
+
+    namespace {
+
+        constexpr static auto EndOfAddressSpace = std::numeric_limits<u64>::max();
+
+        std::atomic<size_t> s_memoryLimit = 512_MiB;
+
+        size_t estimateMemoryUsage(const PatchStore &patches) {
+            // Rough estimate of the size of a map node containing a vector
+            constexpr static size_t ExtentOverhead = sizeof(u64) + sizeof(std::vector<u8>) + 4 * sizeof(void*);
+
+            return patches.getStoredSize() + patches.getExtents().size() * ExtentOverhead;
+        }
+
+    }
+
+    PatchStore &PatchHistory::change(u64 address, size_t size) {
+        // Changes made before the first undo point are part of the initial state and can't be undone
+        if (this->m_appliedUndoPoints == 0)
+            return this->m_patches;
+
+        auto &undoPoint = this->m_undoPoints[this->m_appliedUndoPoints - 1];
+
+        // If the previous change in this undo point already covers this range, the original state of it is already known
+        if (!undoPoint.changes.empty()) {
+            const auto &lastChange = undoPoint.changes.back();
+            if (lastChange.address <= address && u128(address - lastChange.address) + size <= lastChange.size)
+                return this->m_patches;
+        }
+
+        auto &newChange = undoPoint.changes.emplace_back(address, size, this->m_patches.copyRange(address, size), PatchStore());
+
+        const auto memoryUsage = sizeof(Change) + estimateMemoryUsage(newChange.before);
+        undoPoint.memoryUsage += memoryUsage;
+        this->m_memoryUsage   += memoryUsage;
+
+        return this->m_patches;
+    }
+
+    void PatchHistory::shift(u64 address, i64 amount) {
+        // Shifting patches backwards overwrites the ones in front of the shifted range
+        const u64 start = amount >= 0 ? address : (address > u64(-amount) ? address - u64(-amount) : 0);
+
+        this->change(start, EndOfAddressSpace - start).shift(address, amount);
+    }
+
+    void PatchHistory::replace(PatchStore patches) {
+        this->change(0, EndOfAddressSpace) = std::move(patches);
+    }
+
+    void PatchHistory::createUndoPoint() {
+        // Discard everything that could've been redone
+        while (this->m_undoPoints.size() > this->m_appliedUndoPoints) {
+            this->m_memoryUsage -= this->m_undoPoints.back().memoryUsage;
+            this->m_undoPoints.pop_back();
+        }
+
+        this->enforceMemoryLimit();
+
+        this->m_undoPoints.emplace_back();
+        this->m_appliedUndoPoints = this->m_undoPoints.size();
+    }
+
+    void PatchHistory::enforceMemoryLimit() {
+        // Drop the oldest undo points until the history fits into the memory limit again.
+        // Their changes simply become part of the initial state
+        while (this->m_memoryUsage > s_memoryLimit && !this->m_undoPoints.empty() && this->m_appliedUndoPoints > 0) {
+            this->m_memoryUsage -= this->m_undoPoints.front().memoryUsage;
+            this->m_undoPoints.pop_front();
+            this->m_appliedUndoPoints -= 1;
+        }
+    }
+
+    void PatchHistory::undo() {
+        if (!this->canUndo())
+            return;
+
+        this->m_appliedUndoPoints -= 1;
+        auto &undoPoint = this->m_undoPoints[this->m_appliedUndoPoints];
+
+        for (auto it = undoPoint.changes.rbegin(); it != undoPoint.changes.rend(); ++it) {
+            it->after = this->m_patches.copyRange(it->address, it->size);
+            this->m_patches.replaceRange(it->address, it->size, it->before);
+
+            const auto memoryUsage = estimateMemoryUsage(it->after);
+            undoPoint.memoryUsage += memoryUsage;
+            this->m_memoryUsage   += memoryUsage;
+        }
+    }
+
+    void PatchHistory::redo() {
+        if (!this->canRedo())
+            return;
+
+        auto &undoPoint = this->m_undoPoints[this->m_appliedUndoPoints];
+        this->m_appliedUndoPoints += 1;
+
+        for (auto &change : undoPoint.changes) {
+            this->m_patches.replaceRange(change.address, change.size, change.after);
+
+            const auto memoryUsage = estimateMemoryUsage(change.after);
+            undoPoint.memoryUsage -= memoryUsage;
+            this->m_memoryUsage   -= memoryUsage;
+
+            change.after.clear();
+        }
+    }
+
+    std::vector<Region> PatchHistory::getUndoRegions() const {
+        if (!this->canUndo())
+            return { };
+
+        return this->getChangedRegions(this->m_undoPoints[this->m_appliedUndoPoints - 1], &Change::before);
+    }
+
+    std::vector<Region> PatchHistory::getRedoRegions() const {
+        if (!this->canRedo())
+            return { };
+
+        return this->getChangedRegions(this->m_undoPoints[this->m_appliedUndoPoints], &Change::after);
+    }
+
+    std::vector<Region> PatchHistory::getChangedRegions(const UndoPoint &undoPoint, PatchStore Change::*state) const {
+        std::vector<Region> result;
+
+        // Only bytes that are patched either now or afterwards can change, even if the change itself spans a much larger range
+        const auto addRegions = [&result](const PatchStore &patches, const Region &range) {
+            for (auto region = patches.findNext(range.getStartAddress()); region.has_value() && region->getStartAddress() <= range.getEndAddress(); region = patches.findNext(region->getEndAddress() + 1)) {
+                const u64 start = std::max(region->getStartAddress(), range.getStartAddress());
+                const u64 end   = std::min(region->getEndAddress(), range.getEndAddress());
+                result.push_back({ start, (end - start) + 1 });
+
+                if (region->getEndAddress() >= range.getEndAddress())
+                    break;
+            }
+        };
+
+        for (const auto &change : undoPoint.changes) {
+            const Region range = { change.address, change.size };
+
+            addRegions(this->m_patches, range);
+            addRegions(change.*state, range);
+        }
+
+        return result;
+    }
+
+    bool PatchHistory::canUndo() const {
+        return this->m_appliedUndoPoints > 0;
+    }
+
+    bool PatchHistory::canRedo() const {
+        return this->m_appliedUndoPoints < this->m_undoPoints.size();
+    }
+
+    void PatchHistory::setMemoryLimit(size_t limit) {
+        s_memoryLimit = limit;
+    }
+
+    size_t PatchHistory::getMemoryLimit() {
+        return s_memoryLimit;
+    }
+
+}
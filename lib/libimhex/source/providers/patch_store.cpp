@@ -0,0 +1,398 @@
+#include <hex/providers/patch_store.hpp>
+
+#include <cstring>
+
+#include <nlohmann/json.hpp>
+
+namespace hex::prv {
+
+    namespace {
+
+        // Parts of pattern runs that are smaller than this are stored as regular runs instead
+        constexpr static size_t MinPatternExtentSize = 0x1000;
+
+    }
+
+    void PatchStore::Extent::copyTo(u64 offset, u8 *buffer, size_t size) const {
+        if (size == 0)
+            return;
+
+        if (!this->isPattern()) {
+            std::memcpy(buffer, this->m_data.data() + offset, size);
+            return;
+        }
+
+        const auto patternSize = this->m_data.size();
+
+        // Copy up to the end of the current repetition of the pattern
+        const auto phase    = offset % patternSize;
+        const auto headSize = std::min<size_t>(size, patternSize - phase);
+        std::memcpy(buffer, this->m_data.data() + phase, headSize);
+
+        if (headSize == size)
+            return;
+
+        // Place one full copy of the pattern and then keep doubling the already filled part
+        auto body = buffer + headSize;
+        const auto bodySize = size - headSize;
+
+        auto filled = std::min(bodySize, patternSize);
+        std::memcpy(body, this->m_data.data(), filled);
+
+        while (filled < bodySize) {
+            const auto copySize = std::min(filled, bodySize - filled);
+            std::memcpy(body + filled, body, copySize);
+            filled += copySize;
+        }
+    }
+
+    PatchStore::Extent PatchStore::Extent::slice(u64 offset, size_t size) const {
+        if (!this->isPattern())
+            return Extent(std::vector<u8>(this->m_data.begin() + offset, this->m_data.begin() + offset + size));
+
+        const auto patternSize = this->m_data.size();
+        if (size <= std::max(patternSize, MinPatternExtentSize)) {
+            std::vector<u8> data(size);
+            this->copyTo(offset, data.data(), data.size());
+
+            return Extent(std::move(data));
+        }
+
+        // Rotate the pattern so it starts at the beginning of the slice
+        std::vector<u8> pattern(patternSize);
+        this->copyTo(offset, pattern.data(), pattern.size());
+
+        return Extent(std::move(pattern), size);
+    }
+
+    bool PatchStore::Extent::isContinuedBy(const Extent &other) const {
+        if (!this->isPattern() || !other.isPattern() || this->m_data.size() != other.m_data.size())
+            return false;
+
+        const auto patternSize = this->m_data.size();
+        for (size_t i = 0; i < patternSize; i++) {
+            if (other.m_data[i] != this->m_data[(this->m_size + i) % patternSize])
+                return false;
+        }
+
+        return true;
+    }
+
+
+    PatchStore::Extents::const_iterator PatchStore::findFirstOverlapping(u64 address) const {
+        auto it = this->m_extents.upper_bound(address);
+        if (it != this->m_extents.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second.size() > address)
+                return prev;
+        }
+
+        return it;
+    }
+
+    void PatchStore::splitAt(u64 address) {
+        auto it = this->m_extents.upper_bound(address);
+        if (it == this->m_extents.begin())
+            return;
+
+        --it;
+
+        auto &[extentAddress, extent] = *it;
+        if (extentAddress >= address || extentAddress + extent.size() <= address)
+            return;
+
+        const auto splitOffset = address - extentAddress;
+
+        Extent tail;
+        if (extent.isPattern()) {
+            tail   = extent.slice(splitOffset, extent.size() - splitOffset);
+            extent = extent.slice(0, splitOffset);
+        } else {
+            tail = Extent(std::vector<u8>(extent.m_data.begin() + splitOffset, extent.m_data.end()));
+            extent.m_data.resize(splitOffset);
+            extent.m_size = splitOffset;
+        }
+
+        this->m_extents.emplace_hint(std::next(it), address, std::move(tail));
+    }
+
+    void PatchStore::set(u64 address, const void *buffer, size_t size) {
+        if (size == 0)
+            return;
+
+        const auto bytes = static_cast<const u8 *>(buffer);
+
+        // Fast path for modifications of bytes that are already part of a single run
+        if (auto it = this->m_extents.upper_bound(address); it != this->m_extents.begin()) {
+            auto &[extentAddress, extent] = *std::prev(it);
+            if (!extent.isPattern() && extentAddress <= address && (address + size) <= (extentAddress + extent.size())) {
+                std::memcpy(extent.m_data.data() + (address - extentAddress), bytes, size);
+                return;
+            }
+        }
+
+        this->erase(address, size);
+        this->m_size += size;
+
+        // Append to the previous run if it ends right where the new one starts
+        auto next = this->m_extents.lower_bound(address);
+        auto target = this->m_extents.end();
+        if (next != this->m_extents.begin()) {
+            auto prev = std::prev(next);
+            if (!prev->second.isPattern() && prev->first + prev->second.size() == address) {
+                prev->second.m_data.insert(prev->second.m_data.end(), bytes, bytes + size);
+                prev->second.m_size += size;
+                target = prev;
+            }
+        }
+
+        if (target == this->m_extents.end())
+            target = this->m_extents.emplace_hint(next, address, Extent(std::vector<u8>(bytes, bytes + size)));
+
+        // Merge the following run into this one if they're now adjacent
+        if (next != this->m_extents.end() && !next->second.isPattern() && next->first == address + size) {
+            target->second.m_data.insert(target->second.m_data.end(), next->second.m_data.begin(), next->second.m_data.end());
+            target->second.m_size += next->second.size();
+            this->m_extents.erase(next);
+        }
+    }
+
+    void PatchStore::setPattern(u64 address, const void *pattern, size_t patternSize, size_t size) {
+        if (size == 0 || patternSize == 0)
+            return;
+
+        const auto bytes = static_cast<const u8 *>(pattern);
+        Extent extent(std::vector<u8>(bytes, bytes + patternSize), size);
+
+        // Short fills aren't worth keeping as a pattern
+        if (size <= std::max(patternSize, MinPatternExtentSize)) {
+            auto data = extent.slice(0, size);
+            this->set(address, data.getData().data(), data.size());
+            return;
+        }
+
+        this->erase(address, size);
+        this->m_size += size;
+
+        auto next = this->m_extents.lower_bound(address);
+
+        // Extend the previous run if it's the same pattern continuing right where the new one starts
+        if (next != this->m_extents.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second.size() == address && prev->second.isContinuedBy(extent)) {
+                extent.m_data = prev->second.m_data;
+                extent.m_size += prev->second.size();
+                address = prev->first;
+
+                this->m_extents.erase(prev);
+            }
+        }
+
+        if (next != this->m_extents.end() && next->first == address + extent.size() && extent.isContinuedBy(next->second)) {
+            extent.m_size += next->second.size();
+            next = this->m_extents.erase(next);
+        }
+
+        this->m_extents.emplace_hint(next, address, std::move(extent));
+    }
+
+    void PatchStore::insert(u64 address, const Extent &extent) {
+        if (extent.isPattern())
+            this->setPattern(address, extent.m_data.data(), extent.m_data.size(), extent.size());
+        else
+            this->set(address, extent.m_data.data(), extent.size());
+    }
+
+    void PatchStore::erase(u64 address, size_t size) {
+        if (size == 0 || this->m_extents.empty())
+            return;
+
+        const u64 endAddress = address + size;
+
+        this->splitAt(address);
+        this->splitAt(endAddress);
+
+        auto it = this->m_extents.lower_bound(address);
+        while (it != this->m_extents.end() && it->first < endAddress) {
+            this->m_size -= it->second.size();
+            it = this->m_extents.erase(it);
+        }
+    }
+
+    void PatchStore::shift(u64 address, i64 amount) {
+        if (amount == 0 || this->m_extents.empty())
+            return;
+
+        this->splitAt(address);
+
+        Extents moved;
+        for (auto it = this->m_extents.lower_bound(address); it != this->m_extents.end();) {
+            auto node = this->m_extents.extract(it++);
+            this->m_size -= node.mapped().size();
+            moved.insert(std::move(node));
+        }
+
+        if (amount > 0) {
+            // Moving forward can't cause any overlaps, so the runs can be re-inserted as they are
+            while (!moved.empty()) {
+                auto node = moved.extract(moved.begin());
+                node.key() += amount;
+                this->m_size += node.mapped().size();
+                this->m_extents.insert(std::move(node));
+            }
+        } else {
+            const u64 distance = u64(-amount);
+
+            // Remember the existing patches in the area the moved ones get moved over so they can be restored afterwards
+            const u64 windowStart = address > distance ? address - distance : 0;
+            const auto kept = this->copyRange(windowStart, address - windowStart);
+
+            for (const auto &[movedAddress, extent] : moved) {
+                if (movedAddress + extent.size() <= distance)
+                    continue;
+
+                if (movedAddress < distance) {
+                    const auto skip = distance - movedAddress;
+                    this->insert(0, extent.slice(skip, extent.size() - skip));
+                } else {
+                    this->insert(movedAddress - distance, extent);
+                }
+            }
+
+            for (const auto &[keptAddress, extent] : kept)
+                this->insert(keptAddress, extent);
+        }
+    }
+
+    void PatchStore::clear() {
+        this->m_extents.clear();
+        this->m_size = 0;
+    }
+
+    PatchStore PatchStore::copyRange(u64 address, size_t size) const {
+        PatchStore result;
+        if (size == 0)
+            return result;
+
+        const u64 endAddress = address + (size - 1);
+        for (auto it = this->findFirstOverlapping(address); it != this->m_extents.end() && it->first <= endAddress; ++it) {
+            const auto &[extentAddress, extent] = *it;
+
+            const u64 start = std::max(extentAddress, address);
+            const u64 end   = std::min<u64>(extentAddress + extent.size() - 1, endAddress);
+
+            // Runs in this store never touch each other, so the copied parts don't need to be merged again
+            auto part = (start == extentAddress && end == extentAddress + extent.size() - 1) ? extent : extent.slice(start - extentAddress, (end - start) + 1);
+            result.m_size += part.size();
+            result.m_extents.emplace_hint(result.m_extents.end(), start, std::move(part));
+        }
+
+        return result;
+    }
+
+    void PatchStore::replaceRange(u64 address, size_t size, const PatchStore &patches) {
+        this->erase(address, size);
+
+        for (const auto &[patchAddress, extent] : patches.copyRange(address, size))
+            this->insert(patchAddress, extent);
+    }
+
+    void PatchStore::apply(u64 address, void *buffer, size_t size) const {
+        if (size == 0)
+            return;
+
+        const u64 endAddress = address + (size - 1);
+        for (auto it = this->findFirstOverlapping(address); it != this->m_extents.end() && it->first <= endAddress; ++it) {
+            const auto &[extentAddress, extent] = *it;
+
+            const u64 start = std::max(extentAddress, address);
+            const u64 end   = std::min<u64>(extentAddress + extent.size() - 1, endAddress);
+
+            extent.copyTo(start - extentAddress, static_cast<u8 *>(buffer) + (start - address), (end - start) + 1);
+        }
+    }
+
+    std::optional<u8> PatchStore::get(u64 address) const {
+        auto it = this->findFirstOverlapping(address);
+        if (it == this->m_extents.end() || it->first > address)
+            return std::nullopt;
+
+        return it->second[address - it->first];
+    }
+
+    bool PatchStore::contains(u64 address) const {
+        return this->get(address).has_value();
+    }
+
+    std::optional<Region> PatchStore::findNext(u64 address) const {
+        auto it = this->findFirstOverlapping(address);
+        if (it == this->m_extents.end())
+            return std::nullopt;
+
+        return Region { it->first, it->second.size() };
+    }
+
+    size_t PatchStore::getStoredSize() const {
+        size_t result = 0;
+        for (const auto &[address, extent] : this->m_extents)
+            result += extent.getData().size();
+
+        return result;
+    }
+
+    std::map<u64, u8> PatchStore::toMap() const {
+        std::map<u64, u8> result;
+
+        for (const auto &[address, data] : this->m_extents) {
+            for (u64 i = 0; i < data.size(); i++)
+                result.emplace_hint(result.end(), address + i, data[i]);
+        }
+
+        return result;
+    }
+
+    PatchStore PatchStore::fromMap(const std::map<u64, u8> &patches) {
+        PatchStore result;
+
+        for (const auto &[address, value] : patches)
+            result.set(address, &value, sizeof(value));
+
+        return result;
+    }
+
+    void to_json(nlohmann::json &j, const PatchStore &patches) {
+        // Serialized the same way as a std::map<u64, u8> to stay compatible with existing project files.
+        // Pattern runs are stored as a single [address, pattern, size] entry instead
+        j = nlohmann::json::array();
+
+        for (const auto &[address, extent] : patches) {
+            if (extent.isPattern()) {
+                j.push_back({ address, extent.getData(), extent.size() });
+                continue;
+            }
+
+            for (u64 i = 0; i < extent.size(); i++)
+                j.push_back({ address + i, extent[i] });
+        }
+    }
+
+    void from_json(const nlohmann::json &j, PatchStore &patches) {
+        patches.clear();
+
+        for (const auto &entry : j) {
+            const auto address = entry.at(0).get<u64>();
+
+            if (entry.size() == 3) {
+                const auto pattern = entry.at(1).get<std::vector<u8>>();
+                const auto size    = entry.at(2).get<size_t>();
+
+                patches.setPattern(address, pattern.data(), pattern.size(), size);
+            } else {
+                const auto value = entry.at(1).get<u8>();
+
+                patches.set(address, &value, sizeof(value));
+            }
+        }
+    }
+
+}
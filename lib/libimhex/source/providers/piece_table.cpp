@@ -0,0 +1,136 @@
+#include <hex/providers/piece_table.hpp>
+
+#include <utility>
+
+namespace hex::prv {
+
+    void PieceTable::reset(u64 size) {
+        this->m_pieces.clear();
+        if (size > 0)
+            this->m_pieces.push_back({ 0, size, 0, { } });
+
+        this->m_size         = size;
+        this->m_originalSize = size;
+    }
+
+    bool PieceTable::isModified() const {
+        if (this->m_pieces.empty())
+            return this->m_originalSize != 0;
+
+        const auto &piece = this->m_pieces.front();
+        return this->m_pieces.size() != 1 || piece.originalAddress != 0 || piece.size != this->m_originalSize;
+    }
+
+    std::vector<PieceTable::Piece>::const_iterator PieceTable::findPiece(u64 address) const {
+        auto it = std::upper_bound(this->m_pieces.begin(), this->m_pieces.end(), address, [](u64 value, const Piece &piece) {
+            return value < piece.address;
+        });
+
+        if (it == this->m_pieces.begin())
+            return this->m_pieces.end();
+
+        --it;
+        if (address >= it->address + it->size)
+            return this->m_pieces.end();
+
+        return it;
+    }
+
+    std::vector<PieceTable::Piece>::iterator PieceTable::findPiece(u64 address) {
+        const auto it = std::as_const(*this).findPiece(address);
+        return this->m_pieces.begin() + (it - this->m_pieces.cbegin());
+    }
+
+    size_t PieceTable::splitAt(u64 address) {
+        const auto it = this->findPiece(address);
+        if (it == this->m_pieces.end())
+            return this->m_pieces.size();
+
+        const size_t index = it - this->m_pieces.begin();
+        if (it->address == address)
+            return index;
+
+        const u64 headSize = address - it->address;
+
+        Piece tail = { address, it->size - headSize, std::nullopt, { } };
+        if (it->originalAddress.has_value())
+            tail.originalAddress = *it->originalAddress + headSize;
+        if (!it->data.empty()) {
+            tail.data.assign(it->data.begin() + headSize, it->data.end());
+            it->data.resize(headSize);
+        }
+        it->size = headSize;
+
+        this->m_pieces.insert(this->m_pieces.begin() + index + 1, std::move(tail));
+
+        return index + 1;
+    }
+
+    void PieceTable::mergeAt(u64 address) {
+        const auto it = this->findPiece(address);
+        if (it == this->m_pieces.end() || it == this->m_pieces.begin() || it->address != address)
+            return;
+
+        auto &previous = *(it - 1);
+        if (previous.originalAddress.has_value() && it->originalAddress.has_value()) {
+            if (*previous.originalAddress + previous.size != *it->originalAddress)
+                return;
+        } else if (previous.originalAddress.has_value() || it->originalAddress.has_value() || !previous.data.empty() || !it->data.empty()) {
+            return;
+        }
+
+        previous.size += it->size;
+        this->m_pieces.erase(it);
+    }
+
+    void PieceTable::insert(u64 address, u64 size) {
+        if (size == 0 || address > this->m_size)
+            return;
+
+        const size_t index = this->splitAt(address);
+        for (auto it = this->m_pieces.begin() + index; it != this->m_pieces.end(); ++it)
+            it->address += size;
+
+        this->m_pieces.insert(this->m_pieces.begin() + index, { address, size, std::nullopt, { } });
+        this->m_size += size;
+
+        this->mergeAt(address + size);
+        this->mergeAt(address);
+    }
+
+    void PieceTable::remove(u64 address, u64 size) {
+        if (size == 0 || address >= this->m_size)
+            return;
+
+        size = std::min(size, this->m_size - address);
+
+        const size_t first = this->splitAt(address);
+        const size_t last  = this->splitAt(address + size);
+
+        this->m_pieces.erase(this->m_pieces.begin() + first, this->m_pieces.begin() + last);
+        for (auto it = this->m_pieces.begin() + first; it != this->m_pieces.end(); ++it)
+            it->address -= size;
+
+        this->m_size -= size;
+
+        // Removing previously inserted bytes may make original data adjacent again
+        this->mergeAt(address);
+    }
+
+    const PieceTable::Piece *PieceTable::getPiece(u64 address) const {
+        const auto it = this->findPiece(address);
+        if (it == this->m_pieces.end())
+            return nullptr;
+
+        return &*it;
+    }
+
+    std::optional<u64> PieceTable::findOriginalAddress(u64 address, u64 size) const {
+        const auto it = this->findPiece(address);
+        if (it == this->m_pieces.end() || !it->originalAddress.has_value() || address + size > it->address + it->size)
+            return std::nullopt;
+
+        return *it->originalAddress + (address - it->address);
+    }
+
+}
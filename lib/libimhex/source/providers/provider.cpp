@@ -1,10 +1,13 @@
 #include <hex/providers/provider.hpp>
+#include <hex/providers/snapshot.hpp>
 
 #include <hex.hpp>
 #include <hex/api/event.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <limits>
 #include <map>
 #include <optional>
 
@@ -21,8 +24,6 @@ namespace hex::prv {
 
 
     Provider::Provider() : m_id(s_idCounter++) {
-        this->m_patches.emplace_back();
-        this->m_currPatches = this->m_patches.begin();
     }
 
     Provider::~Provider() {
@@ -32,16 +33,160 @@ namespace hex::prv {
     }
 
     void Provider::read(u64 offset, void *buffer, size_t size, bool overlays) {
-        hex::unused(overlays);
+        IoStatistics::ReadScope readScope(this, offset, size);
 
         this->readRaw(offset - this->getBaseAddress(), buffer, size);
+
+        if (overlays) [[likely]] {
+            this->getPatches().apply(offset, buffer, size);
+            this->applyOverlays(offset, buffer, size);
+        }
+    }
+
+    void Provider::readv(std::span<const ReadRequest> requests, bool overlays) {
+        // Gaps of up to this size between two requests are read as well if that allows merging them
+        constexpr static size_t MaxGapSize   = 0x100;
+        constexpr static size_t MaxMergeSize = 0x10'0000;
+
+        std::vector<const ReadRequest *> sortedRequests;
+        sortedRequests.reserve(requests.size());
+        for (const auto &request : requests) {
+            if (request.size > 0 && request.buffer != nullptr)
+                sortedRequests.push_back(&request);
+        }
+
+        std::sort(sortedRequests.begin(), sortedRequests.end(), [](const auto *a, const auto *b) {
+            return a->offset < b->offset;
+        });
+
+        if (sortedRequests.empty())
+            return;
+
+        // The whole batch counts as a single read, the merged reads it's split up into don't get counted again
+        size_t totalSize = 0;
+        for (const auto *request : sortedRequests)
+            totalSize += request->size;
+        IoStatistics::ReadScope readScope(this, sortedRequests.front()->offset, totalSize);
+
+        std::vector<u8> buffer;
+        for (size_t first = 0; first < sortedRequests.size();) {
+            const u64 mergedStart = sortedRequests[first]->offset;
+            u64 mergedEnd = mergedStart + sortedRequests[first]->size;
+
+            size_t last = first + 1;
+            while (last < sortedRequests.size()) {
+                const auto &request = *sortedRequests[last];
+                const u64 requestEnd = request.offset + request.size;
+
+                if (request.offset > mergedEnd + MaxGapSize || std::max(mergedEnd, requestEnd) - mergedStart > MaxMergeSize)
+                    break;
+
+                mergedEnd = std::max(mergedEnd, requestEnd);
+                last++;
+            }
+
+            if (last == first + 1) {
+                const auto &request = *sortedRequests[first];
+                this->read(request.offset, request.buffer, request.size, overlays);
+            } else {
+                buffer.resize(mergedEnd - mergedStart);
+                this->read(mergedStart, buffer.data(), buffer.size(), overlays);
+
+                for (size_t i = first; i < last; i++) {
+                    const auto &request = *sortedRequests[i];
+                    std::memcpy(request.buffer, buffer.data() + (request.offset - mergedStart), request.size);
+                }
+            }
+
+            first = last;
+        }
+    }
+
+    std::optional<std::span<const u8>> Provider::tryGetSpan(u64 offset, size_t size) {
+        hex::unused(offset, size);
+
+        return std::nullopt;
+    }
+
+    std::span<const u8> Provider::readSpan(u64 offset, size_t size, std::vector<u8> &buffer) {
+        if (auto span = this->tryGetSpan(offset, size); span.has_value())
+            return *span;
+
+        buffer.resize(size);
+        this->read(offset, buffer.data(), buffer.size());
+
+        return buffer;
+    }
+
+    bool Provider::isDataAvailable(u64 offset, size_t size) const {
+        hex::unused(offset, size);
+
+        return true;
+    }
+
+    void Provider::prefetch(const Region &region) {
+        hex::unused(region);
+    }
+
+    bool Provider::isUnmodified(u64 offset, size_t size) const {
+        if (size == 0)
+            return true;
+
+        if (auto patch = this->getPatches().findNext(offset); patch.has_value() && patch->getStartAddress() <= offset + (size - 1))
+            return false;
+
+        return !this->m_overlayIndex.overlaps({ offset, size });
+    }
+
+    std::optional<u64> Provider::findFirstModification(const Region &region) const {
+        if (region.getSize() == 0)
+            return std::nullopt;
+
+        if (this->m_overlayIndex.overlaps({ region.getStartAddress(), 1 }))
+            return region.getStartAddress();
+
+        std::optional<u64> result;
+        if (auto nextOverlay = this->m_overlayIndex.findNextStart(region.getStartAddress()); nextOverlay.has_value() && *nextOverlay <= region.getEndAddress())
+            result = *nextOverlay;
+
+        if (auto patch = this->getPatches().findNext(region.getStartAddress()); patch.has_value() && patch->getStartAddress() <= region.getEndAddress()) {
+            const u64 patchAddress = std::max(patch->getStartAddress(), region.getStartAddress());
+            if (!result.has_value() || patchAddress < *result)
+                result = patchAddress;
+        }
+
+        return result;
     }
 
     void Provider::write(u64 offset, const void *buffer, size_t size) {
+        this->materializeSnapshots({ offset, size });
         this->writeRaw(offset - this->getBaseAddress(), buffer, size);
         this->markDirty();
     }
 
+    Provider::PreparedFill Provider::prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback) {
+        if (progressCallback)
+            progressCallback(size);
+
+        return { offset, size, pattern, { } };
+    }
+
+    void Provider::fill(const PreparedFill &fill) {
+        if (fill.size == 0 || fill.pattern.empty())
+            return;
+
+        // Expand the pattern into a larger buffer once so the data can be written in big chunks
+        constexpr static size_t TargetChunkSize = 0x10'0000;
+        std::vector<u8> buffer(std::max<size_t>(1, TargetChunkSize / fill.pattern.size()) * fill.pattern.size());
+        for (size_t i = 0; i < buffer.size(); i += fill.pattern.size())
+            std::copy(fill.pattern.begin(), fill.pattern.end(), buffer.begin() + i);
+
+        for (u64 processed = 0; processed < fill.size; processed += buffer.size()) {
+            const auto currentSize = std::min<size_t>(buffer.size(), fill.size - processed);
+            this->write(fill.offset + processed, buffer.data(), currentSize);
+        }
+    }
+
     void Provider::save() {
         EventManager::post<EventProviderSaved>(this);
     }
@@ -63,14 +208,23 @@ namespace hex::prv {
                 bufferSize = std::min<size_t>(bufferSize, (newRegion.getEndAddress() - offset) + 1);
                 bufferSize = std::min<size_t>(bufferSize, this->getActualSize() - offset);
 
+                // Bytes that are known to be zero are skipped, which leaves holes in the new file as well
+                if (auto [zeroRegion, zero] = this->getZeroRegion(offset + this->getBaseAddress()); zero) {
+                    bufferSize = std::min<size_t>(zeroRegion.getSize(), this->getActualSize() - offset);
+                    continue;
+                }
+
                 this->read(offset + this->getBaseAddress(), buffer.data(), bufferSize, true);
+                file.seek(offset);
                 file.writeBuffer(buffer.data(), bufferSize);
             }
 
-            for (auto &[patchAddress, patch] : getPatches()) {
+            file.setSize(this->getActualSize());
+
+            getPatches().forEachOverlapping({ 0, std::numeric_limits<u64>::max() }, [&](u64 patchAddress, const u8 *data, size_t size) {
                 file.seek(patchAddress - this->getBaseAddress());
-                file.writeBuffer(&patch, 1);
-            }
+                file.writeBuffer(data, size);
+            });
 
             EventManager::post<EventProviderSaved>(this);
         }
@@ -83,90 +237,81 @@ namespace hex::prv {
     }
 
     void Provider::insert(u64 offset, size_t size) {
-        auto &patches = getPatches();
-
-        std::vector<std::pair<u64, u8>> patchesToMove;
-
-        for (auto &[address, value] : patches) {
-            if (address > offset)
-                patchesToMove.emplace_back(address, value);
-        }
-
-        for (const auto &[address, value] : patchesToMove)
-            patches.erase(address);
-        for (const auto &[address, value] : patchesToMove)
-            patches.insert({ address + size, value });
+        this->m_patchHistory.shift(offset + 1, i64(size));
 
         this->markDirty();
     }
 
     void Provider::remove(u64 offset, size_t size) {
-        auto &patches = getPatches();
-
-        std::vector<std::pair<u64, u8>> patchesToMove;
-
-        for (auto &[address, value] : patches) {
-            if (address > offset)
-                patchesToMove.emplace_back(address, value);
-        }
-
-        for (const auto &[address, value] : patchesToMove)
-            patches.erase(address);
-        for (const auto &[address, value] : patchesToMove)
-            patches.insert({ address - size, value });
+        this->m_patchHistory.shift(offset + 1, -i64(size));
 
         this->markDirty();
     }
 
     void Provider::applyOverlays(u64 offset, void *buffer, size_t size) {
-        for (auto &overlay : this->m_overlays) {
-            auto overlayOffset = overlay->getAddress();
-            auto overlaySize   = overlay->getSize();
-
-            i128 overlapMin = std::max(offset, overlayOffset);
-            i128 overlapMax = std::min(offset + size, overlayOffset + overlaySize);
-            if (overlapMax > overlapMin)
-                std::memcpy(static_cast<u8 *>(buffer) + std::max<i128>(0, overlapMin - offset), overlay->getData().data() + std::max<i128>(0, overlapMin - overlayOffset), overlapMax - overlapMin);
-        }
+        if (size == 0 || this->m_overlayIndex.empty())
+            return;
+
+        this->m_overlayIndex.forEachOverlapping({ offset, size }, [&](const Overlay *overlay) {
+            const u64 overlapMin = std::max(offset, overlay->getAddress());
+            const u64 overlapMax = std::min<u128>(u128(offset) + size, u128(overlay->getAddress()) + overlay->getSize());
+
+            overlay->read(overlapMin - overlay->getAddress(), static_cast<u8 *>(buffer) + (overlapMin - offset), overlapMax - overlapMin);
+        });
     }
 
 
-    std::map<u64, u8> &Provider::getPatches() {
-        return *this->m_currPatches;
+    PatchStore &Provider::getPatches() {
+        return this->m_patchHistory.getPatches();
     }
 
-    const std::map<u64, u8> &Provider::getPatches() const {
-        return *this->m_currPatches;
+    const PatchStore &Provider::getPatches() const {
+        return this->m_patchHistory.getPatches();
     }
 
     void Provider::applyPatches() {
         if (!this->isWritable())
             return;
 
-        this->m_patches.emplace_back();
+        // Keeping the original values around only makes sense if they'd fit into the undo history
+        const bool keepOriginalValues = getPatches().size() <= PatchHistory::getMemoryLimit();
 
-        for (auto &[patchAddress, patch] : getPatches()) {
-            u8 value = 0x00;
-            this->readRaw(patchAddress - this->getBaseAddress(), &value, 1);
-            this->m_patches.back().insert({ patchAddress, value });
-        }
+        PatchStore originalValues;
+        std::vector<u8> values;
 
-        for (auto &[patchAddress, patch] : getPatches()) {
-            this->writeRaw(patchAddress - this->getBaseAddress(), &patch, 1);
-        }
+        // Pattern patches get expanded chunk by chunk here, so they never need to be fully stored in memory
+        getPatches().forEachOverlapping({ 0, std::numeric_limits<u64>::max() }, [&](u64 patchAddress, const u8 *data, size_t size) {
+            if (keepOriginalValues) {
+                values.resize(size);
+                this->readRaw(patchAddress - this->getBaseAddress(), values.data(), values.size());
+                originalValues.set(patchAddress, values.data(), values.size());
+            }
+
+            this->writeRaw(patchAddress - this->getBaseAddress(), data, size);
+        });
 
         this->markDirty();
 
-        this->m_patches.emplace_back();
-        this->m_currPatches = std::prev(this->m_patches.end());
+        // Keep the original values around as patches so saving can be undone
+        if (keepOriginalValues) {
+            this->m_patchHistory.createUndoPoint();
+            this->m_patchHistory.replace(std::move(originalValues));
+        }
+
+        this->m_patchHistory.createUndoPoint();
+        this->m_patchHistory.replace({ });
     }
 
 
     Overlay *Provider::newOverlay() {
-        return this->m_overlays.emplace_back(new Overlay());
+        auto overlay = this->m_overlays.emplace_back(new Overlay());
+        this->m_overlayIndex.insert(overlay);
+
+        return overlay;
     }
 
     void Provider::deleteOverlay(Overlay *overlay) {
+        this->m_overlayIndex.remove(overlay);
         this->m_overlays.remove(overlay);
         delete overlay;
     }
@@ -202,6 +347,10 @@ namespace hex::prv {
 
 
     void Provider::setBaseAddress(u64 address) {
+        // Patches stay at their addresses, so moving the data underneath them changes what snapshots would read
+        if (!this->getPatches().empty())
+            this->detachSnapshots();
+
         this->m_baseAddress = address;
         this->markDirty();
     }
@@ -228,53 +377,136 @@ namespace hex::prv {
     }
 
     void Provider::addPatch(u64 offset, const void *buffer, size_t size, bool createUndo) {
-        if (createUndo) {
-            // Delete all patches after the current one if a modification is made while
-            // the current patch list is not at the end of the undo stack
-            if (std::next(this->m_currPatches) != this->m_patches.end())
-                this->m_patches.erase(std::next(this->m_currPatches), this->m_patches.end());
-
+        if (createUndo)
             createUndoPoint();
-        }
 
-        for (u64 i = 0; i < size; i++) {
-            u8 patch         = reinterpret_cast<const u8 *>(buffer)[i];
-            u8 originalValue = 0x00;
-            this->readRaw((offset + i) - this->getBaseAddress(), &originalValue, sizeof(u8));
+        if (size == 0)
+            return;
+
+        const auto newValues = static_cast<const u8 *>(buffer);
+
+        this->materializeSnapshots({ offset, size });
+
+        // Fetch all original values at once instead of issuing a separate read for every byte
+        std::vector<u8> originalValues(size);
+        this->readRaw(offset - this->getBaseAddress(), originalValues.data(), originalValues.size());
+
+        // Bytes that are set back to their original value don't need a patch anymore
+        auto &patches = this->m_patchHistory.change(offset, size);
+        for (u64 runStart = 0; runStart < size;) {
+            const bool unchanged = newValues[runStart] == originalValues[runStart];
 
-            if (patch == originalValue)
-                getPatches().erase(offset + i);
+            u64 runEnd = runStart + 1;
+            while (runEnd < size && (newValues[runEnd] == originalValues[runEnd]) == unchanged)
+                runEnd++;
+
+            if (unchanged)
+                patches.erase(offset + runStart, runEnd - runStart);
             else
-                getPatches()[offset + i] = patch;
+                patches.set(offset + runStart, newValues + runStart, runEnd - runStart);
 
-            EventManager::post<EventPatchCreated>(offset, originalValue, patch);
+            runStart = runEnd;
         }
 
         this->markDirty();
 
+        this->postPatchEvents(offset, originalValues, std::span<const u8>(newValues, size));
+    }
+
+    Provider::PreparedFill Provider::preparePatchFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback) {
+        PreparedFill result = { offset, size, pattern, { } };
+
+        const bool postEvents = EventManager::hasSubscribers<EventPatchRangeCreated>() || EventManager::hasSubscribers<EventPatchCreated>();
+        if (!postEvents || size == 0 || pattern.empty()) {
+            if (progressCallback)
+                progressCallback(size);
+
+            return result;
+        }
+
+        // Reading the original values is the only part of a fill that's proportional to its size. Do it in chunks so it can be cancelled
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        result.originalValues.resize(size);
+        for (u64 processed = 0; processed < size; processed += ChunkSize) {
+            const auto currentSize = std::min<size_t>(ChunkSize, size - processed);
+            this->readRaw(offset + processed - this->getBaseAddress(), result.originalValues.data() + processed, currentSize);
+
+            if (progressCallback)
+                progressCallback(processed + currentSize);
+        }
+
+        return result;
+    }
+
+    void Provider::addFillPatch(u64 offset, size_t size, const std::vector<u8> &pattern, bool createUndo) {
+        this->addFillPatch(this->preparePatchFill(offset, size, pattern), createUndo);
+    }
+
+    void Provider::addFillPatch(const PreparedFill &fill, bool createUndo) {
+        if (createUndo)
+            createUndoPoint();
+
+        if (fill.size == 0 || fill.pattern.empty())
+            return;
+
+        this->materializeSnapshots({ fill.offset, fill.size });
+
+        this->m_patchHistory.change(fill.offset, fill.size).setPattern(fill.offset, fill.pattern.data(), fill.pattern.size(), fill.size);
+        this->markDirty();
+
+        if (fill.originalValues.size() != fill.size)
+            return;
+
+        // Post the patch events in chunks so no expanded copy of the whole fill is needed
+        constexpr static size_t TargetChunkSize = 0x10'0000;
+        std::vector<u8> newValues(std::max<size_t>(1, TargetChunkSize / fill.pattern.size()) * fill.pattern.size());
+        for (size_t i = 0; i < newValues.size(); i += fill.pattern.size())
+            std::copy(fill.pattern.begin(), fill.pattern.end(), newValues.begin() + i);
+
+        for (u64 processed = 0; processed < fill.size; processed += newValues.size()) {
+            const auto currentSize = std::min<size_t>(newValues.size(), fill.size - processed);
+
+            this->postPatchEvents(fill.offset + processed,
+                                  std::span<const u8>(fill.originalValues).subspan(processed, currentSize),
+                                  std::span<const u8>(newValues).first(currentSize));
+        }
+    }
+
+    void Provider::postPatchEvents(u64 offset, std::span<const u8> originalValues, std::span<const u8> newValues) {
+        EventManager::post<EventPatchRangeCreated>(offset, originalValues, newValues);
+
+        // Only emit the legacy per-byte events if anybody still listens to them
+        if (EventManager::hasSubscribers<EventPatchCreated>()) {
+            for (u64 i = 0; i < newValues.size(); i++)
+                EventManager::post<EventPatchCreated>(offset + i, originalValues[i], newValues[i]);
+        }
     }
 
     void Provider::createUndoPoint() {
-        this->m_patches.push_back(getPatches());
-        this->m_currPatches = std::prev(this->m_patches.end());
+        this->m_patchHistory.createUndoPoint();
     }
 
     void Provider::undo() {
-        if (canUndo())
-            this->m_currPatches--;
+        for (const auto &region : this->m_patchHistory.getUndoRegions())
+            this->materializeSnapshots(region);
+
+        this->m_patchHistory.undo();
     }
 
     void Provider::redo() {
-        if (canRedo())
-            this->m_currPatches++;
+        for (const auto &region : this->m_patchHistory.getRedoRegions())
+            this->materializeSnapshots(region);
+
+        this->m_patchHistory.redo();
     }
 
     bool Provider::canUndo() const {
-        return this->m_currPatches != this->m_patches.begin();
+        return this->m_patchHistory.canUndo();
     }
 
     bool Provider::canRedo() const {
-        return std::next(this->m_currPatches) != this->m_patches.end();
+        return this->m_patchHistory.canRedo();
     }
 
     bool Provider::hasFilePicker() const {
@@ -320,26 +552,36 @@ namespace hex::prv {
             return { Region::Invalid(), false };
 
         bool insideValidRegion = false;
-
         std::optional<u64> nextRegionAddress;
-        for (const auto &overlay : this->m_overlays) {
-            Region overlayRegion = { overlay->getAddress(), overlay->getSize() };
-            if (!nextRegionAddress.has_value() || overlay->getAddress() < nextRegionAddress) {
-                nextRegionAddress = overlayRegion.getStartAddress();
-            }
 
-            if (Region { address, 1 }.overlaps(overlayRegion)) {
+        // Finds the closest address after the requested one at which the validity changes
+        const auto addBoundary = [&](const Region &region) {
+            if (region.getSize() == 0)
+                return;
+
+            u64 boundary;
+            if (region.getStartAddress() <= address && address <= region.getEndAddress()) {
                 insideValidRegion = true;
+                boundary = region.getEndAddress() + 1;
+            } else if (region.getStartAddress() > address) {
+                boundary = region.getStartAddress();
+            } else {
+                return;
             }
-        }
 
-        for (const auto &[patchAddress, value] : this->m_patches.back()) {
-            if (!nextRegionAddress.has_value() || patchAddress < nextRegionAddress)
-                nextRegionAddress = patchAddress;
+            if (!nextRegionAddress.has_value() || boundary < *nextRegionAddress)
+                nextRegionAddress = boundary;
+        };
 
-            if (address == patchAddress)
-                insideValidRegion = true;
-        }
+        this->m_overlayIndex.forEachOverlapping({ address, 1 }, [&](const Overlay *overlay) {
+            addBoundary({ overlay->getAddress(), overlay->getSize() });
+        });
+
+        if (auto nextOverlay = this->m_overlayIndex.findNextStart(address); nextOverlay.has_value())
+            addBoundary({ *nextOverlay, 1 });
+
+        if (auto patchRegion = this->getPatches().findNext(address); patchRegion.has_value())
+            addBoundary(*patchRegion);
 
         if (!nextRegionAddress.has_value())
             return { Region::Invalid(), false };
@@ -347,6 +589,13 @@ namespace hex::prv {
             return { Region { address, *nextRegionAddress - address }, insideValidRegion };
     }
 
+    std::pair<Region, bool> Provider::getZeroRegion(u64 address) const {
+        if ((address - this->getBaseAddress()) >= this->getActualSize())
+            return { Region::Invalid(), false };
+
+        return { Region { address, this->getActualSize() - (address - this->getBaseAddress()) }, false };
+    }
+
 
     u32 Provider::getID() const {
         return this->m_id;
@@ -374,4 +623,38 @@ namespace hex::prv {
         return true;
     }
 
+    bool Provider::isDataStable() const {
+        return false;
+    }
+
+    void Provider::releaseResources() { }
+
+    void Provider::attachSnapshot(Snapshot *snapshot) {
+        std::scoped_lock lock(this->m_snapshotMutex);
+
+        this->m_snapshots.push_back(snapshot);
+    }
+
+    void Provider::detachSnapshot(Snapshot *snapshot) {
+        std::scoped_lock lock(this->m_snapshotMutex);
+
+        std::erase(this->m_snapshots, snapshot);
+    }
+
+    void Provider::detachSnapshots() {
+        std::scoped_lock lock(this->m_snapshotMutex);
+
+        Snapshot::detach(this->m_snapshots);
+        this->m_snapshots.clear();
+    }
+
+    void Provider::materializeSnapshots(const Region &region) {
+        std::scoped_lock lock(this->m_snapshotMutex);
+
+        if (this->m_snapshots.empty() || region.getSize() == 0 || region.getStartAddress() < this->getBaseAddress())
+            return;
+
+        Snapshot::materialize(this->m_snapshots, { region.getStartAddress() - this->getBaseAddress(), region.getSize() });
+    }
+
 }
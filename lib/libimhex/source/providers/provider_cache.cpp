@@ -0,0 +1,393 @@
+#include <hex/providers/provider_cache.hpp>
+#include <hex/providers/io_statistics.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+
+namespace hex::prv {
+
+    ProviderCache::ProviderCache(size_t blockSize, size_t budget) : m_blockSize(std::max<size_t>(blockSize, 1)), m_budget(budget) {
+    }
+
+    ProviderCache::Shard &ProviderCache::getShard(u64 blockIndex) {
+        // Spread neighbouring blocks over different shards so linear reads from multiple threads don't contend on the same lock
+        return this->m_shards[blockIndex % ShardCount];
+    }
+
+    const ProviderCache::Shard &ProviderCache::getShard(u64 blockIndex) const {
+        return this->m_shards[blockIndex % ShardCount];
+    }
+
+    bool ProviderCache::copyFromBlock(u64 blockIndex, u64 blockOffset, u8 *buffer, size_t size) {
+        auto &shard = this->getShard(blockIndex);
+        std::scoped_lock lock(shard.mutex);
+
+        auto it = shard.lookup.find(blockIndex);
+        if (it == shard.lookup.end())
+            return false;
+
+        const auto &data = it->second->data;
+        if (blockOffset + size > data.size())
+            return false;
+
+        std::memcpy(buffer, data.data() + blockOffset, size);
+
+        // Mark block as most recently used
+        shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+
+        return true;
+    }
+
+    void ProviderCache::insertBlock(u64 blockIndex, const u8 *data, size_t size) {
+        auto &shard = this->getShard(blockIndex);
+        std::scoped_lock lock(shard.mutex);
+
+        if (auto it = shard.lookup.find(blockIndex); it != shard.lookup.end()) {
+            shard.usedBytes -= it->second->data.size();
+            shard.blocks.erase(it->second);
+            shard.lookup.erase(it);
+        }
+
+        shard.blocks.push_front({ blockIndex, std::vector<u8>(data, data + size) });
+        shard.lookup[blockIndex] = shard.blocks.begin();
+        shard.usedBytes += size;
+
+        this->evict(shard, this->m_budget / ShardCount);
+    }
+
+    void ProviderCache::evict(Shard &shard, size_t shardBudget) {
+        while (shard.usedBytes > shardBudget && !shard.blocks.empty()) {
+            const auto &block = shard.blocks.back();
+
+            shard.usedBytes -= block.data.size();
+            shard.lookup.erase(block.index);
+            shard.blocks.pop_back();
+
+            this->m_evictions += 1;
+        }
+    }
+
+    void ProviderCache::read(u64 offset, void *buffer, size_t size, size_t dataSize, const ReadFunction &readFunction) {
+        if (size == 0 || offset >= dataSize)
+            return;
+
+        const size_t blockSize = this->m_blockSize;
+        const u64 endOffset    = std::min<u64>(offset + size, dataSize);
+
+        // Requests larger than what the cache can hold would only evict everything else, so pass them through directly
+        if ((endOffset - offset) > this->m_budget / 4) {
+            readFunction(offset, buffer, endOffset - offset);
+            return;
+        }
+
+        auto bytes = static_cast<u8 *>(buffer);
+
+        const u64 firstBlock = offset / blockSize;
+        const u64 lastBlock  = (endOffset - 1) / blockSize;
+
+        std::optional<u64> firstMissingBlock;
+        std::vector<u8> missBuffer;
+
+        // Fetches a run of consecutive missing blocks using a single backend read
+        const auto fetchMissingBlocks = [&](u64 endBlock) {
+            const u64 missStart = *firstMissingBlock * blockSize;
+            const u64 missEnd   = std::min<u64>(endBlock * blockSize, dataSize);
+
+            missBuffer.resize(missEnd - missStart);
+            readFunction(missStart, missBuffer.data(), missBuffer.size());
+
+            for (u64 blockAddress = missStart; blockAddress < missEnd; blockAddress += blockSize)
+                this->insertBlock(blockAddress / blockSize, missBuffer.data() + (blockAddress - missStart), std::min<u64>(blockSize, missEnd - blockAddress));
+
+            const u64 copyStart = std::max(missStart, offset);
+            const u64 copyEnd   = std::min(missEnd, endOffset);
+            std::memcpy(bytes + (copyStart - offset), missBuffer.data() + (copyStart - missStart), copyEnd - copyStart);
+
+            firstMissingBlock.reset();
+        };
+
+        for (u64 blockIndex = firstBlock; blockIndex <= lastBlock; blockIndex++) {
+            const u64 blockStart = blockIndex * blockSize;
+            const u64 copyStart  = std::max(blockStart, offset);
+            const u64 copyEnd    = std::min(blockStart + blockSize, endOffset);
+
+            if (this->copyFromBlock(blockIndex, copyStart - blockStart, bytes + (copyStart - offset), copyEnd - copyStart)) {
+                this->m_hits += 1;
+                IoStatistics::recordCacheAccess(true);
+
+                if (firstMissingBlock.has_value())
+                    fetchMissingBlocks(blockIndex);
+            } else {
+                this->m_misses += 1;
+                IoStatistics::recordCacheAccess(false);
+
+                if (!firstMissingBlock.has_value())
+                    firstMissingBlock = blockIndex;
+            }
+        }
+
+        if (firstMissingBlock.has_value())
+            fetchMissingBlocks(lastBlock + 1);
+    }
+
+    void ProviderCache::readv(std::span<const ReadRequest> requests, size_t dataSize, const ReadvFunction &readFunction) {
+        const size_t blockSize = this->m_blockSize;
+
+        // Requests larger than what the cache can hold would only evict everything else, so they're passed through directly
+        const size_t maxCachedSize = this->m_budget / 4;
+
+        std::vector<ReadRequest> backendRequests;
+        std::set<u64> missingBlocks;
+
+        // Copy everything that's cached already and collect the blocks that are missing from all requests together
+        for (const auto &request : requests) {
+            if (request.size == 0 || request.buffer == nullptr || request.offset >= dataSize)
+                continue;
+
+            const u64 endOffset = std::min<u64>(request.offset + request.size, dataSize);
+
+            if ((endOffset - request.offset) > maxCachedSize) {
+                backendRequests.push_back({ request.offset, endOffset - request.offset, request.buffer });
+                continue;
+            }
+
+            auto bytes = static_cast<u8 *>(request.buffer);
+            for (u64 blockIndex = request.offset / blockSize; blockIndex <= (endOffset - 1) / blockSize; blockIndex++) {
+                const u64 blockStart = blockIndex * blockSize;
+                const u64 copyStart  = std::max(blockStart, request.offset);
+                const u64 copyEnd    = std::min(blockStart + blockSize, endOffset);
+
+                if (this->copyFromBlock(blockIndex, copyStart - blockStart, bytes + (copyStart - request.offset), copyEnd - copyStart)) {
+                    this->m_hits += 1;
+                    IoStatistics::recordCacheAccess(true);
+                } else {
+                    this->m_misses += 1;
+                    IoStatistics::recordCacheAccess(false);
+
+                    missingBlocks.insert(blockIndex);
+                }
+            }
+        }
+
+        // Runs of consecutive missing blocks get fetched with a single backend request each, indexed by their first block
+        std::map<u64, std::vector<u8>> missingRuns;
+        for (auto it = missingBlocks.begin(); it != missingBlocks.end();) {
+            const u64 firstBlock = *it;
+            u64 endBlock = firstBlock + 1;
+            for (++it; it != missingBlocks.end() && *it == endBlock; ++it)
+                endBlock++;
+
+            const u64 runStart = firstBlock * blockSize;
+            const u64 runEnd   = std::min<u64>(endBlock * blockSize, dataSize);
+
+            auto &runData = missingRuns[firstBlock];
+            runData.resize(runEnd - runStart);
+            backendRequests.push_back({ runStart, runData.size(), runData.data() });
+        }
+
+        if (backendRequests.empty())
+            return;
+
+        readFunction(backendRequests);
+
+        for (const auto &[firstBlock, runData] : missingRuns) {
+            for (u64 runOffset = 0; runOffset < runData.size(); runOffset += blockSize)
+                this->insertBlock(firstBlock + runOffset / blockSize, runData.data() + runOffset, std::min<u64>(blockSize, runData.size() - runOffset));
+        }
+
+        // Fill in the parts of the requests that weren't cached
+        for (const auto &request : requests) {
+            if (request.size == 0 || request.buffer == nullptr || request.offset >= dataSize)
+                continue;
+
+            const u64 endOffset = std::min<u64>(request.offset + request.size, dataSize);
+            if ((endOffset - request.offset) > maxCachedSize)
+                continue;
+
+            auto bytes = static_cast<u8 *>(request.buffer);
+            for (u64 blockIndex = request.offset / blockSize; blockIndex <= (endOffset - 1) / blockSize; blockIndex++) {
+                if (!missingBlocks.contains(blockIndex))
+                    continue;
+
+                const auto &[firstBlock, runData] = *std::prev(missingRuns.upper_bound(blockIndex));
+
+                const u64 blockStart = blockIndex * blockSize;
+                const u64 copyStart  = std::max(blockStart, request.offset);
+                const u64 copyEnd    = std::min(blockStart + blockSize, endOffset);
+                std::memcpy(bytes + (copyStart - request.offset), runData.data() + (copyStart - firstBlock * blockSize), copyEnd - copyStart);
+            }
+        }
+    }
+
+    void ProviderCache::prefetch(u64 offset, size_t size, size_t dataSize, ReadFunction readFunction) {
+        if (size == 0 || offset >= dataSize)
+            return;
+
+        // Only prefetch as much as read() would actually keep in the cache
+        size = std::min<u64>({ size, dataSize - offset, this->m_budget / 4 });
+        if (size == 0 || this->contains(offset, size, dataSize))
+            return;
+
+        {
+            std::scoped_lock lock(this->m_prefetchMutex);
+
+            if (this->m_prefetchRequests.size() >= MaxPrefetchRequests)
+                this->m_prefetchRequests.pop_front();
+            this->m_prefetchRequests.push_back({ offset, size, dataSize, std::move(readFunction) });
+
+            if (!this->m_prefetchThread.joinable()) {
+                this->m_prefetchThread = std::jthread([this](const std::stop_token &stopToken) {
+                    this->processPrefetchRequests(stopToken);
+                });
+            }
+        }
+
+        this->m_prefetchRequested.notify_one();
+    }
+
+    void ProviderCache::processPrefetchRequests(const std::stop_token &stopToken) {
+        std::vector<u8> buffer;
+
+        while (true) {
+            PrefetchRequest request;
+            {
+                std::unique_lock lock(this->m_prefetchMutex);
+                if (!this->m_prefetchRequested.wait(lock, stopToken, [this] { return !this->m_prefetchRequests.empty(); }))
+                    return;
+
+                // Serve the most recent request first, it's the one most likely to be needed next
+                request = std::move(this->m_prefetchRequests.back());
+                this->m_prefetchRequests.pop_back();
+                this->m_prefetchRunning = true;
+            }
+
+            buffer.resize(request.size);
+            this->read(request.offset, buffer.data(), buffer.size(), request.dataSize, request.readFunction);
+
+            {
+                std::scoped_lock lock(this->m_prefetchMutex);
+                this->m_prefetchRunning = false;
+            }
+            this->m_prefetchFinished.notify_all();
+        }
+    }
+
+    void ProviderCache::waitForPrefetch() {
+        std::unique_lock lock(this->m_prefetchMutex);
+        this->m_prefetchFinished.wait(lock, [this] { return !this->m_prefetchRunning; });
+    }
+
+    bool ProviderCache::contains(u64 offset, size_t size, size_t dataSize) const {
+        if (size == 0 || offset >= dataSize)
+            return true;
+
+        const size_t blockSize = this->m_blockSize;
+        const u64 endOffset    = std::min<u64>(offset + size, dataSize);
+
+        for (u64 blockIndex = offset / blockSize; blockIndex <= (endOffset - 1) / blockSize; blockIndex++) {
+            const auto &shard = this->getShard(blockIndex);
+            std::scoped_lock lock(shard.mutex);
+
+            auto it = shard.lookup.find(blockIndex);
+            if (it == shard.lookup.end())
+                return false;
+
+            // The last block of the data may be shorter than the block size
+            const u64 blockStart = blockIndex * blockSize;
+            if (blockStart + it->second->data.size() < std::min<u64>(blockStart + blockSize, endOffset))
+                return false;
+        }
+
+        return true;
+    }
+
+    void ProviderCache::invalidate(u64 offset, size_t size) {
+        if (size == 0)
+            return;
+
+        // A prefetch that's currently running might have read the old data already, let it finish so it can be dropped as well
+        this->waitForPrefetch();
+
+        const size_t blockSize = this->m_blockSize;
+        const u64 firstBlock   = offset / blockSize;
+        const u64 lastBlock    = (offset + (size - 1)) / blockSize;
+
+        for (auto &shard : this->m_shards) {
+            std::scoped_lock lock(shard.mutex);
+
+            // Either look up every block in the range or go through all cached blocks, whichever is less work
+            if ((lastBlock - firstBlock) / ShardCount < shard.lookup.size()) {
+                for (u64 blockIndex = firstBlock; blockIndex <= lastBlock; blockIndex++) {
+                    if (&this->getShard(blockIndex) != &shard)
+                        continue;
+
+                    if (auto it = shard.lookup.find(blockIndex); it != shard.lookup.end()) {
+                        shard.usedBytes -= it->second->data.size();
+                        shard.blocks.erase(it->second);
+                        shard.lookup.erase(it);
+                    }
+                }
+            } else {
+                for (auto it = shard.blocks.begin(); it != shard.blocks.end();) {
+                    if (it->index >= firstBlock && it->index <= lastBlock) {
+                        shard.usedBytes -= it->data.size();
+                        shard.lookup.erase(it->index);
+                        it = shard.blocks.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+        }
+    }
+
+    void ProviderCache::clear() {
+        {
+            std::scoped_lock lock(this->m_prefetchMutex);
+            this->m_prefetchRequests.clear();
+        }
+        this->waitForPrefetch();
+
+        for (auto &shard : this->m_shards) {
+            std::scoped_lock lock(shard.mutex);
+
+            shard.blocks.clear();
+            shard.lookup.clear();
+            shard.usedBytes = 0;
+        }
+    }
+
+    void ProviderCache::setBlockSize(size_t blockSize) {
+        this->clear();
+        this->m_blockSize = std::max<size_t>(blockSize, 1);
+    }
+
+    void ProviderCache::setBudget(size_t budget) {
+        this->m_budget = budget;
+
+        for (auto &shard : this->m_shards) {
+            std::scoped_lock lock(shard.mutex);
+            this->evict(shard, budget / ShardCount);
+        }
+    }
+
+    ProviderCache::Statistics ProviderCache::getStatistics() const {
+        size_t usedBytes = 0;
+        for (auto &shard : this->m_shards) {
+            std::scoped_lock lock(shard.mutex);
+            usedBytes += shard.usedBytes;
+        }
+
+        return { this->m_hits, this->m_misses, this->m_evictions, usedBytes };
+    }
+
+    void ProviderCache::resetStatistics() {
+        this->m_hits      = 0;
+        this->m_misses    = 0;
+        this->m_evictions = 0;
+    }
+
+}
@@ -0,0 +1,348 @@
+#include <hex/providers/snapshot.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    namespace {
+
+        [[nodiscard]] bool isAllZero(const std::vector<u8> &data) {
+            return std::all_of(data.begin(), data.end(), [](u8 byte) { return byte == 0x00; });
+        }
+
+        /**
+         * @brief Reads data from a provider with patches but without overlays applied
+         */
+        void readSourceData(Provider *provider, u64 offset, void *buffer, size_t size) {
+            const u64 address = provider->getBaseAddress() + offset;
+
+            provider->read(address, buffer, size, false);
+            provider->getPatches().apply(address, buffer, size);
+        }
+
+    }
+
+    Snapshot::Snapshot(Provider *provider, const Snapshot *previous, const std::function<void(u64)> &progressCallback)
+        : m_size(provider->getActualSize()), m_baseAddress(provider->getBaseAddress()) {
+
+        // Collect the regions the provider actually has data for so unmapped address space never gets read
+        for (u64 offset = 0; offset < this->m_size;) {
+            auto [region, valid] = provider->getRegionValidity(this->m_baseAddress + offset);
+
+            // Providers without any information about the validity of their data have valid data everywhere
+            if (region.getSize() == 0) {
+                valid  = true;
+                region = { this->m_baseAddress + offset, this->m_size - offset };
+            }
+
+            const u64 size = std::min<u64>(region.getSize(), this->m_size - offset);
+            if (valid) {
+                if (!this->m_validRegions.empty() && this->m_validRegions.back().getEndAddress() + 1 == offset)
+                    this->m_validRegions.back().size += size;
+                else
+                    this->m_validRegions.push_back({ offset, size });
+            }
+
+            offset += size;
+        }
+
+        if (provider->isDataStable()) {
+            this->m_source = provider;
+            provider->attachSnapshot(this);
+        } else {
+            this->capture(provider, previous, progressCallback);
+        }
+    }
+
+    Snapshot::~Snapshot() {
+        if (auto source = this->getSource(); source != nullptr)
+            source->detachSnapshot(this);
+    }
+
+    void Snapshot::capture(Provider *provider, const Snapshot *previous, const std::function<void(u64)> &progressCallback) {
+        // Blocks of an earlier snapshot can only be reused if they cover the exact same range
+        if (previous != nullptr && (previous->getSize() != this->m_size || previous->getBaseAddress() != this->m_baseAddress))
+            previous = nullptr;
+
+        std::vector<u8> data(BlockSize);
+        for (u64 index = 0; const auto &validRegion : this->m_validRegions) {
+            index = std::max(index, validRegion.getStartAddress() / BlockSize);
+
+            for (; index <= validRegion.getEndAddress() / BlockSize; index++) {
+                const u64 blockStart = index * BlockSize;
+                const u64 blockSize  = std::min<u64>(BlockSize, this->m_size - blockStart);
+
+                if (progressCallback)
+                    progressCallback(blockStart);
+
+                // Blocks that are known to be zero don't need to be read at all
+                if (auto [zeroRegion, zero] = provider->getZeroRegion(this->m_baseAddress + blockStart); zero && zeroRegion.getSize() >= blockSize)
+                    continue;
+
+                // Only read the valid parts of the block, everything else reads as zero
+                std::fill(data.begin(), data.end(), 0x00);
+                for (auto it = this->findValidRegion(blockStart); it != this->m_validRegions.end() && it->getStartAddress() < blockStart + blockSize; ++it) {
+                    const u64 start = std::max(it->getStartAddress(), blockStart);
+                    const u64 end   = std::min(it->getEndAddress() + 1, blockStart + blockSize);
+                    readSourceData(provider, start, data.data() + (start - blockStart), end - start);
+                }
+
+                if (isAllZero(data))
+                    continue;
+
+                // Share the block with the previous snapshot if it didn't change since then
+                if (previous != nullptr) {
+                    if (auto it = previous->m_blocks.find(index); it != previous->m_blocks.end() && it->second != nullptr && *it->second == data) {
+                        this->m_blocks.emplace(index, it->second);
+                        continue;
+                    }
+                }
+
+                this->m_blocks.emplace(index, std::make_shared<const std::vector<u8>>(data));
+            }
+        }
+
+        if (progressCallback)
+            progressCallback(this->m_size);
+    }
+
+    Snapshot::Block Snapshot::readBlock(u64 index) const {
+        const u64 blockStart = index * BlockSize;
+
+        auto data = std::make_shared<std::vector<u8>>(BlockSize, 0x00);
+        readSourceData(this->m_source, blockStart, data->data(), std::min<u64>(BlockSize, this->m_size - blockStart));
+
+        if (isAllZero(*data))
+            return nullptr;
+        else
+            return data;
+    }
+
+    std::vector<Region>::const_iterator Snapshot::findValidRegion(u64 offset) const {
+        auto it = std::upper_bound(this->m_validRegions.begin(), this->m_validRegions.end(), offset, [](u64 value, const Region &region) {
+            return value < region.getStartAddress();
+        });
+
+        if (it != this->m_validRegions.begin() && offset <= std::prev(it)->getEndAddress())
+            return std::prev(it);
+
+        return it;
+    }
+
+    void Snapshot::read(u64 offset, void *buffer, size_t size) const {
+        std::scoped_lock lock(this->m_mutex);
+
+        auto bytes = static_cast<u8 *>(buffer);
+        std::memset(bytes, 0x00, size);
+
+        if (offset >= this->m_size)
+            return;
+
+        const u64 endOffset = offset + std::min<u64>(size, this->m_size - offset);
+        for (u64 current = offset; current < endOffset;) {
+            const u64 index = current / BlockSize;
+
+            auto it = this->m_blocks.lower_bound(index);
+            if (it != this->m_blocks.end() && it->first == index) {
+                const u64 blockOffset = current - index * BlockSize;
+                const u64 chunkSize   = std::min<u64>(BlockSize - blockOffset, endOffset - current);
+
+                if (it->second != nullptr)
+                    std::memcpy(bytes + (current - offset), it->second->data() + blockOffset, chunkSize);
+
+                current += chunkSize;
+                continue;
+            }
+
+            // Read all blocks up to the next one held by the snapshot at once
+            u64 chunkEnd = endOffset;
+            if (it != this->m_blocks.end())
+                chunkEnd = std::min(chunkEnd, it->first * BlockSize);
+
+            if (this->m_source != nullptr)
+                readSourceData(this->m_source, current, bytes + (current - offset), chunkEnd - current);
+
+            current = chunkEnd;
+        }
+    }
+
+    Provider *Snapshot::getSource() const {
+        std::scoped_lock lock(this->m_mutex);
+
+        return this->m_source;
+    }
+
+    std::pair<Region, bool> Snapshot::getRegionValidity(u64 offset) const {
+        if (offset >= this->m_size)
+            return { Region::Invalid(), false };
+
+        auto it = this->findValidRegion(offset);
+        if (it != this->m_validRegions.end() && it->getStartAddress() <= offset)
+            return { Region { offset, it->getEndAddress() + 1 - offset }, true };
+
+        const u64 end = it != this->m_validRegions.end() ? it->getStartAddress() : this->m_size;
+        return { Region { offset, end - offset }, false };
+    }
+
+    std::pair<Region, bool> Snapshot::getZeroRegion(u64 offset) const {
+        if (offset >= this->m_size)
+            return { Region::Invalid(), false };
+
+        std::scoped_lock lock(this->m_mutex);
+
+        const u64 index = offset / BlockSize;
+        auto it = this->m_blocks.lower_bound(index);
+
+        const bool held = it != this->m_blocks.end() && it->first == index;
+        const bool zero = held ? it->second == nullptr : this->m_source == nullptr;
+
+        u64 endIndex = index + 1;
+        if (zero) {
+            // Extend the run over all following blocks that only contain zeros as well
+            for (auto next = held ? std::next(it) : it; ; ++next) {
+                const u64 nextIndex = next != this->m_blocks.end() ? next->first : this->getBlockCount();
+
+                // Blocks that aren't held only contain zeros if there's no source to read them from
+                if (nextIndex > endIndex) {
+                    if (this->m_source != nullptr)
+                        break;
+
+                    endIndex = nextIndex;
+                }
+
+                if (next == this->m_blocks.end() || next->second != nullptr)
+                    break;
+
+                endIndex = nextIndex + 1;
+            }
+        }
+
+        return { Region { offset, std::min<u64>(endIndex * BlockSize, this->m_size) - offset }, zero };
+    }
+
+    u64 Snapshot::getSharedSize(const Snapshot &other, u64 offset) const {
+        const u64 size = std::min(this->m_size, other.m_size);
+        if (offset >= size)
+            return 0;
+
+        if (&other == this)
+            return size - offset;
+
+        std::scoped_lock lock(this->m_mutex, other.m_mutex);
+
+        const u64 endIndex = (size + BlockSize - 1) / BlockSize;
+
+        u64 index = offset / BlockSize;
+        auto ours   = this->m_blocks.lower_bound(index);
+        auto theirs = other.m_blocks.lower_bound(index);
+
+        while (index < endIndex) {
+            const bool oursHeld   = ours != this->m_blocks.end() && ours->first == index;
+            const bool theirsHeld = theirs != other.m_blocks.end() && theirs->first == index;
+
+            if (!oursHeld && !theirsHeld) {
+                // Neither snapshot holds the block, so both either read it from the same source or it only contains zeros in both
+                if (this->m_source != other.m_source)
+                    break;
+
+                index = std::min({
+                    endIndex,
+                    ours != this->m_blocks.end() ? ours->first : endIndex,
+                    theirs != other.m_blocks.end() ? theirs->first : endIndex
+                });
+                continue;
+            }
+
+            bool shared;
+            if (oursHeld && theirsHeld)
+                shared = ours->second == theirs->second;
+            else if (oursHeld)
+                shared = ours->second == nullptr && other.m_source == nullptr;
+            else
+                shared = theirs->second == nullptr && this->m_source == nullptr;
+
+            if (!shared)
+                break;
+
+            if (oursHeld)   ++ours;
+            if (theirsHeld) ++theirs;
+            index++;
+        }
+
+        const u64 end = std::min(index * BlockSize, size);
+        return end > offset ? end - offset : 0;
+    }
+
+    u64 Snapshot::getSourceBackedSize(u64 offset) const {
+        if (offset >= this->m_size)
+            return 0;
+
+        std::scoped_lock lock(this->m_mutex);
+
+        if (this->m_source == nullptr)
+            return 0;
+
+        auto it = this->m_blocks.lower_bound(offset / BlockSize);
+        if (it == this->m_blocks.end())
+            return this->m_size - offset;
+        else if (it->first * BlockSize <= offset)
+            return 0;
+        else
+            return std::min(it->first * BlockSize, this->m_size) - offset;
+    }
+
+    u64 Snapshot::getStoredSize() const {
+        std::scoped_lock lock(this->m_mutex);
+
+        return std::count_if(this->m_blocks.begin(), this->m_blocks.end(), [](const auto &entry) { return entry.second != nullptr; }) * BlockSize;
+    }
+
+    void Snapshot::materialize(std::span<Snapshot * const> snapshots, const Region &region) {
+        if (region.getSize() == 0)
+            return;
+
+        // Regions may reach up to the end of the address space, but no snapshot has any blocks past its end
+        u64 blockCount = 0;
+        for (auto snapshot : snapshots)
+            blockCount = std::max(blockCount, snapshot->getBlockCount());
+
+        const u64 endIndex = std::min(blockCount, region.getEndAddress() / BlockSize + 1);
+        for (u64 index = region.getStartAddress() / BlockSize; index < endIndex; index++) {
+            // All snapshots that still need the block get the same copy of it. Snapshots with different sizes can't share
+            // their last block though as the part past their end is zero padded
+            std::vector<std::pair<u64, Block>> readBlocks;
+
+            for (auto snapshot : snapshots) {
+                std::scoped_lock lock(snapshot->m_mutex);
+
+                if (snapshot->m_source == nullptr || index >= snapshot->getBlockCount() || snapshot->m_blocks.contains(index))
+                    continue;
+
+                const u64 blockSize = std::min<u64>(BlockSize, snapshot->m_size - index * BlockSize);
+
+                auto it = std::find_if(readBlocks.begin(), readBlocks.end(), [&](const auto &entry) { return entry.first == blockSize; });
+                if (it == readBlocks.end())
+                    it = readBlocks.insert(readBlocks.end(), { blockSize, snapshot->readBlock(index) });
+
+                snapshot->m_blocks.emplace(index, it->second);
+            }
+        }
+    }
+
+    void Snapshot::detach(std::span<Snapshot * const> snapshots) {
+        u64 size = 0;
+        for (auto snapshot : snapshots)
+            size = std::max(size, snapshot->getSize());
+
+        materialize(snapshots, { 0, size });
+
+        for (auto snapshot : snapshots) {
+            std::scoped_lock lock(snapshot->m_mutex);
+            snapshot->m_source = nullptr;
+        }
+    }
+
+}
@@ -0,0 +1,51 @@
+#include <hex/providers/zero_regions.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+
+namespace hex::prv {
+
+    std::vector<Region> getSearchableRegions(const Provider *provider, Region searchRegion, u64 margin, u64 alignment) {
+        if (searchRegion.getSize() == 0)
+            return { searchRegion };
+
+        alignment = std::max<u64>(alignment, 1);
+
+        std::vector<Region> result;
+        u64 searchStart = searchRegion.getStartAddress();
+        u64 address     = searchRegion.getStartAddress();
+
+        while (true) {
+            auto [zeroRegion, zero] = provider->getZeroRegion(address);
+            if (zeroRegion.getSize() == 0)
+                break;
+
+            const u64 runEnd = std::min(zeroRegion.getEndAddress(), searchRegion.getEndAddress());
+
+            // Small runs aren't worth splitting the search for
+            if (zero && (runEnd - address) + 1 > 2 * margin + alignment) {
+                const u64 skipStart = address + margin;
+
+                // Keep searching on the same grid of aligned addresses after the run
+                u64 resumeAddress = (runEnd + 1) - margin;
+                resumeAddress -= (resumeAddress - searchRegion.getStartAddress()) % alignment;
+
+                if (skipStart > searchStart)
+                    result.push_back(Region { searchStart, skipStart - searchStart });
+                searchStart = resumeAddress;
+            }
+
+            if (runEnd >= searchRegion.getEndAddress())
+                break;
+
+            address = runEnd + 1;
+        }
+
+        if (searchStart <= searchRegion.getEndAddress())
+            result.push_back(Region { searchStart, (searchRegion.getEndAddress() - searchStart) + 1 });
+
+        return result;
+    }
+
+}
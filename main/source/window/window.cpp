@@ -10,7 +10,9 @@
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/fs.hpp>
 #include <hex/helpers/logger.hpp>
+#include <hex/helpers/memory_arena.hpp>
 #include <hex/helpers/stacktrace.hpp>
+#include <hex/providers/io_statistics.hpp>
 
 #include <hex/ui/view.hpp>
 #include <hex/ui/popup.hpp>
@@ -675,6 +677,9 @@ namespace hex {
         for (auto &[name, view] : ContentRegistry::Views::impl::getEntries()) {
             ImGui::GetCurrentContext()->NextWindowData.ClearFlags();
 
+            // Attribute reads done while drawing to the view
+            prv::IoStatistics::CallerScope caller(name);
+
             // Draw always visible views
             view->drawAlwaysVisible();
 
@@ -722,6 +727,9 @@ namespace hex {
     void Window::frameEnd() {
         EventManager::post<EventFrameEnd>();
 
+        // Everything drawn this frame has been submitted, temporary UI allocations aren't needed anymore
+        FrameArena::reset();
+
         // Clean up all tasks that are done
         TaskManager::collectGarbage();
 
@@ -11,6 +11,8 @@
 #include <imgui_internal.h>
 
 #include <hex/helpers/logger.hpp>
+
+#include <algorithm>
 #include <random>
 
 namespace hex {
@@ -149,16 +151,22 @@ namespace hex {
         }
 
         void update(u8 byte) {
+            this->update(byte, 1);
+        }
+
+        // Process the same byte multiple times at once
+        void update(u8 byte, u64 count) {
             // Check if there is some space left
             if (this->m_byteCount < this->m_fileSize) {
-                this->m_buffer[this->m_byteCount] = byte;
-                ++this->m_byteCount;
+                count = std::min<u64>(count, this->m_fileSize - this->m_byteCount);
+                std::fill_n(this->m_buffer.begin() + this->m_byteCount, count, byte);
+                this->m_byteCount += count;
                 if (this->m_byteCount == this->m_fileSize) {
                     this->m_buffer = getSampleSelection(this->m_buffer, this->m_sampleSize);
-                    processImpl();                    
+                    processImpl();
                     this->m_processing = false;
                 }
-            } 
+            }
         }
 
  
@@ -244,16 +252,22 @@ namespace hex {
         }
 
         void update(u8 byte) {
+            this->update(byte, 1);
+        }
+
+        // Process the same byte multiple times at once
+        void update(u8 byte, u64 count) {
             // Check if there is some space left
             if (this->m_byteCount < this->m_fileSize) {
-                this->m_buffer[this->m_byteCount] = byte;
-                ++this->m_byteCount;
+                count = std::min<u64>(count, this->m_fileSize - this->m_byteCount);
+                std::fill_n(this->m_buffer.begin() + this->m_byteCount, count, byte);
+                this->m_byteCount += count;
                 if (this->m_byteCount == this->m_fileSize) {
                     this->m_buffer = getSampleSelection(this->m_buffer, this->m_sampleSize);
-                    processImpl();                    
+                    processImpl();
                     this->m_processing = false;
                 }
-            } 
+            }
         }
 
     private:
@@ -402,26 +416,34 @@ namespace hex {
 
         // Process one byte at the time
         void update(u8 byte) {
+            this->update(byte, 1);
+        }
+
+        // Process the same byte multiple times at once
+        void update(u8 byte, u64 count) {
             u64 totalBlock = std::ceil((this->m_endAddress - this->m_startAddress) / this->m_chunkSize);
 
-            // Check if there is still some 
-            if (this->m_blockCount < totalBlock) {
-                // Increment the occurrence of the current byte
-                this->m_blockValueCounts[byte]++;
+            // Add the bytes chunk by chunk so every chunk still gets its own entropy value
+            while (count > 0 && this->m_blockCount < totalBlock) {
+                const u64 chunkRemaining = std::min<u64>(this->m_chunkSize - (this->m_byteCount % this->m_chunkSize), (this->m_endAddress - this->m_startAddress) - this->m_byteCount);
+                const u64 processed      = std::min<u64>(count, chunkRemaining);
+                if (processed == 0)
+                    break;
 
-                this->m_byteCount++;
-                // Check if we processed one complete chunk, if so compute the entropy and start analysing the next chunk
-                if (((this->m_byteCount % this->m_chunkSize) == 0) || this->m_byteCount == (this->m_endAddress - this->m_startAddress)) [[unlikely]] {
+                this->m_blockValueCounts[byte] += processed;
+                this->m_byteCount += processed;
+                count -= processed;
+
+                if (((this->m_byteCount % this->m_chunkSize) == 0) || this->m_byteCount == (this->m_endAddress - this->m_startAddress)) {
                     this->m_yBlockEntropy.push_back(calculateEntropy(this->m_blockValueCounts, this->m_chunkSize));
 
                     this->m_blockCount += 1;
                     this->m_blockValueCounts = { 0 };
                 }
-               
-                // Check if we processed the last block, if so setup the X axis part of the data
+
                 if (this->m_blockCount == totalBlock) {
                     processFinalize();
-                    this->m_processing = false;           
+                    this->m_processing = false;
                 }
             }
         }
@@ -647,9 +669,14 @@ namespace hex {
 
     // Process one byte at the time
     void update(u8 byte) {
+        this->update(byte, 1);
+    }
+
+    // Process the same byte multiple times at once
+    void update(u8 byte, u64 count) {
         this->m_processing = true;
-        this->m_valueCounts[byte]++;
-        this->m_processing = false;           
+        this->m_valueCounts[byte] += count;
+        this->m_processing = false;
     }
 
     // Return byte distribution array in it's current state 
@@ -791,14 +818,25 @@ namespace hex {
 
         // Process one byte at the time
         void update(u8 byte) {
+            this->update(byte, 1);
+        }
+
+        // Process the same byte multiple times at once
+        void update(u8 byte, u64 count) {
             u64 totalBlock = std::ceil((this->m_endAddress - this->m_startAddress) / this->m_blockSize);
-            // Check if there is still some block to process 
-            if (this->m_blockCount < totalBlock) {
 
-                this->m_blockValueCounts[byte]++;
+            // Add the bytes block by block so every block still gets its own distribution
+            while (count > 0 && this->m_blockCount < totalBlock) {
+                const u64 blockRemaining = std::min<u64>(this->m_blockSize - (this->m_byteCount % this->m_blockSize), (this->m_endAddress - this->m_startAddress) - this->m_byteCount);
+                const u64 processed      = std::min<u64>(count, blockRemaining);
+                if (processed == 0)
+                    break;
 
-                this->m_byteCount++;
-                if (((this->m_byteCount % this->m_blockSize) == 0) || this->m_byteCount == (this->m_endAddress - this->m_startAddress)) [[unlikely]] {
+                this->m_blockValueCounts[byte] += processed;
+                this->m_byteCount += processed;
+                count -= processed;
+
+                if (((this->m_byteCount % this->m_blockSize) == 0) || this->m_byteCount == (this->m_endAddress - this->m_startAddress)) {
                     auto typeDist = calculateTypeDistribution(this->m_blockValueCounts, this->m_blockSize);
                     for (size_t i = 0; i < typeDist.size(); i++)
                         this->m_yBlockTypeDistributions[i].push_back(typeDist[i] * 100);
@@ -806,12 +844,10 @@ namespace hex {
                     this->m_blockCount += 1;
                     this->m_blockValueCounts = { 0 };
                 }
-                
-                // Check if we processed the last block, if so setup the X axis part of the data
-                if (this->m_blockCount == totalBlock) {
 
+                if (this->m_blockCount == totalBlock) {
                     processFinalize();
-                    this->m_processing = false;           
+                    this->m_processing = false;
                 }
             }
         }
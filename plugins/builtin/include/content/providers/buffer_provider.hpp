@@ -0,0 +1,61 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include <cstring>
+#include <span>
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Read-only provider exposing memory owned by somebody else without copying it
+     *
+     * The owner of the memory has to keep it alive and unchanged for as long as the provider exists
+     */
+    class BufferProvider : public hex::prv::Provider {
+    public:
+        explicit BufferProvider(std::span<const u8> data) : m_data(data) { }
+        ~BufferProvider() override = default;
+
+        [[nodiscard]] bool isAvailable() const override { return true; }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return false; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+        [[nodiscard]] bool isDataStable() const override { return true; }
+
+        [[nodiscard]] bool open() override { return true; }
+        void close() override { }
+
+        [[nodiscard]] std::optional<std::span<const u8>> tryGetSpan(u64 offset, size_t size) override {
+            offset -= this->getBaseAddress();
+            if (size == 0 || size > this->m_data.size() || offset > this->m_data.size() - size || !this->isUnmodified(offset + this->getBaseAddress(), size))
+                return std::nullopt;
+
+            return this->m_data.subspan(offset, size);
+        }
+
+        void readRaw(u64 offset, void *buffer, size_t size) override {
+            if (size > this->m_data.size() || offset > this->m_data.size() - size || buffer == nullptr || size == 0)
+                return;
+
+            std::memcpy(buffer, this->m_data.data() + offset, size);
+        }
+        void writeRaw(u64 offset, const void *buffer, size_t size) override { hex::unused(offset, buffer, size); }
+        [[nodiscard]] size_t getActualSize() const override { return this->m_data.size(); }
+
+        [[nodiscard]] std::string getName() const override { return "Buffer"; }
+        [[nodiscard]] std::vector<Description> getDataDescription() const override { return { }; }
+
+        void loadSettings(const nlohmann::json &settings) override { hex::unused(settings); }
+        [[nodiscard]] nlohmann::json storeSettings(nlohmann::json settings) const override { return settings; }
+
+        [[nodiscard]] std::string getTypeName() const override {
+            return "hex.builtin.provider.buffer";
+        }
+
+    private:
+        std::span<const u8> m_data;
+    };
+
+}
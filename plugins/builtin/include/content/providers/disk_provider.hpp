@@ -1,8 +1,14 @@
 #pragma once
 
 #include <hex/providers/provider.hpp>
+#include <hex/providers/provider_cache.hpp>
+#include <hex/providers/io_ring.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -24,10 +30,15 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isResizable() const override;
         [[nodiscard]] bool isSavable() const override;
 
+        void readv(std::span<const ReadRequest> requests, bool overlays) override;
+
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] size_t getActualSize() const override;
 
+        [[nodiscard]] bool isDataAvailable(u64 offset, size_t size) const override;
+        void prefetch(const Region &region) override;
+
         void setPath(const std::fs::path &path);
 
         [[nodiscard]] bool open() override;
@@ -52,6 +63,12 @@ namespace hex::plugin::builtin {
     protected:
         void reloadDrives();
 
+        void readSectors(u64 offset, void *buffer, size_t size);
+        bool readAlignedSectors(u64 offset, u8 *buffer, size_t size);
+        void writeSectors(u64 offset, const void *buffer, size_t size);
+        void readUncached(u64 offset, void *buffer, size_t size);
+        void readUncached(std::span<const prv::ProviderCache::ReadRequest> requests);
+
         std::set<std::string> m_availableDrives;
         std::fs::path m_path;
 
@@ -65,9 +82,19 @@ namespace hex::plugin::builtin {
         size_t m_diskSize   = 0;
         size_t m_sectorSize = 0;
 
-        u64 m_sectorBufferAddress = 0;
+        // Bounce buffer for sectors that are only partially requested
         std::vector<u8> m_sectorBuffer;
 
+        // Guards the disk handle and the sector buffer. Reads can come from the prefetch thread of the cache as well
+        std::mutex m_diskMutex;
+        prv::ProviderCache m_cache;
+
+        // Only set if the system supports keeping multiple reads in flight
+        std::unique_ptr<prv::IoRing> m_ioRing;
+
+        size_t m_readAheadSize = 0;
+        std::atomic<u64> m_lastReadEnd = 0;
+
         bool m_readable = false;
         bool m_writable = false;
     };
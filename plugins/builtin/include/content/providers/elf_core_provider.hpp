@@ -0,0 +1,97 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+#include <hex/ui/widgets.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <wolv/io/file.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Provider exposing the address space of a process stored in an ELF core dump
+     *
+     * Addresses are the virtual addresses of the dumped process. The PT_LOAD segments are read directly from a mapping of the
+     * file so only the pages that are actually accessed get loaded. Parts of segments without any data in the file read as
+     * zero and addresses that aren't covered by any segment are reported as invalid
+     */
+    class ElfCoreProvider : public hex::prv::Provider {
+    public:
+        /**
+         * @brief PT_LOAD segment of the core dump
+         */
+        struct Segment {
+            u64 address;
+            u64 memorySize;
+            u64 fileOffset;
+            u64 fileSize;
+            u32 flags;
+        };
+
+        ElfCoreProvider() = default;
+        ~ElfCoreProvider() override = default;
+
+        [[nodiscard]] bool isAvailable() const override { return !this->m_segments.empty(); }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return false; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+        [[nodiscard]] bool isDumpable() const override { return false; }
+
+        [[nodiscard]] std::optional<std::span<const u8>> tryGetSpan(u64 offset, size_t size) override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        [[nodiscard]] size_t getActualSize() const override;
+
+        bool open() override;
+        void close() override;
+
+        [[nodiscard]] std::string getName() const override;
+        [[nodiscard]] std::vector<Description> getDataDescription() const override;
+
+        void loadSettings(const nlohmann::json &settings) override;
+        [[nodiscard]] nlohmann::json storeSettings(nlohmann::json settings) const override;
+
+        [[nodiscard]] std::string getTypeName() const override {
+            return "hex.builtin.provider.elf_core";
+        }
+
+        [[nodiscard]] bool hasFilePicker() const override { return true; }
+        [[nodiscard]] bool handleFilePicker() override;
+
+        [[nodiscard]] bool hasInterface() const override { return true; }
+        void drawInterface() override;
+
+        [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override;
+        [[nodiscard]] std::pair<Region, bool> getZeroRegion(u64 address) const override;
+
+    private:
+        /**
+         * @brief Finds the segment containing an address or, if there's none, the first one after it
+         */
+        [[nodiscard]] std::vector<Segment>::const_iterator findSegment(u64 address) const;
+
+        /**
+         * @brief Reads bytes from the file. Only used if the file couldn't be mapped
+         */
+        void readFile(u64 offset, void *buffer, size_t size);
+
+        std::fs::path m_path;
+        wolv::io::File m_file;
+        std::mutex m_fileMutex;
+
+        // Sorted by address without any overlaps
+        std::vector<Segment> m_segments;
+        u64 m_fileSize = 0;
+
+        ui::SearchableWidget<Segment> m_segmentSearchWidget = ui::SearchableWidget<Segment>([](const std::string &search, const Segment &segment) {
+            return hex::containsIgnoreCase(hex::format("0x{:016X}", segment.address), search);
+        });
+    };
+
+}
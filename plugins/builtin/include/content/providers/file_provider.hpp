@@ -1,18 +1,37 @@
 #pragma once
 
 #include <hex/providers/provider.hpp>
+#include <hex/providers/piece_table.hpp>
+#include <hex/providers/provider_cache.hpp>
+#include <hex/providers/io_ring.hpp>
+#include <hex/api/task.hpp>
 
 #include <wolv/io/file.hpp>
 
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string_view>
 
 namespace hex::plugin::builtin {
 
     class FileProvider : public hex::prv::Provider {
     public:
+        enum class AccessMode {
+            /**
+             * @brief The whole file is mapped into memory and accessed through the mapping
+             */
+            Mapped,
+
+            /**
+             * @brief The file is read with direct I/O through a bounded cache, bypassing the page cache of the system
+             */
+            DirectIO
+        };
+
         FileProvider() = default;
-        ~FileProvider() override = default;
+        ~FileProvider() override;
 
         [[nodiscard]] bool isAvailable() const override;
         [[nodiscard]] bool isReadable() const override;
@@ -22,11 +41,15 @@ namespace hex::plugin::builtin {
 
         void read(u64 offset, void *buffer, size_t size, bool overlays) override;
         void write(u64 offset, const void *buffer, size_t size) override;
+        [[nodiscard]] PreparedFill prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback = { }) override;
+        void fill(const PreparedFill &fill) override;
 
         void resize(size_t newSize) override;
         void insert(u64 offset, size_t size) override;
         void remove(u64 offset, size_t size) override;
 
+        [[nodiscard]] std::optional<std::span<const u8>> tryGetSpan(u64 offset, size_t size) override;
+
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
 
@@ -42,12 +65,16 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool hasFilePicker() const override { return true; }
         [[nodiscard]] bool handleFilePicker() override;
 
+        [[nodiscard]] bool hasInterface() const override { return true; }
+        void drawInterface() override;
+
         std::vector<MenuEntry> getMenuEntries() override;
 
         void setPath(const std::fs::path &path);
 
         [[nodiscard]] bool open() override;
         void close() override;
+        void releaseResources() override;
 
         void loadSettings(const nlohmann::json &settings) override;
         [[nodiscard]] nlohmann::json storeSettings(nlohmann::json settings) const override;
@@ -57,17 +84,86 @@ namespace hex::plugin::builtin {
         }
 
         [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override;
+        [[nodiscard]] std::pair<Region, bool> getZeroRegion(u64 address) const override;
 
     private:
         void convertToMemoryFile();
 
+        /**
+         * @brief Finds all holes of a sparse file so they can be skipped instead of being read
+         */
+        void loadHoles();
+
+        /**
+         * @brief Writes the data with all inserted and removed bytes to a new file in the background and replaces the original file with it once done
+         */
+        void rewriteFile();
+        void finishRewrite(const std::fs::path &tempPath, u64 editGeneration);
+
+        /**
+         * @brief Opens the file again after it was closed to replace it. Tells the user if that failed
+         */
+        bool reopen();
+
+        /**
+         * @brief Accesses the file directly instead of through its mapping. Used if the file couldn't be mapped
+         */
+        void readFile(u64 offset, void *buffer, size_t size);
+        void writeFile(u64 offset, const void *buffer, size_t size);
+
+        /**
+         * @brief Reads from the file opened for direct I/O. The range gets extended to aligned offsets and read through an aligned buffer
+         */
+        void readDirect(u64 offset, void *buffer, size_t size);
+        size_t readDirectAligned(u64 offset, u8 *buffer, size_t size);
+
+        void openDirect();
+
+        /**
+         * @brief Makes sure the file is mapped or opened before its data gets accessed
+         * @return lock that keeps the file from being released while it's being accessed
+         */
+        [[nodiscard]] std::shared_lock<std::shared_mutex> acquireFile();
+
+        /**
+         * @brief Maps or opens the file for the configured access mode. Called on first access instead of when the provider gets opened
+         */
+        void loadFile();
+        void unloadFile();
+
     protected:
         std::fs::path m_path;
         wolv::io::File m_file;
-        size_t m_fileSize = 0;
+
+        /**
+         * @brief Inserted and removed bytes that haven't been written to the file yet
+         */
+        prv::PieceTable m_pieceTable;
+
+        /**
+         * @brief Holes in the file, mapping their start offset to their end offset. Only available on systems supporting SEEK_HOLE
+         */
+        std::map<u64, u64> m_holes;
+        u64 m_editGeneration = 0;
+        TaskHolder m_rewriteTask;
+
+        AccessMode m_accessMode = AccessMode::Mapped;
+        u32 m_ioQueueDepth = 8;
+
+        // Used instead of the mapping in direct I/O mode and for files that can't be mapped
+        std::mutex m_fileMutex;
+        prv::ProviderCache m_cache;
+        std::unique_ptr<prv::IoRing> m_ioRing;
+
+        int m_directFd = -1;
+        std::vector<u8> m_directBuffer;
 
         std::optional<struct stat> m_fileStats;
 
+        // Held shared while the file gets accessed and exclusively while it gets loaded or released
+        std::shared_mutex m_loadMutex;
+        bool m_fileLoaded = false;
+
         bool m_readable = false, m_writable = false;
     };
 
@@ -2,12 +2,18 @@
 
 #include <hex/providers/provider.hpp>
 
-#include <wolv/net/socket_client.hpp>
+#include <hex/helpers/gdb.hpp>
 
 #include <array>
+#include <chrono>
+#include <deque>
+#include <list>
 #include <mutex>
+#include <span>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace hex::plugin::builtin {
 
@@ -23,12 +29,16 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isSavable() const override;
 
         void read(u64 offset, void *buffer, size_t size, bool overlays) override;
+        void readv(std::span<const ReadRequest> requests, bool overlays) override;
         void write(u64 offset, const void *buffer, size_t size) override;
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] size_t getActualSize() const override;
 
+        [[nodiscard]] bool isDataAvailable(u64 offset, size_t size) const override;
+        void prefetch(const Region &region) override;
+
         void save() override;
 
         [[nodiscard]] std::string getName() const override;
@@ -53,7 +63,7 @@ namespace hex::plugin::builtin {
         std::variant<std::string, i128> queryInformation(const std::string &category, const std::string &argument) override;
 
     protected:
-        wolv::net::SocketClient m_socket;
+        gdb::Client m_client;
 
         std::string m_ipAddress;
         int m_port = 0;
@@ -61,18 +71,55 @@ namespace hex::plugin::builtin {
         u64 m_size = 0;
 
         constexpr static size_t CacheLineSize = 0x10;
+        constexpr static size_t MaxCacheLines = 0x1000;
 
         struct CacheLine {
             u64 address;
 
             std::array<u8, CacheLineSize> data;
+
+            // Lines that were read recently are the ones currently visible and get refreshed periodically
+            std::chrono::steady_clock::time_point lastAccess;
         };
 
+        /**
+         * @brief Finds a cached line and marks it as most recently used
+         * @return Pointer to the line or nullptr if it's not cached
+         */
+        CacheLine *useCacheLine(u64 alignedOffset);
+
+        void requestCacheLine(u64 alignedOffset);
+        void storeCacheLines(u64 alignedOffset, const std::vector<u8> &data);
+        void invalidateCacheLines(u64 offset, size_t size);
+
+        /**
+         * @brief Merges a list of lines into ranges that can each be read with a single packet. Small gaps between lines are read as well
+         */
+        [[nodiscard]] std::vector<gdb::Client::MemoryRange> mergeCacheLines(std::vector<u64> addresses) const;
+
+        /**
+         * @brief Reads a list of lines from the target, merging neighbouring lines into as few packets as possible
+         */
+        void loadCacheLines(std::vector<u64> addresses);
+
+        std::vector<u8> readMemory(u64 address, size_t size);
+        std::vector<std::vector<u8>> readMemory(std::span<const gdb::Client::MemoryRange> ranges);
+        void writeMemory(u64 address, const void *buffer, size_t size);
+
+        // Cache lines ordered from most to least recently used, plus an index to find them by address
         std::list<CacheLine> m_cache;
+        std::unordered_map<u64, std::list<CacheLine>::iterator> m_cacheLookup;
         std::atomic<bool> m_resetCache = false;
 
+        // Lines that were requested but aren't cached yet. Loaded by the cache update thread before refreshing existing lines
+        std::deque<u64> m_pendingCacheLines;
+        std::unordered_set<u64> m_pendingCacheLineLookup;
+
         std::thread m_cacheUpdateThread;
-        std::mutex m_cacheLock;
+        mutable std::mutex m_cacheLock;
+
+        // The connection can only be used for one request at a time
+        std::mutex m_socketLock;
     };
 
 }
\ No newline at end of file
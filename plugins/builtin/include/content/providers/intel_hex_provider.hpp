@@ -1,13 +1,24 @@
 #pragma once
 
+#include <hex/api/task.hpp>
 #include <hex/providers/provider.hpp>
 
-#include <wolv/container/interval_tree.hpp>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace hex::plugin::builtin {
 
     class IntelHexProvider : public hex::prv::Provider {
     public:
+        /**
+         * @brief Contiguous run of bytes made up of one or more records
+         */
+        struct Chunk {
+            u64 address;
+            std::vector<u8> data;
+        };
+
         IntelHexProvider() = default;
         ~IntelHexProvider() override = default;
 
@@ -17,8 +28,6 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isResizable() const override { return false; }
         [[nodiscard]] bool isSavable() const override { return false; }
 
-        void setBaseAddress(u64 address) override;
-
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] size_t getActualSize() const override;
@@ -42,9 +51,30 @@ namespace hex::plugin::builtin {
         std::pair<Region, bool> getRegionValidity(u64 address) const override;
 
     protected:
+        /**
+         * @brief Sorts chunks by address and merges the ones that overlap or touch each other
+         * @param chunks Chunks in the order their records appeared in the file. Where chunks overlap, later ones win
+         * @return Sorted chunks without any overlaps
+         */
+        [[nodiscard]] static std::vector<Chunk> mergeChunks(std::vector<Chunk> chunks);
+
+        /**
+         * @brief Replaces the data of the provider
+         * @param chunks Sorted chunks without any overlaps
+         */
+        void setChunks(std::vector<Chunk> chunks);
+
         bool m_dataValid = false;
-        size_t m_dataSize = 0x00;
-        wolv::container::IntervalTree<std::vector<u8>, u64> m_data;
+        std::atomic<size_t> m_dataSize = 0x00;
+
+        // Sorted by address so the chunks containing a range can be found with a binary search
+        std::vector<Chunk> m_chunks;
+        mutable std::mutex m_chunkMutex;
+
+        TaskHolder m_loadingTask;
+
+        // Changes whenever the provider gets opened or closed so a loading task can tell if its results are still wanted
+        u32 m_loadGeneration = 0;
 
         std::fs::path m_sourceFilePath;
     };
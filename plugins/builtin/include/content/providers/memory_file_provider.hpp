@@ -1,6 +1,7 @@
 #pragma once
 
 #include <hex/providers/provider.hpp>
+#include <hex/providers/gap_buffer.hpp>
 #include <hex/api/localization.hpp>
 
 namespace hex::plugin::builtin {
@@ -15,13 +16,16 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isWritable()  const override { return !this->m_readOnly; }
         [[nodiscard]] bool isResizable() const override { return !this->m_readOnly; }
         [[nodiscard]] bool isSavable()   const override { return this->m_name.empty(); }
+        [[nodiscard]] bool isDataStable() const override { return true; }
 
         [[nodiscard]] bool open() override;
         void close() override { }
 
+        [[nodiscard]] std::optional<std::span<const u8>> tryGetSpan(u64 offset, size_t size) override;
+
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
-        [[nodiscard]] size_t getActualSize() const override { return this->m_data.size(); }
+        [[nodiscard]] size_t getActualSize() const override { return this->m_data.getSize(); }
 
         void resize(size_t newSize) override;
         void insert(u64 offset, size_t size) override;
@@ -49,7 +53,8 @@ namespace hex::plugin::builtin {
         void renameFile();
 
     private:
-        std::vector<u8> m_data;
+        // Edits usually happen close to each other, which only ever moves the bytes between them
+        prv::GapBuffer m_data;
         std::string m_name;
         bool m_readOnly = false;
     };
@@ -0,0 +1,142 @@
+#pragma once
+
+#if defined(OS_LINUX)
+
+#include <hex/providers/provider.hpp>
+#include <hex/api/localization.hpp>
+
+#include <hex/ui/widgets.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Provider giving access to the memory of another process
+     *
+     * The mapped regions are taken from /proc/<pid>/maps. Reads go through process_vm_readv, which can read many ranges
+     * with a single system call, and fall back to /proc/<pid>/mem for pages it can't access
+     */
+    class ProcessMemoryProvider : public hex::prv::Provider {
+    public:
+        ProcessMemoryProvider() = default;
+        ~ProcessMemoryProvider() override = default;
+
+        [[nodiscard]] bool isAvailable() const override { return this->m_memoryFd != -1; }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return this->m_writable; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+        [[nodiscard]] bool isDumpable() const override { return false; }
+
+        void read(u64 address, void *buffer, size_t size, bool) override {
+            prv::IoStatistics::ReadScope readScope(this, address, size);
+
+            this->readRaw(address, buffer, size);
+        }
+        void write(u64 address, const void *buffer, size_t size) override { this->writeRaw(address, buffer, size); }
+        void readv(std::span<const ReadRequest> requests, bool overlays) override;
+
+        void readRaw(u64 address, void *buffer, size_t size) override;
+        void writeRaw(u64 address, const void *buffer, size_t size) override;
+        [[nodiscard]] size_t getActualSize() const override { return 0xFFFF'FFFF'FFFF; }
+
+        void save() override {}
+
+        [[nodiscard]] std::string getName() const override { return hex::format("hex.builtin.provider.process_memory.name"_lang, this->m_selectedProcess != nullptr ? this->m_selectedProcess->name : ""); }
+        [[nodiscard]] std::vector<Description> getDataDescription() const override {
+            return {
+                    { "hex.builtin.provider.process_memory.process_name"_lang, this->m_selectedProcess->name },
+                    { "hex.builtin.provider.process_memory.process_id"_lang, std::to_string(this->m_selectedProcess->id) }
+            };
+        }
+
+        [[nodiscard]] bool open() override;
+        void close() override;
+
+        [[nodiscard]] bool hasLoadInterface() const override { return true; }
+        [[nodiscard]] bool hasInterface() const override { return true; }
+        bool drawLoadInterface() override;
+        void drawInterface() override;
+
+        void loadSettings(const nlohmann::json &) override {}
+        [[nodiscard]] nlohmann::json storeSettings(nlohmann::json) const override { return { }; }
+
+        [[nodiscard]] std::string getTypeName() const override {
+            return "hex.builtin.provider.process_memory";
+        }
+
+        [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override;
+        [[nodiscard]] std::pair<Region, bool> getZeroRegion(u64 address) const override;
+        std::variant<std::string, i128> queryInformation(const std::string &category, const std::string &argument) override;
+
+    private:
+        void reloadMemoryRegions();
+
+        /**
+         * @brief Part of a read that lies within a readable region
+         */
+        struct Transfer {
+            u64 address;
+            u8 *buffer;
+            size_t size;
+        };
+
+        /**
+         * @brief Splits a read up into the parts that lie within readable regions and zero fills the rest of the buffer
+         */
+        void collectTransfers(u64 address, u8 *buffer, size_t size, std::vector<Transfer> &transfers) const;
+
+        /**
+         * @brief Reads all transfers with as few system calls as possible
+         */
+        void readTransfers(std::span<const Transfer> transfers);
+
+    private:
+        struct Process {
+            pid_t id;
+            std::string name;
+        };
+
+        struct MemoryRegion {
+            Region region;
+            std::string name;
+            bool readable;
+        };
+
+        std::vector<Process> m_processes;
+        const Process *m_selectedProcess = nullptr;
+
+        // All mappings of the process as listed in its maps file
+        std::vector<MemoryRegion> m_memoryRegions;
+
+        // Sorted readable address ranges with neighbouring mappings merged together, used to find the parts of reads that can be read
+        std::vector<Region> m_readableRegions;
+        mutable std::mutex m_regionMutex;
+
+        ui::SearchableWidget<Process> m_processSearchWidget = ui::SearchableWidget<Process>([](const std::string &search, const Process &process) {
+            return hex::containsIgnoreCase(process.name, search) || std::to_string(process.id).starts_with(search);
+        });
+        ui::SearchableWidget<MemoryRegion> m_regionSearchWidget = ui::SearchableWidget<MemoryRegion>([](const std::string &search, const MemoryRegion &memoryRegion) {
+            return hex::containsIgnoreCase(memoryRegion.name, search);
+        });
+
+        int m_memoryFd = -1;
+        bool m_writable = false;
+
+        // Turned off if the system doesn't allow process_vm_readv, e.g. because of a seccomp filter
+        std::atomic<bool> m_vmReadvSupported = true;
+
+        bool m_enumerationFailed = false;
+    };
+
+}
+
+#endif
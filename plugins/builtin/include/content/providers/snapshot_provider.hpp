@@ -0,0 +1,74 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+#include <hex/providers/snapshot.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Read-only provider showing the state another provider was in at the time a snapshot of it was taken
+     *
+     * Snapshots of the same provider share all blocks that didn't change in between, so the diff view can skip over them
+     * without comparing their bytes
+     */
+    class SnapshotProvider : public hex::prv::Provider {
+    public:
+        SnapshotProvider() = default;
+        ~SnapshotProvider() override = default;
+
+        [[nodiscard]] bool isAvailable() const override { return this->m_snapshot != nullptr; }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return false; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        [[nodiscard]] size_t getActualSize() const override;
+
+        bool open() override;
+        void close() override { }
+
+        [[nodiscard]] std::string getName() const override;
+        [[nodiscard]] std::vector<Description> getDataDescription() const override;
+
+        void loadSettings(const nlohmann::json &settings) override { hex::unused(settings); }
+        [[nodiscard]] nlohmann::json storeSettings(nlohmann::json settings) const override { return settings; }
+
+        [[nodiscard]] std::string getTypeName() const override {
+            return "hex.builtin.provider.snapshot";
+        }
+
+        [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override;
+        [[nodiscard]] std::pair<Region, bool> getZeroRegion(u64 address) const override;
+
+        /**
+         * @brief Sets the snapshot to show
+         * @param snapshot Snapshot of the source provider
+         * @param sourceName Name of the provider the snapshot was taken of
+         * @param sourceId ID of the provider the snapshot was taken of
+         * @param number Number of the snapshot among all snapshots taken of the source provider
+         */
+        void setSnapshot(std::shared_ptr<prv::Snapshot> snapshot, std::string sourceName, u32 sourceId, u32 number);
+        [[nodiscard]] const std::shared_ptr<prv::Snapshot> &getSnapshot() const { return this->m_snapshot; }
+
+        /**
+         * @brief Gets the ID of the provider the snapshot was taken of. Stays valid after that provider got closed
+         */
+        [[nodiscard]] u32 getSourceID() const { return this->m_sourceId; }
+        [[nodiscard]] u32 getNumber() const { return this->m_number; }
+
+    private:
+        std::shared_ptr<prv::Snapshot> m_snapshot;
+
+        std::string m_sourceName;
+        u32 m_sourceId = 0;
+        u32 m_number = 0;
+        std::chrono::system_clock::time_point m_creationTime;
+    };
+
+}
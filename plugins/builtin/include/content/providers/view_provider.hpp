@@ -7,6 +7,13 @@
 
 namespace hex::plugin::builtin {
 
+    /**
+     * @brief Provider exposing a window of another provider without copying its data
+     *
+     * Reads are forwarded to the parent provider, including its patches. Changes made through the view are kept as patches
+     * of the view itself until it gets saved, at which point they're written to the parent. The view closes itself once
+     * the parent gets closed
+     */
     class ViewProvider : public hex::prv::Provider {
     public:
         explicit ViewProvider() {
@@ -39,52 +46,35 @@ namespace hex::plugin::builtin {
         }
         [[nodiscard]] bool isResizable() const override { return true; }
 
-        [[nodiscard]] bool isSavable() const override { 
+        [[nodiscard]] bool isSavable() const override {
             if (this->m_provider == nullptr)
                 return false;
             else
-                return this->m_provider->isSavable();
+                return this->m_provider->isSavable() || !this->getPatches().empty();
         }
 
-        void save() override {
-            this->m_provider->save();
-        }
+        void save() override;
 
         [[nodiscard]] bool open() override { return true; }
         void close() override { }
 
+        void write(u64 offset, const void *buffer, size_t size) override;
+        [[nodiscard]] PreparedFill prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback = { }) override;
+        void fill(const PreparedFill &fill) override;
+
         void resize(size_t newSize) override {
             this->m_size = newSize;
         }
-        void insert(u64 offset, size_t size) override {
-            if (this->m_provider == nullptr)
-                return;
-
-            this->m_size += size;
-            this->m_provider->insert(offset + this->m_startAddress, size);
-        }
+        void insert(u64 offset, size_t size) override;
+        void remove(u64 offset, size_t size) override;
 
-        void remove(u64 offset, size_t size) override {
-            if (this->m_provider == nullptr)
-                return;
+        void readv(std::span<const ReadRequest> requests, bool overlays) override;
+        [[nodiscard]] std::optional<std::span<const u8>> tryGetSpan(u64 offset, size_t size) override;
+        [[nodiscard]] bool isDataAvailable(u64 offset, size_t size) const override;
+        void prefetch(const Region &region) override;
 
-            this->m_size -= size;
-            this->m_provider->remove(offset + this->m_startAddress, size);
-        }
-
-        void readRaw(u64 offset, void *buffer, size_t size) override {
-            if (this->m_provider == nullptr)
-                return;
-
-            this->m_provider->read(offset + this->m_startAddress, buffer, size);
-        }
-
-        void writeRaw(u64 offset, const void *buffer, size_t size) override {
-            if (this->m_provider == nullptr)
-                return;
-
-            this->m_provider->write(offset + this->m_startAddress, buffer, size);
-        }
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
 
         [[nodiscard]] size_t getActualSize() const override { return this->m_size; }
 
@@ -108,19 +98,35 @@ namespace hex::plugin::builtin {
             return "hex.builtin.provider.view";
         }
 
+        /**
+         * @brief Sets the window of the parent provider to show
+         * @param startAddress Address in the parent provider the view starts at
+         * @param size Size of the view
+         * @param provider Parent provider
+         */
         void setProvider(u64 startAddress, size_t size, hex::prv::Provider *provider) {
             this->m_startAddress = startAddress;
             this->m_size = size;
             this->m_provider = provider;
         }
 
-        [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override {
-            address -= this->getBaseAddress();
+        [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override;
+        [[nodiscard]] std::pair<Region, bool> getZeroRegion(u64 address) const override;
 
-            if (address < this->getActualSize())
-                return { Region { this->getBaseAddress() + address, this->getActualSize() - address }, true };
-            else
-                return { Region::Invalid(), false };
+    private:
+        /**
+         * @brief Converts an address of the view to the address of the same byte in the parent provider
+         */
+        [[nodiscard]] u64 toParentAddress(u64 address) const {
+            return (address - this->getBaseAddress()) + this->m_startAddress;
+        }
+
+        /**
+         * @brief Checks if a range lies completely inside the view
+         * @param offset Offset relative to the start of the view
+         */
+        [[nodiscard]] bool isInside(u64 offset, size_t size) const {
+            return size <= this->m_size && offset <= this->m_size - size;
         }
 
     private:
@@ -129,4 +135,4 @@ namespace hex::plugin::builtin {
         prv::Provider *m_provider = nullptr;
     };
 
-}
\ No newline at end of file
+}
@@ -108,11 +108,27 @@ namespace hex::plugin::builtin {
         std::string m_replaceBuffer;
 
     private:
-        static std::vector<Occurrence> searchStrings(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Strings &settings);
-        static std::vector<Occurrence> searchSequence(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Sequence &settings);
-        static std::vector<Occurrence> searchRegex(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Regex &settings);
-        static std::vector<Occurrence> searchBinaryPattern(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::BinaryPattern &settings);
-        static std::vector<Occurrence> searchValue(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Value &settings);
+        /**
+         * @brief Search functions for a single region of the whole search
+         * @param progressOffset Number of bytes of the whole search that come before the region, so the progress keeps growing from one region to the next
+         */
+        static std::vector<Occurrence> searchStrings(Task &task, prv::Provider *provider, Region searchRegion, u64 progressOffset, const SearchSettings::Strings &settings);
+        static std::vector<Occurrence> searchSequence(Task &task, prv::Provider *provider, Region searchRegion, u64 progressOffset, const SearchSettings::Sequence &settings);
+        static std::vector<Occurrence> searchRegex(Task &task, prv::Provider *provider, Region searchRegion, u64 progressOffset, const SearchSettings::Regex &settings);
+        static std::vector<Occurrence> searchBinaryPattern(Task &task, prv::Provider *provider, Region searchRegion, u64 progressOffset, const SearchSettings::BinaryPattern &settings);
+        static std::vector<Occurrence> searchValue(Task &task, prv::Provider *provider, Region searchRegion, u64 progressOffset, const SearchSettings::Value &settings);
+
+        /**
+         * @brief Calculates how many bytes at the edges of a run of zero bytes a search still needs to look at
+         * @return Number of bytes, or std::nullopt if the search can match zeros and runs of zero bytes can't be skipped
+         */
+        static std::optional<u64> getZeroRunMargin(const SearchSettings &settings);
+
+        /**
+         * @brief Splits a region into the parts the provider reports as valid, leaving out address space that isn't mapped to anything
+         * @param alignment Alignment of the search relative to the start of the region
+         */
+        static std::vector<Region> getValidRegions(prv::Provider *provider, Region searchRegion, u64 alignment);
 
         void drawContextMenu(Occurrence &target, const std::string &value);
 
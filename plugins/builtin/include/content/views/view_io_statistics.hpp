@@ -0,0 +1,24 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/ui/view.hpp>
+
+#include <string>
+
+namespace hex::plugin::builtin {
+
+    class ViewIoStatistics : public View {
+    public:
+        ViewIoStatistics();
+        ~ViewIoStatistics() override = default;
+
+        void drawContent() override;
+
+    private:
+        void exportTrace(prv::Provider *provider);
+
+        std::string m_selectedCaller;
+    };
+
+}
@@ -7,7 +7,7 @@
 #include <pl/pattern_language.hpp>
 #include <pl/core/errors/error.hpp>
 
-#include <content/providers/memory_file_provider.hpp>
+#include <content/providers/buffer_provider.hpp>
 
 #include <ui/hex_editor.hpp>
 #include <ui/pattern_drawer.hpp>
@@ -195,7 +195,7 @@ namespace hex::plugin::builtin {
                 AchievementManager::unlockAchievement("hex.builtin.achievement.hex_editor", "hex.builtin.achievement.hex_editor.create_bookmark.name");
             });
 
-            EventManager::subscribe<EventPatchCreated>([](u64, u8, u8) {
+            EventManager::subscribe<EventPatchRangeCreated>([](u64, std::span<const u8>, std::span<const u8>) {
                 AchievementManager::unlockAchievement("hex.builtin.achievement.hex_editor", "hex.builtin.achievement.hex_editor.modify_byte.name");
             });
 
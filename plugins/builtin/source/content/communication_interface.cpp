@@ -1,7 +1,13 @@
 #include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
+#include <hex/providers/provider.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
+#include <future>
+#include <memory>
+
 namespace hex::plugin::builtin {
 
     void registerNetworkEndpoints() {
@@ -13,6 +19,79 @@ namespace hex::plugin::builtin {
             return { };
         });
 
+        ContentRegistry::CommunicationInterface::registerNetworkEndpoint("provider/io_statistics", [](const nlohmann::json &data) -> nlohmann::json {
+            using prv::IoStatistics;
+
+            if (data.contains("enabled"))
+                IoStatistics::setEnabled(data.at("enabled").get<bool>());
+            if (data.contains("tracing"))
+                IoStatistics::setTracingEnabled(data.at("tracing").get<bool>());
+
+            const bool includeTrace = data.value("trace", false);
+            const bool reset        = data.value("reset", false);
+
+            // Providers may only be accessed from the main thread, they could get closed while they're being queried otherwise
+            auto promise = std::make_shared<std::promise<nlohmann::json>>();
+            auto future  = promise->get_future();
+            TaskManager::doLater([promise, includeTrace, reset] {
+                nlohmann::json providers = nlohmann::json::array();
+
+                for (const auto provider : ImHexApi::Provider::getProviders()) {
+                    auto &ioStatistics = provider->getIoStatistics();
+
+                    nlohmann::json callers = nlohmann::json::array();
+                    for (const auto &[caller, statistics] : ioStatistics.getCallerStatistics()) {
+                        callers.push_back({
+                            { "caller",            caller                           },
+                            { "calls",             statistics.calls                 },
+                            { "bytes",             statistics.bytes                 },
+                            { "cache_hits",        statistics.cacheHits             },
+                            { "cache_misses",      statistics.cacheMisses           },
+                            { "total_duration_ns", statistics.totalDuration.count() },
+                            { "latency_histogram", statistics.latencyHistogram      }
+                        });
+                    }
+
+                    nlohmann::json providerJson = {
+                        { "id",      provider->getID()   },
+                        { "name",    provider->getName() },
+                        { "callers", callers             }
+                    };
+
+                    if (includeTrace) {
+                        nlohmann::json trace = nlohmann::json::array();
+                        for (const auto &entry : ioStatistics.getTrace()) {
+                            trace.push_back({
+                                { "time_us",     std::chrono::duration_cast<std::chrono::microseconds>(entry.time.time_since_epoch()).count() },
+                                { "offset",      entry.offset           },
+                                { "size",        entry.size             },
+                                { "duration_ns", entry.duration.count() },
+                                { "caller",      entry.caller           }
+                            });
+                        }
+
+                        providerJson["trace"] = trace;
+                    }
+
+                    if (reset)
+                        ioStatistics.reset();
+
+                    providers.push_back(providerJson);
+                }
+
+                promise->set_value({
+                    { "enabled",   IoStatistics::isEnabled()        },
+                    { "tracing",   IoStatistics::isTracingEnabled() },
+                    { "providers", providers                        }
+                });
+            });
+
+            if (future.wait_for(std::chrono::seconds(5)) != std::future_status::ready)
+                throw std::runtime_error("Timed out waiting for the provider statistics");
+
+            return future.get();
+        });
+
         ContentRegistry::CommunicationInterface::registerNetworkEndpoint("imhex/capabilities", [](const nlohmann::json &) -> nlohmann::json {
             nlohmann::json result;
 
@@ -12,6 +12,7 @@
 #include <hex/helpers/patches.hpp>
 
 #include <content/global_actions.hpp>
+#include <content/providers/snapshot_provider.hpp>
 #include <content/popups/popup_notification.hpp>
 #include <content/popups/popup_text_input.hpp>
 
@@ -220,7 +221,7 @@ namespace hex::plugin::builtin {
         void exportIPSPatch() {
             auto provider = ImHexApi::Provider::get();
 
-            Patches patches = provider->getPatches();
+            Patches patches = provider->getPatches().toMap();
 
             // Make sure there's no patch at address 0x00454F46 because that would cause the patch to contain the sequence "EOF" which signals the end of the patch
             if (!patches.contains(0x00454F45) && patches.contains(0x00454F46)) {
@@ -253,7 +254,7 @@ namespace hex::plugin::builtin {
         void exportIPS32Patch() {
             auto provider = ImHexApi::Provider::get();
 
-            Patches patches = provider->getPatches();
+            Patches patches = provider->getPatches().toMap();
 
             // Make sure there's no patch at address 0x45454F46 because that would cause the patch to contain the sequence "*EOF" which signals the end of the patch
             if (!patches.contains(0x45454F45) && patches.contains(0x45454F46)) {
@@ -285,6 +286,58 @@ namespace hex::plugin::builtin {
     }
 
 
+    namespace {
+
+        void takeSnapshot() {
+            auto provider = ImHexApi::Provider::get();
+
+            // Unchanged blocks get shared with the most recent snapshot of the same provider
+            std::shared_ptr<prv::Snapshot> previous;
+            u32 number = 1;
+            for (auto openProvider : ImHexApi::Provider::getProviders()) {
+                if (auto snapshotProvider = dynamic_cast<SnapshotProvider*>(openProvider); snapshotProvider != nullptr && snapshotProvider->getSourceID() == provider->getID()) {
+                    if (snapshotProvider->getNumber() >= number) {
+                        number   = snapshotProvider->getNumber() + 1;
+                        previous = snapshotProvider->getSnapshot();
+                    }
+                }
+            }
+
+            const auto sourceId = provider->getID();
+            const auto openSnapshot = [sourceName = provider->getName(), sourceId, number](std::shared_ptr<prv::Snapshot> snapshot) {
+                auto newProvider = ImHexApi::Provider::createProvider("hex.builtin.provider.snapshot", true, false);
+                if (auto snapshotProvider = dynamic_cast<SnapshotProvider*>(newProvider); snapshotProvider != nullptr) {
+                    snapshotProvider->setSnapshot(std::move(snapshot), sourceName, sourceId, number);
+
+                    if (!snapshotProvider->open())
+                        ImHexApi::Provider::remove(newProvider);
+                    else
+                        EventManager::post<EventProviderOpened>(newProvider);
+                }
+            };
+
+            // Snapshots of providers with stable data don't copy anything up front but register themselves with the provider.
+            // They're cheap to take, so do it right away on the main thread
+            if (provider->isDataStable()) {
+                openSnapshot(std::make_shared<prv::Snapshot>(provider, previous.get()));
+                return;
+            }
+
+            TaskManager::createTask("hex.builtin.provider.snapshot.creating", provider->getActualSize(), [provider, sourceId, previous, openSnapshot](auto &task) {
+                auto snapshot = std::make_shared<prv::Snapshot>(provider, previous.get(), [&task](u64 processed) { task.update(processed); });
+
+                TaskManager::doLater([sourceId, snapshot, openSnapshot] {
+                    // The source may have been closed before this got called
+                    if (ImHexApi::Provider::getById(sourceId) == nullptr)
+                        return;
+
+                    openSnapshot(snapshot);
+                });
+            });
+        }
+
+    }
+
     /**
      * @brief returns true if there is a currently selected provider, and it is possibl to dump data from it
      */
@@ -323,11 +376,17 @@ namespace hex::plugin::builtin {
         ContentRegistry::Interface::addMenuItem({ "hex.builtin.menu.file", "hex.builtin.menu.file.reload_provider"}, 1250, CTRLCMD + Keys::R, [] {
             auto provider = ImHexApi::Provider::get();
 
+            provider->detachSnapshots();
             provider->close();
             if (!provider->open())
                 ImHexApi::Provider::remove(provider, true);
         }, noRunningTaskAndValidProvider);
 
+        /* Take Snapshot */
+        ContentRegistry::Interface::addMenuItem({ "hex.builtin.menu.file", "hex.builtin.menu.file.snapshot" }, 1300, Shortcut::None, takeSnapshot, [] {
+            return noRunningTaskAndValidProvider() && dynamic_cast<SnapshotProvider*>(ImHexApi::Provider::get()) == nullptr;
+        });
+
 
         /* Project open / save */
         ContentRegistry::Interface::addMenuItem({ "hex.builtin.menu.file", "hex.builtin.menu.file.project", "hex.builtin.menu.file.project.open" }, 1400,
@@ -8,10 +8,14 @@
 #include "content/providers/motorola_srec_provider.hpp"
 #include "content/providers/memory_file_provider.hpp"
 #include "content/providers/view_provider.hpp"
+#include "content/providers/process_memory_provider.hpp"
+#include "content/providers/elf_core_provider.hpp"
+#include "content/providers/snapshot_provider.hpp"
 #include "content/popups/popup_notification.hpp"
 #include "content/helpers/notification.hpp"
 
 #include <hex/api/project_file_manager.hpp>
+#include <hex/api/event.hpp>
 #include <hex/api/task.hpp>
 #include <hex/helpers/fmt.hpp>
 
@@ -19,9 +23,68 @@
 
 #include <wolv/utils/guards.hpp>
 
+#include <chrono>
+#include <map>
+
 namespace hex::plugin::builtin {
 
+    namespace {
+
+        using IdleClock = std::chrono::steady_clock;
+
+        std::chrono::seconds s_idleTimeout = std::chrono::seconds(60);
+        std::map<prv::Provider*, IdleClock::time_point> s_backgroundProviders;
+
+        /**
+         * @brief Lets providers in background tabs release their mappings and caches once they weren't looked at for a while.
+         *   They reopen everything by themselves as soon as they get accessed again
+         */
+        void registerIdleProviderRelease() {
+            EventManager::subscribe<EventSettingsChanged>([] {
+                s_idleTimeout = std::chrono::seconds(ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.provider_idle_timeout", 60));
+            });
+
+            EventManager::subscribe<EventProviderOpened>([](prv::Provider *provider) {
+                if (provider != ImHexApi::Provider::get())
+                    s_backgroundProviders[provider] = IdleClock::now();
+            });
+
+            EventManager::subscribe<EventProviderChanged>([](prv::Provider *oldProvider, prv::Provider *newProvider) {
+                if (oldProvider != nullptr)
+                    s_backgroundProviders[oldProvider] = IdleClock::now();
+                s_backgroundProviders.erase(newProvider);
+            });
+
+            EventManager::subscribe<EventProviderDeleted>([](prv::Provider *provider) {
+                s_backgroundProviders.erase(provider);
+            });
+
+            EventManager::subscribe<EventFrameEnd>([] {
+                if (s_idleTimeout.count() == 0 || s_backgroundProviders.empty())
+                    return;
+
+                // Tasks may still be holding on to data of the provider they're working on
+                if (TaskManager::getRunningTaskCount() > 0 || TaskManager::getRunningBackgroundTaskCount() > 0)
+                    return;
+
+                const auto now = IdleClock::now();
+                std::erase_if(s_backgroundProviders, [now](const auto &entry) {
+                    const auto &[provider, backgroundSince] = entry;
+                    if (now - backgroundSince < s_idleTimeout)
+                        return false;
+
+                    if (provider != ImHexApi::Provider::get())
+                        provider->releaseResources();
+
+                    return true;
+                });
+            });
+        }
+
+    }
+
     void registerProviders() {
+        registerIdleProviderRelease();
 
         ContentRegistry::Provider::add<FileProvider>(false);
         ContentRegistry::Provider::add<NullProvider>(false);
@@ -31,6 +94,12 @@ namespace hex::plugin::builtin {
         ContentRegistry::Provider::add<MotorolaSRECProvider>();
         ContentRegistry::Provider::add<MemoryFileProvider>(false);
         ContentRegistry::Provider::add<ViewProvider>(false);
+        ContentRegistry::Provider::add<SnapshotProvider>(false);
+        ContentRegistry::Provider::add<ElfCoreProvider>();
+
+        #if defined(OS_LINUX)
+            ContentRegistry::Provider::add<ProcessMemoryProvider>();
+        #endif
 
         ProjectFile::registerHandler({
             .basePath = "providers",
@@ -2,6 +2,7 @@
 
 #include "content/providers/disk_provider.hpp"
 
+#include <hex/api/content_registry.hpp>
 #include <hex/api/localization.hpp>
 
 #include <hex/helpers/fmt.hpp>
@@ -35,6 +36,7 @@
 
 #if defined(OS_LINUX)
 #define lseek lseek64
+#define pread pread64
 #endif
 
 namespace hex::plugin::builtin {
@@ -209,10 +211,31 @@ namespace hex::plugin::builtin {
 
 #endif
 
+        // Make sure cache blocks are always made up of whole sectors
+        if (this->m_sectorSize > 0)
+            this->m_cache.setBlockSize(std::max<size_t>(prv::ProviderCache::DefaultBlockSize / this->m_sectorSize, 1) * this->m_sectorSize);
+
+        this->m_readAheadSize = size_t(ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.disk_read_ahead", 1024)) * 1024;
+        this->m_lastReadEnd   = 0;
+
+        this->m_ioRing.reset();
+        if (const auto queueDepth = ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.io_queue_depth", 8); queueDepth > 1) {
+            auto ioRing = std::make_unique<prv::IoRing>(queueDepth);
+            if (ioRing->isValid())
+                this->m_ioRing = std::move(ioRing);
+        }
+
         return true;
     }
 
     void DiskProvider::close() {
+        // Stops any pending prefetches before the handle goes away
+        this->m_cache.clear();
+
+        std::scoped_lock lock(this->m_diskMutex);
+
+        this->m_ioRing.reset();
+
 #if defined(OS_WINDOWS)
 
         if (this->m_diskHandle != INVALID_HANDLE_VALUE)
@@ -230,57 +253,84 @@ namespace hex::plugin::builtin {
 #endif
     }
 
-    void DiskProvider::readRaw(u64 offset, void *buffer, size_t size) {
+    bool DiskProvider::readAlignedSectors(u64 offset, u8 *buffer, size_t size) {
 #if defined(OS_WINDOWS)
 
-        DWORD bytesRead = 0;
+        // ReadFile can only read up to 4GiB at once. Reads are split into chunks of 1GiB, which keeps every read a multiple of the sector size
+        constexpr static size_t MaxReadSize = 0x4000'0000;
 
-            u64 startOffset = offset;
+        while (size > 0) {
+            LARGE_INTEGER seekPosition;
+            seekPosition.QuadPart = offset;
 
-            while (size > 0) {
-                LARGE_INTEGER seekPosition;
-                seekPosition.LowPart  = (offset & 0xFFFF'FFFF) - (offset % this->m_sectorSize);
-                seekPosition.HighPart = offset >> 32;
+            DWORD bytesRead = 0;
+            if (!::SetFilePointerEx(this->m_diskHandle, seekPosition, nullptr, FILE_BEGIN))
+                return false;
+            if (!::ReadFile(this->m_diskHandle, buffer, static_cast<DWORD>(std::min(size, MaxReadSize)), &bytesRead, nullptr) || bytesRead == 0)
+                return false;
 
-                if (this->m_sectorBufferAddress != static_cast<u64>(seekPosition.QuadPart)) {
-                    ::SetFilePointer(this->m_diskHandle, seekPosition.LowPart, &seekPosition.HighPart, FILE_BEGIN);
-                    ::ReadFile(this->m_diskHandle, this->m_sectorBuffer.data(), this->m_sectorBuffer.size(), &bytesRead, nullptr);
-                    this->m_sectorBufferAddress = seekPosition.QuadPart;
-                }
+            buffer += bytesRead;
+            offset += bytesRead;
+            size -= bytesRead;
+        }
 
-                std::memcpy(reinterpret_cast<u8 *>(buffer) + (offset - startOffset), this->m_sectorBuffer.data() + (offset & (this->m_sectorSize - 1)), std::min(this->m_sectorSize, size));
+#else
 
-                size = std::max<ssize_t>(static_cast<ssize_t>(size) - this->m_sectorSize, 0);
-                offset += this->m_sectorSize;
-            }
+        // Split up large reads and keep multiple parts of them in flight at once if possible
+        const size_t chunkSize = std::max<size_t>(prv::IoRing::DefaultChunkSize / this->m_sectorSize, 1) * this->m_sectorSize;
+        if (this->m_ioRing != nullptr && size > chunkSize && this->m_ioRing->read(this->m_diskHandle, offset, buffer, size, chunkSize))
+            return true;
 
-#else
+        while (size > 0) {
+            auto bytesRead = ::pread(this->m_diskHandle, buffer, size, offset);
+            if (bytesRead < 0 && errno == EINTR)
+                continue;
+            if (bytesRead <= 0)
+                return false;
+
+            buffer += bytesRead;
+            offset += bytesRead;
+            size -= bytesRead;
+        }
 
-        u64 startOffset    = offset;
+#endif
+
+        return true;
+    }
+
+    void DiskProvider::readSectors(u64 offset, void *buffer, size_t size) {
+        if (this->m_sectorSize == 0)
+            return;
+
+        auto bytes = static_cast<u8 *>(buffer);
 
         while (size > 0) {
-            u64 seekPosition = offset - (offset % this->m_sectorSize);
+            const u64 sectorOffset = offset % this->m_sectorSize;
+
+            size_t readSize;
+            if (sectorOffset == 0 && size >= this->m_sectorSize) {
+                // Whole sectors are read straight into the caller's buffer using as few reads as possible
+                readSize = size - (size % this->m_sectorSize);
 
-            if (this->m_sectorBufferAddress != seekPosition || this->m_sectorBufferAddress == 0) {
-                ::lseek(this->m_diskHandle, seekPosition, SEEK_SET);
-                if (::read(this->m_diskHandle, this->m_sectorBuffer.data(), this->m_sectorBuffer.size()) == -1)
+                if (!this->readAlignedSectors(offset, bytes, readSize))
                     break;
+            } else {
+                // Sectors that are only partially requested have to go through the sector buffer
+                readSize = std::min<size_t>(this->m_sectorSize - sectorOffset, size);
 
-                this->m_sectorBufferAddress = seekPosition;
-            }
+                if (!this->readAlignedSectors(offset - sectorOffset, this->m_sectorBuffer.data(), this->m_sectorBuffer.size()))
+                    break;
 
-            std::memcpy(reinterpret_cast<u8 *>(buffer) + (offset - startOffset),
-                        this->m_sectorBuffer.data() + (offset & (this->m_sectorSize - 1)),
-                        std::min(this->m_sectorSize, size));
+                std::memcpy(bytes, this->m_sectorBuffer.data() + sectorOffset, readSize);
+            }
 
-            size = std::max<ssize_t>(static_cast<ssize_t>(size) - this->m_sectorSize, 0);
-            offset += this->m_sectorSize;
+            bytes += readSize;
+            offset += readSize;
+            size -= readSize;
         }
-
-#endif
     }
 
-    void DiskProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+    void DiskProvider::writeSectors(u64 offset, const void *buffer, size_t size) {
 #if defined(OS_WINDOWS)
 
         DWORD bytesWritten = 0;
@@ -294,7 +344,7 @@ namespace hex::plugin::builtin {
                 u64 sectorBase  = offset - (offset % this->m_sectorSize);
                 size_t currSize = std::min(size, this->m_sectorSize);
 
-                this->readRaw(sectorBase, modifiedSectorBuffer.data(), modifiedSectorBuffer.size());
+                this->readSectors(sectorBase, modifiedSectorBuffer.data(), modifiedSectorBuffer.size());
                 std::memcpy(modifiedSectorBuffer.data() + ((offset - sectorBase) % this->m_sectorSize), reinterpret_cast<const u8 *>(buffer) + (startOffset - offset), currSize);
 
                 LARGE_INTEGER seekPosition;
@@ -319,7 +369,7 @@ namespace hex::plugin::builtin {
             u64 sectorBase  = offset - (offset % this->m_sectorSize);
             size_t currSize = std::min(size, this->m_sectorSize);
 
-            this->readRaw(sectorBase, modifiedSectorBuffer.data(), modifiedSectorBuffer.size());
+            this->readSectors(sectorBase, modifiedSectorBuffer.data(), modifiedSectorBuffer.size());
             std::memcpy(modifiedSectorBuffer.data() + ((offset - sectorBase) % this->m_sectorSize), reinterpret_cast<const u8 *>(buffer) + (startOffset - offset), currSize);
 
             ::lseek(this->m_diskHandle, sectorBase, SEEK_SET);
@@ -333,6 +383,114 @@ namespace hex::plugin::builtin {
 #endif
     }
 
+    void DiskProvider::readUncached(u64 offset, void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_diskMutex);
+        this->readSectors(offset, buffer, size);
+    }
+
+    void DiskProvider::readUncached(std::span<const prv::ProviderCache::ReadRequest> requests) {
+        std::scoped_lock lock(this->m_diskMutex);
+
+        const auto isWholeSectors = [this](const prv::ProviderCache::ReadRequest &request) {
+            return this->m_sectorSize > 0 && request.offset % this->m_sectorSize == 0 && request.size % this->m_sectorSize == 0;
+        };
+
+        bool readByRing = false;
+
+#if !defined(OS_WINDOWS)
+
+        // Requests made up of whole sectors are all handed to the ring at once so they're in flight together
+        if (this->m_ioRing != nullptr) {
+            std::vector<prv::IoRing::ReadRequest> ringRequests;
+            for (const auto &request : requests) {
+                if (isWholeSectors(request))
+                    ringRequests.push_back({ request.offset, request.buffer, request.size });
+            }
+
+            const size_t chunkSize = std::max<size_t>(prv::IoRing::DefaultChunkSize / this->m_sectorSize, 1) * this->m_sectorSize;
+            if (!ringRequests.empty())
+                readByRing = this->m_ioRing->read(this->m_diskHandle, ringRequests, chunkSize);
+        }
+
+#endif
+
+        for (const auto &request : requests) {
+            if (!readByRing || !isWholeSectors(request))
+                this->readSectors(request.offset, request.buffer, request.size);
+        }
+    }
+
+    void DiskProvider::readv(std::span<const ReadRequest> requests, bool overlays) {
+        std::vector<prv::ProviderCache::ReadRequest> cacheRequests;
+        cacheRequests.reserve(requests.size());
+
+        size_t totalSize = 0;
+        for (const auto &request : requests) {
+            if (request.size > 0 && request.buffer != nullptr) {
+                cacheRequests.push_back({ request.offset - this->getBaseAddress(), request.size, request.buffer });
+                totalSize += request.size;
+            }
+        }
+
+        if (cacheRequests.empty())
+            return;
+
+        prv::IoStatistics::ReadScope readScope(this, requests.front().offset, totalSize);
+
+        // Everything that isn't cached yet gets read from the disk together instead of one request after another
+        this->m_cache.readv(cacheRequests, this->getActualSize(), [this](std::span<const prv::ProviderCache::ReadRequest> backendRequests) {
+            this->readUncached(backendRequests);
+        });
+
+        if (overlays) [[likely]] {
+            for (const auto &request : requests) {
+                if (request.size == 0 || request.buffer == nullptr)
+                    continue;
+
+                this->getPatches().apply(request.offset, request.buffer, request.size);
+                this->applyOverlays(request.offset, request.buffer, request.size);
+            }
+        }
+    }
+
+    void DiskProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        const auto readFunction = [this](u64 readOffset, void *readBuffer, size_t readSize) {
+            this->readUncached(readOffset, readBuffer, readSize);
+        };
+
+        // Reads that continue where the previous one ended are most likely part of a linear scan
+        const bool sequential = this->m_readAheadSize > 0 && this->m_lastReadEnd.exchange(offset + size) == offset;
+
+        // The requested data might currently be getting read ahead. Wait for that instead of reading it a second time
+        if (sequential && !this->m_cache.contains(offset, size, this->getActualSize()))
+            this->m_cache.waitForPrefetch();
+
+        this->m_cache.read(offset, buffer, size, this->getActualSize(), readFunction);
+
+        // Load the data following this read in the background so it's already cached once the scan gets there
+        if (sequential)
+            this->m_cache.prefetch(offset + size, this->m_readAheadSize, this->getActualSize(), readFunction);
+    }
+
+    void DiskProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        {
+            std::scoped_lock lock(this->m_diskMutex);
+            this->writeSectors(offset, buffer, size);
+        }
+
+        this->m_cache.invalidate(offset, size);
+    }
+
+    bool DiskProvider::isDataAvailable(u64 offset, size_t size) const {
+        return this->m_cache.contains(offset - this->getBaseAddress(), size, this->getActualSize());
+    }
+
+    void DiskProvider::prefetch(const Region &region) {
+        this->m_cache.prefetch(region.getStartAddress() - this->getBaseAddress(), region.getSize(), this->getActualSize(), [this](u64 readOffset, void *readBuffer, size_t readSize) {
+            this->readUncached(readOffset, readBuffer, readSize);
+        });
+    }
+
     size_t DiskProvider::getActualSize() const {
         return this->m_diskSize;
     }
@@ -0,0 +1,429 @@
+#include "content/providers/elf_core_provider.hpp"
+
+#include <hex/api/imhex_api.hpp>
+#include <hex/api/localization.hpp>
+#include <hex/helpers/fs.hpp>
+#include <hex/ui/imgui_imhex_extensions.h>
+
+#include <nlohmann/json.hpp>
+
+#include <wolv/utils/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace hex::plugin::builtin {
+
+    namespace elf {
+
+        constexpr static u8 ClassElf32 = 1, ClassElf64 = 2;
+        constexpr static u8 DataLittleEndian = 1, DataBigEndian = 2;
+        constexpr static u16 TypeCore = 4;
+        constexpr static u32 SegmentTypeLoad = 1;
+
+        // Marks that the number of program headers didn't fit into the ELF header and is stored in the first section header instead
+        constexpr static u16 ExtendedNumbering = 0xFFFF;
+
+        constexpr static u32 FlagExecute = 1, FlagWrite = 2, FlagRead = 4;
+
+        /**
+         * @brief Reads fields of the ELF structures in the byte order and size class of the file
+         */
+        class Reader {
+        public:
+            using ReadFunction = std::function<void(u64 offset, void *buffer, size_t size)>;
+
+            Reader(ReadFunction readFunction, u64 fileSize, bool is64Bit, std::endian endian)
+                : m_readFunction(std::move(readFunction)), m_fileSize(fileSize), m_is64Bit(is64Bit), m_endian(endian) { }
+
+            template<typename T>
+            [[nodiscard]] T read(u64 offset) const {
+                if (offset > this->m_fileSize || sizeof(T) > this->m_fileSize - offset)
+                    throw std::runtime_error("hex.builtin.provider.elf_core.error.truncated");
+
+                T value;
+                this->m_readFunction(offset, &value, sizeof(T));
+                return hex::changeEndianess(value, this->m_endian);
+            }
+
+            /**
+             * @brief Reads a field that's 4 bytes large in 32 bit files and 8 bytes large in 64 bit files
+             */
+            [[nodiscard]] u64 readWord(u64 offset) const {
+                return this->m_is64Bit ? this->read<u64>(offset) : this->read<u32>(offset);
+            }
+
+            [[nodiscard]] bool is64Bit() const { return this->m_is64Bit; }
+
+        private:
+            ReadFunction m_readFunction;
+            u64 m_fileSize;
+            bool m_is64Bit;
+            std::endian m_endian;
+        };
+
+        /**
+         * @brief Parses the program headers of a core dump
+         * @param readFunction Function reading bytes from the file
+         * @param fileSize Size of the file
+         * @return PT_LOAD segments sorted by address without any overlaps
+         */
+        std::vector<ElfCoreProvider::Segment> parseSegments(const Reader::ReadFunction &readFunction, u64 fileSize) {
+            std::array<u8, 0x10> identification = { };
+            if (fileSize < identification.size())
+                throw std::runtime_error("hex.builtin.provider.elf_core.error.not_elf");
+
+            readFunction(0, identification.data(), identification.size());
+            if (std::memcmp(identification.data(), "\x7F" "ELF", 4) != 0)
+                throw std::runtime_error("hex.builtin.provider.elf_core.error.not_elf");
+
+            const auto elfClass = identification[4];
+            const auto elfData  = identification[5];
+            if ((elfClass != ClassElf32 && elfClass != ClassElf64) || (elfData != DataLittleEndian && elfData != DataBigEndian))
+                throw std::runtime_error("hex.builtin.provider.elf_core.error.not_elf");
+
+            const Reader reader(readFunction, fileSize, elfClass == ClassElf64, elfData == DataLittleEndian ? std::endian::little : std::endian::big);
+            const bool is64Bit = reader.is64Bit();
+
+            if (reader.read<u16>(0x10) != TypeCore)
+                throw std::runtime_error("hex.builtin.provider.elf_core.error.not_core");
+
+            const u64 programHeaderOffset   = reader.readWord(is64Bit ? 0x20 : 0x1C);
+            const u64 sectionHeaderOffset   = reader.readWord(is64Bit ? 0x28 : 0x20);
+            const u16 programHeaderSize     = reader.read<u16>(is64Bit ? 0x36 : 0x2A);
+            u64 programHeaderCount          = reader.read<u16>(is64Bit ? 0x38 : 0x2C);
+
+            // Core dumps of processes with a lot of mappings have more program headers than fit into the 16 bit count
+            if (programHeaderCount == ExtendedNumbering && sectionHeaderOffset != 0)
+                programHeaderCount = reader.read<u32>(sectionHeaderOffset + (is64Bit ? 0x2C : 0x1C));
+
+            if (programHeaderSize < (is64Bit ? 0x38 : 0x20))
+                throw std::runtime_error("hex.builtin.provider.elf_core.error.truncated");
+
+            std::vector<ElfCoreProvider::Segment> segments;
+            for (u64 i = 0; i < programHeaderCount; i++) {
+                const u64 header = programHeaderOffset + i * programHeaderSize;
+                if (reader.read<u32>(header) != SegmentTypeLoad)
+                    continue;
+
+                ElfCoreProvider::Segment segment = { };
+                if (is64Bit) {
+                    segment.flags      = reader.read<u32>(header + 0x04);
+                    segment.fileOffset = reader.read<u64>(header + 0x08);
+                    segment.address    = reader.read<u64>(header + 0x10);
+                    segment.fileSize   = reader.read<u64>(header + 0x20);
+                    segment.memorySize = reader.read<u64>(header + 0x28);
+                } else {
+                    segment.fileOffset = reader.read<u32>(header + 0x04);
+                    segment.address    = reader.read<u32>(header + 0x08);
+                    segment.fileSize   = reader.read<u32>(header + 0x10);
+                    segment.memorySize = reader.read<u32>(header + 0x14);
+                    segment.flags      = reader.read<u32>(header + 0x18);
+                }
+
+                // Truncated core dumps may claim more data than the file actually holds
+                segment.fileSize = std::min({ segment.fileSize, segment.memorySize, fileSize - std::min(segment.fileOffset, fileSize) });
+
+                if (segment.memorySize == 0 || segment.address + segment.memorySize < segment.address)
+                    continue;
+
+                segments.push_back(segment);
+            }
+
+            std::stable_sort(segments.begin(), segments.end(), [](const auto &a, const auto &b) {
+                return a.address < b.address;
+            });
+
+            // Segments shouldn't overlap, but if they do anyway the one starting at the lower address takes precedence
+            std::vector<ElfCoreProvider::Segment> result;
+            for (auto segment : segments) {
+                if (!result.empty()) {
+                    const auto &previous = result.back();
+                    const u64 previousEnd = previous.address + previous.memorySize;
+                    if (segment.address + segment.memorySize <= previousEnd)
+                        continue;
+
+                    if (segment.address < previousEnd) {
+                        const u64 overlap = previousEnd - segment.address;
+                        segment.address    += overlap;
+                        segment.memorySize -= overlap;
+                        segment.fileOffset += overlap;
+                        segment.fileSize    = overlap < segment.fileSize ? segment.fileSize - overlap : 0;
+                    }
+                }
+
+                result.push_back(segment);
+            }
+
+            return result;
+        }
+
+    }
+
+    bool ElfCoreProvider::open() {
+        wolv::io::File file(this->m_path, wolv::io::File::Mode::Read);
+        if (!file.isValid()) {
+            this->setErrorMessage(hex::format("hex.builtin.provider.file.error.open"_lang, wolv::util::toUTF8String(this->m_path), ::strerror(errno)));
+            return false;
+        }
+
+        this->m_fileSize = file.getSize();
+        this->m_file     = std::move(file);
+        this->m_file.map();
+
+        try {
+            // Only the pages holding the headers get loaded here, the segment data is loaded once it's accessed
+            const auto mapping = this->m_file.getMapping();
+            this->m_segments = elf::parseSegments([this, mapping](u64 offset, void *buffer, size_t size) {
+                if (mapping != nullptr)
+                    std::memcpy(buffer, mapping + offset, size);
+                else
+                    this->readFile(offset, buffer, size);
+            }, this->m_fileSize);
+        } catch (const std::runtime_error &error) {
+            this->setErrorMessage(LangEntry(error.what()));
+            this->close();
+            return false;
+        }
+
+        if (this->m_segments.empty()) {
+            this->setErrorMessage("hex.builtin.provider.elf_core.error.no_segments"_lang);
+            this->close();
+            return false;
+        }
+
+        this->m_segmentSearchWidget.reset();
+
+        return true;
+    }
+
+    void ElfCoreProvider::close() {
+        this->m_file.unmap();
+        this->m_file.close();
+
+        this->m_segments.clear();
+        this->m_fileSize = 0;
+    }
+
+    std::vector<ElfCoreProvider::Segment>::const_iterator ElfCoreProvider::findSegment(u64 address) const {
+        auto it = std::upper_bound(this->m_segments.begin(), this->m_segments.end(), address, [](u64 value, const Segment &segment) {
+            return value < segment.address;
+        });
+
+        if (it != this->m_segments.begin()) {
+            if (const auto previous = std::prev(it); address < previous->address + previous->memorySize)
+                return previous;
+        }
+
+        return it;
+    }
+
+    void ElfCoreProvider::readFile(u64 offset, void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_fileMutex);
+
+        this->m_file.seek(offset);
+        this->m_file.readBuffer(static_cast<u8 *>(buffer), size);
+    }
+
+    std::optional<std::span<const u8>> ElfCoreProvider::tryGetSpan(u64 offset, size_t size) {
+        const auto mapping = this->m_file.getMapping();
+        if (mapping == nullptr || size == 0 || !this->isUnmodified(offset, size))
+            return std::nullopt;
+
+        offset -= this->getBaseAddress();
+
+        // Only ranges completely inside the file backed part of one segment can be handed out directly
+        const auto segment = this->findSegment(offset);
+        if (segment == this->m_segments.end() || offset < segment->address)
+            return std::nullopt;
+
+        const u64 segmentOffset = offset - segment->address;
+        if (segmentOffset > segment->fileSize || size > segment->fileSize - segmentOffset)
+            return std::nullopt;
+
+        return std::span<const u8>(mapping + segment->fileOffset + segmentOffset, size);
+    }
+
+    void ElfCoreProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if (buffer == nullptr || size == 0)
+            return;
+
+        auto bytes = static_cast<u8 *>(buffer);
+
+        // Holes between segments and the parts of segments that aren't stored in the file read as zero
+        std::memset(bytes, 0x00, size);
+
+        const auto mapping = this->m_file.getMapping();
+        const u64 endOffset = offset + std::min<u64>(size, std::numeric_limits<u64>::max() - offset);
+
+        for (auto segment = this->findSegment(offset); segment != this->m_segments.end() && segment->address < endOffset; ++segment) {
+            const u64 start = std::max(offset, segment->address);
+            const u64 end   = std::min(endOffset, segment->address + segment->fileSize);
+            if (start >= end)
+                continue;
+
+            const u64 fileOffset = segment->fileOffset + (start - segment->address);
+            if (mapping != nullptr)
+                std::memcpy(bytes + (start - offset), mapping + fileOffset, end - start);
+            else
+                this->readFile(fileOffset, bytes + (start - offset), end - start);
+        }
+    }
+
+    void ElfCoreProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        hex::unused(offset, buffer, size);
+    }
+
+    size_t ElfCoreProvider::getActualSize() const {
+        if (this->m_segments.empty())
+            return 0;
+
+        const auto &lastSegment = this->m_segments.back();
+        return lastSegment.address + lastSegment.memorySize;
+    }
+
+    std::string ElfCoreProvider::getName() const {
+        return hex::format("hex.builtin.provider.elf_core.name"_lang, wolv::util::toUTF8String(this->m_path.filename()));
+    }
+
+    std::vector<ElfCoreProvider::Description> ElfCoreProvider::getDataDescription() const {
+        std::vector<Description> result;
+
+        result.emplace_back("hex.builtin.provider.file.path"_lang, wolv::util::toUTF8String(this->m_path));
+        result.emplace_back("hex.builtin.provider.file.size"_lang, hex::toByteString(this->m_fileSize));
+        result.emplace_back("hex.builtin.provider.elf_core.segments"_lang, std::to_string(this->m_segments.size()));
+
+        return result;
+    }
+
+    bool ElfCoreProvider::handleFilePicker() {
+        // Core dumps usually don't have any extension
+        return fs::openFileBrowser(fs::DialogMode::Open, { }, [this](const std::fs::path &path) {
+            this->m_path = path;
+        });
+    }
+
+    void ElfCoreProvider::drawInterface() {
+        ImGui::Header("hex.builtin.provider.elf_core.segments"_lang, true);
+
+        auto availableX = ImGui::GetContentRegionAvail().x;
+        ImGui::PushItemWidth(availableX);
+        const auto &filtered = this->m_segmentSearchWidget.draw(this->m_segments);
+        ImGui::PopItemWidth();
+        if (ImGui::BeginTable("##segment_table", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY, ImVec2(availableX, 400_scaled))) {
+            ImGui::TableSetupColumn("hex.builtin.common.region"_lang);
+            ImGui::TableSetupColumn("hex.builtin.common.size"_lang);
+            ImGui::TableSetupColumn("hex.builtin.provider.elf_core.file_size"_lang);
+            ImGui::TableSetupColumn("hex.builtin.provider.elf_core.permissions"_lang);
+            ImGui::TableSetupScrollFreeze(0, 1);
+
+            ImGui::TableHeadersRow();
+
+            for (auto &segment : filtered) {
+                ImGui::PushID(segment);
+
+                const Region region = { this->getBaseAddress() + segment->address, segment->memorySize };
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                if (ImGui::Selectable(hex::format("0x{:016X} - 0x{:016X}", region.getStartAddress(), region.getEndAddress()).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                    ImHexApi::HexEditor::setSelection(region);
+
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(segment->memorySize).c_str());
+
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(segment->fileSize).c_str());
+
+                ImGui::TableNextColumn();
+                ImGui::TextFormatted("{}{}{}",
+                    (segment->flags & elf::FlagRead)    ? 'R' : '-',
+                    (segment->flags & elf::FlagWrite)   ? 'W' : '-',
+                    (segment->flags & elf::FlagExecute) ? 'X' : '-'
+                );
+
+                ImGui::PopID();
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    std::pair<Region, bool> ElfCoreProvider::getRegionValidity(u64 address) const {
+        const u64 offset = address - this->getBaseAddress();
+        if (offset >= this->getActualSize())
+            return { Region::Invalid(), false };
+
+        const auto segment = this->findSegment(offset);
+        if (segment == this->m_segments.end())
+            return { Region::Invalid(), false };
+
+        if (offset >= segment->address)
+            return { Region { address, segment->address + segment->memorySize - offset }, true };
+
+        // Nothing of the process was mapped between two segments, only overlays may hold data there
+        auto [region, valid] = Provider::getRegionValidity(address);
+        if (valid)
+            return { region, true };
+
+        u64 end = this->getBaseAddress() + segment->address;
+        if (region.getSize() != 0)
+            end = std::min<u64>(end, region.getEndAddress() + 1);
+
+        return { Region { address, end - address }, false };
+    }
+
+    std::pair<Region, bool> ElfCoreProvider::getZeroRegion(u64 address) const {
+        const u64 offset = address - this->getBaseAddress();
+        if (offset >= this->getActualSize())
+            return { Region::Invalid(), false };
+
+        const auto segment = this->findSegment(offset);
+        if (segment == this->m_segments.end())
+            return { Region::Invalid(), false };
+
+        u64 runSize;
+        bool zero;
+
+        if (offset < segment->address) {
+            runSize = segment->address - offset;
+            zero    = true;
+        } else if (const u64 fileEnd = segment->address + segment->fileSize; offset < fileEnd) {
+            runSize = fileEnd - offset;
+            zero    = false;
+        } else {
+            // Segment data that isn't stored in the file, e.g. pages that were never touched, reads as zero
+            runSize = segment->address + segment->memorySize - offset;
+            zero    = true;
+        }
+
+        // Overlays may have put data into the zero bytes
+        if (zero) {
+            if (auto modification = this->findFirstModification({ address, runSize }); modification.has_value()) {
+                if (*modification == address)
+                    zero = false;
+                else
+                    runSize = *modification - address;
+            }
+        }
+
+        return { Region { address, runSize }, zero };
+    }
+
+    void ElfCoreProvider::loadSettings(const nlohmann::json &settings) {
+        Provider::loadSettings(settings);
+
+        auto path = settings.at("path").get<std::string>();
+        this->m_path = std::u8string(path.begin(), path.end());
+    }
+
+    nlohmann::json ElfCoreProvider::storeSettings(nlohmann::json settings) const {
+        settings["path"] = wolv::util::toUTF8String(this->m_path);
+
+        return Provider::storeSettings(settings);
+    }
+
+}
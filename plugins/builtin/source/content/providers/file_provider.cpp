@@ -1,8 +1,11 @@
 #include "content/providers/file_provider.hpp"
 #include "content/providers/memory_file_provider.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <stdexcept>
 
+#include <hex/api/content_registry.hpp>
 #include <hex/api/localization.hpp>
 #include <hex/api/project_file_manager.hpp>
 #include <hex/api/achievement_manager.hpp>
@@ -11,17 +14,132 @@
 
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/fmt.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/ui/imgui_imhex_extensions.h>
 
+#include <wolv/utils/guards.hpp>
 #include <wolv/utils/string.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <imgui.h>
+
 #if defined(OS_WINDOWS)
     #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+#if defined(OS_LINUX)
+    #include <sys/xattr.h>
 #endif
 
 namespace hex::plugin::builtin {
 
+    namespace {
+
+        /**
+         * @brief Gives a newly written file the permissions, owner and extended attributes of the file it's going to replace
+         */
+        void copyFileMetadata(const std::fs::path &from, const std::fs::path &to) {
+            std::error_code error;
+            std::fs::permissions(to, std::fs::status(from, error).permissions(), error);
+
+            #if !defined(OS_WINDOWS)
+                struct stat fileStats = { };
+                if (::stat(from.c_str(), &fileStats) != 0)
+                    return;
+
+                // Changing the owner requires privileges most users don't have, but keeping the group may still work.
+                // Changing the owner clears the setuid and setgid bits, so the mode has to be restored afterwards
+                if (::chown(to.c_str(), fileStats.st_uid, fileStats.st_gid) != 0)
+                    (void)::chown(to.c_str(), -1, fileStats.st_gid);
+                (void)::chmod(to.c_str(), fileStats.st_mode & 07777);
+            #endif
+
+            #if defined(OS_LINUX)
+                const auto namesSize = ::listxattr(from.c_str(), nullptr, 0);
+                if (namesSize <= 0)
+                    return;
+
+                std::vector<char> names(namesSize);
+                if (::listxattr(from.c_str(), names.data(), names.size()) != namesSize)
+                    return;
+
+                std::vector<u8> value;
+                for (auto name = names.data(); name < names.data() + names.size(); name += std::strlen(name) + 1) {
+                    const auto valueSize = ::getxattr(from.c_str(), name, nullptr, 0);
+                    if (valueSize < 0)
+                        continue;
+
+                    value.resize(valueSize);
+                    if (::getxattr(from.c_str(), name, value.data(), value.size()) == valueSize)
+                        (void)::setxattr(to.c_str(), name, value.data(), value.size(), 0);
+                }
+            #endif
+        }
+
+        [[nodiscard]] bool areTasksRunning() {
+            return TaskManager::getRunningTaskCount() > 0 || TaskManager::getRunningBackgroundTaskCount() > 0;
+        }
+
+        /**
+         * @brief Calls a function on the main thread once no task is running anymore.
+         *   Used for everything that drops the file's mapping since tasks may hold spans pointing into it
+         */
+        void doLaterWithoutTasks(std::function<void()> function) {
+            TaskManager::doLater([function = std::move(function)] {
+                if (areTasksRunning())
+                    doLaterWithoutTasks(function);
+                else
+                    function();
+            });
+        }
+
+        /**
+         * @brief Checks if a file has more than one name. Replacing such a file would only replace one of them
+         */
+        bool isHardLinked(const std::fs::path &path) {
+            std::error_code error;
+            const auto linkCount = std::fs::hard_link_count(path, error);
+
+            return !error && linkCount > 1;
+        }
+
+        /**
+         * @brief Overwrites the contents of a file in place, keeping everything else about it
+         */
+        bool copyFileContents(const std::fs::path &from, const std::fs::path &to) {
+            wolv::io::File source(from, wolv::io::File::Mode::Read);
+            wolv::io::File destination(to, wolv::io::File::Mode::Write);
+            if (!source.isValid() || !destination.isValid())
+                return false;
+
+            constexpr static size_t BufferSize = 0x10'0000;
+            std::vector<u8> buffer(BufferSize);
+
+            const auto size = source.getSize();
+            for (u64 offset = 0; offset < size; offset += BufferSize) {
+                const auto chunkSize = std::min<u64>(BufferSize, size - offset);
+
+                source.readBuffer(buffer.data(), chunkSize);
+                destination.writeBuffer(buffer.data(), chunkSize);
+            }
+
+            destination.setSize(size);
+            destination.flush();
+
+            return true;
+        }
+
+    }
+
+    FileProvider::~FileProvider() {
+        this->m_rewriteTask.interrupt();
+    }
+
     bool FileProvider::isAvailable() const {
         return true;
     }
@@ -39,19 +157,17 @@ namespace hex::plugin::builtin {
     }
 
     bool FileProvider::isSavable() const {
-        return !this->getPatches().empty();
+        return !this->getPatches().empty() || this->m_pieceTable.isModified();
     }
 
 
     void FileProvider::read(u64 offset, void *buffer, size_t size, bool overlays) {
+        prv::IoStatistics::ReadScope readScope(this, offset, size);
+
         this->readRaw(offset - this->getBaseAddress(), buffer, size);
 
         if (overlays) [[likely]] {
-            for (const auto&[patchOffset, patchData] : getPatches()) {
-                if (patchOffset >= offset && patchOffset < (offset + size))
-                    reinterpret_cast<u8 *>(buffer)[patchOffset - offset] = patchData;
-            }
-
+            this->getPatches().apply(offset, buffer, size);
             this->applyOverlays(offset, buffer, size);
         }
     }
@@ -63,21 +179,186 @@ namespace hex::plugin::builtin {
         addPatch(offset, buffer, size, true);
     }
 
+    prv::Provider::PreparedFill FileProvider::prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback) {
+        if (size > this->getActualSize() || (offset - this->getBaseAddress()) > (this->getActualSize() - size) || pattern.empty() || size == 0)
+            return { offset, 0, pattern, { } };
+
+        return preparePatchFill(offset, size, pattern, progressCallback);
+    }
+
+    void FileProvider::fill(const PreparedFill &fill) {
+        if (fill.size > this->getActualSize() || (fill.offset - this->getBaseAddress()) > (this->getActualSize() - fill.size) || fill.pattern.empty() || fill.size == 0)
+            return;
+
+        addFillPatch(fill, true);
+    }
+
+    std::optional<std::span<const u8>> FileProvider::tryGetSpan(u64 offset, size_t size) {
+        if (this->m_accessMode != AccessMode::Mapped)
+            return std::nullopt;
+
+        // The span outlives the lock. That's fine since the mapping only gets dropped on the main thread while no task is running:
+        // by releaseResources(), by switching the access mode and by replacing the file after a rewrite
+        const auto lock = this->acquireFile();
+
+        const auto mapping = this->m_file.getMapping();
+        if (mapping == nullptr || size == 0 || size > this->getActualSize() || (offset - this->getBaseAddress()) > (this->getActualSize() - size))
+            return std::nullopt;
+
+        if (!this->isUnmodified(offset, size))
+            return std::nullopt;
+
+        const auto originalOffset = this->m_pieceTable.findOriginalAddress(offset - this->getBaseAddress(), size);
+        if (!originalOffset.has_value())
+            return std::nullopt;
+
+        return std::span<const u8>(mapping + *originalOffset, size);
+    }
+
     void FileProvider::readRaw(u64 offset, void *buffer, size_t size) {
         if (offset > (this->getActualSize() - size) || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, this->m_file.getMapping() + offset, size);
+        const auto lock = this->acquireFile();
+
+        const auto mapping = this->m_file.getMapping();
+        this->m_pieceTable.read(offset, static_cast<u8 *>(buffer), size, [this, mapping](u64 originalOffset, u8 *readBuffer, u64 readSize) {
+            if (mapping != nullptr) {
+                std::memcpy(readBuffer, mapping + originalOffset, readSize);
+            } else {
+                this->m_cache.read(originalOffset, readBuffer, readSize, this->m_pieceTable.getOriginalSize(), [this](u64 readOffset, void *fileBuffer, size_t fileSize) {
+                    this->readFile(readOffset, fileBuffer, fileSize);
+                });
+            }
+        });
     }
 
     void FileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(this->m_file.getMapping() + offset, buffer, size);
+        const auto lock = this->acquireFile();
+
+        const auto mapping = this->m_file.getMapping();
+        this->m_pieceTable.write(offset, static_cast<const u8 *>(buffer), size, [this, mapping](u64 originalOffset, const u8 *writeBuffer, u64 writeSize) {
+            if (mapping != nullptr) {
+                std::memcpy(mapping + originalOffset, writeBuffer, writeSize);
+            } else {
+                this->writeFile(originalOffset, writeBuffer, writeSize);
+                this->m_cache.invalidate(originalOffset, writeSize);
+            }
+        });
+    }
+
+    void FileProvider::readFile(u64 offset, void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_fileMutex);
+
+        if (this->m_directFd != -1) {
+            this->readDirect(offset, buffer, size);
+            return;
+        }
+
+        // The file couldn't be opened again after it got released
+        if (!this->m_file.isValid())
+            return;
+
+        #if defined(OS_LINUX)
+            // Large reads are split up and read in parallel if possible
+            if (this->m_ioRing != nullptr && size > prv::IoRing::DefaultChunkSize && this->m_ioRing->read(fileno(this->m_file.getHandle()), offset, buffer, size))
+                return;
+        #endif
+
+        this->m_file.seek(offset);
+        this->m_file.readBuffer(static_cast<u8 *>(buffer), size);
+    }
+
+    void FileProvider::writeFile(u64 offset, const void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_fileMutex);
+
+        if (!this->m_file.isValid())
+            return;
+
+        this->m_file.seek(offset);
+        this->m_file.writeBuffer(static_cast<const u8 *>(buffer), size);
+
+        // Reads through the ring or direct I/O bypass the file's buffer
+        this->m_file.flush();
+    }
+
+    void FileProvider::readDirect(u64 offset, void *buffer, size_t size) {
+        // Direct I/O requires the file offset, the size and the buffer address to be aligned to the block size of the file system
+        constexpr static u64 Alignment        = 0x1000;
+        constexpr static size_t MaxChunkSize  = 0x40'0000;
+
+        auto bytes = static_cast<u8 *>(buffer);
+        while (size > 0) {
+            const u64 alignedStart   = offset & ~(Alignment - 1);
+            const u64 alignedEnd     = std::min((offset + size + (Alignment - 1)) & ~(Alignment - 1), alignedStart + MaxChunkSize);
+            const size_t alignedSize = alignedEnd - alignedStart;
+
+            if (this->m_directBuffer.size() < alignedSize + Alignment)
+                this->m_directBuffer.resize(alignedSize + Alignment);
+            const auto alignedBuffer = reinterpret_cast<u8 *>((reinterpret_cast<uintptr_t>(this->m_directBuffer.data()) + (Alignment - 1)) & ~uintptr_t(Alignment - 1));
+
+            const size_t skipSize  = offset - alignedStart;
+            const size_t bytesRead = this->readDirectAligned(alignedStart, alignedBuffer, alignedSize);
+            if (bytesRead <= skipSize)
+                break;
+
+            const size_t copySize = std::min<size_t>({ bytesRead - skipSize, alignedEnd - offset, size });
+            std::memcpy(bytes, alignedBuffer + skipSize, copySize);
+
+            bytes  += copySize;
+            offset += copySize;
+            size   -= copySize;
+        }
+    }
+
+    size_t FileProvider::readDirectAligned(u64 offset, u8 *buffer, size_t size) {
+        // Reads at the end of the file come back short, so only use the ring for reads that lie completely inside the file
+        if (this->m_ioRing != nullptr && size > prv::IoRing::DefaultChunkSize && offset + size <= this->m_pieceTable.getOriginalSize()) {
+            if (this->m_ioRing->read(this->m_directFd, offset, buffer, size))
+                return size;
+        }
+
+        size_t totalRead = 0;
+
+        #if !defined(OS_WINDOWS)
+            while (totalRead < size) {
+                const auto bytesRead = ::pread(this->m_directFd, buffer + totalRead, size - totalRead, offset + totalRead);
+                if (bytesRead < 0 && errno == EINTR)
+                    continue;
+                if (bytesRead <= 0)
+                    break;
+
+                totalRead += bytesRead;
+            }
+        #endif
+
+        return totalRead;
+    }
+
+    void FileProvider::openDirect() {
+        #if defined(OS_LINUX)
+            this->m_directFd = ::open(this->m_path.c_str(), O_RDONLY | O_DIRECT);
+        #elif defined(OS_MACOS)
+            this->m_directFd = ::open(this->m_path.c_str(), O_RDONLY);
+            if (this->m_directFd != -1)
+                ::fcntl(this->m_directFd, F_NOCACHE, 1);
+        #endif
+
+        // Not every system and file system supports direct I/O. The file still gets streamed through the cache then, just not around the page cache
+        if (this->m_directFd == -1)
+            log::warn("Direct I/O isn't available for {}, falling back to buffered reads", wolv::util::toUTF8String(this->m_path));
     }
 
     void FileProvider::save() {
+        // Inserted and removed bytes require the entire file to be rewritten. The patches get applied once that's done
+        if (this->m_pieceTable.isModified()) {
+            this->rewriteFile();
+            return;
+        }
+
         this->applyPatches();
 
         #if defined(OS_WINDOWS)
@@ -105,34 +386,24 @@ namespace hex::plugin::builtin {
     }
 
     void FileProvider::resize(size_t newSize) {
-        this->close();
+        const auto oldSize = this->getActualSize();
 
-        {
-            wolv::io::File file(this->m_path, wolv::io::File::Mode::Write);
+        if (newSize > oldSize)
+            this->m_pieceTable.insert(oldSize, newSize - oldSize);
+        else
+            this->m_pieceTable.remove(newSize, oldSize - newSize);
 
-            file.setSize(newSize);
-        }
+        this->m_editGeneration += 1;
 
-        (void)this->open();
+        Provider::resize(newSize);
     }
 
     void FileProvider::insert(u64 offset, size_t size) {
-        auto oldSize = this->getActualSize();
-        this->resize(oldSize + size);
-
-        std::vector<u8> buffer(0x1000);
-        const std::vector<u8> zeroBuffer(0x1000);
-
-        auto position = oldSize;
-        while (position > offset) {
-            const auto readSize = std::min<size_t>(position - offset, buffer.size());
-
-            position -= readSize;
+        if (offset > this->getActualSize() || size == 0)
+            return;
 
-            this->readRaw(position, buffer.data(), readSize);
-            this->writeRaw(position, zeroBuffer.data(), readSize);
-            this->writeRaw(position + size, buffer.data(), readSize);
-        }
+        this->m_pieceTable.insert(offset, size);
+        this->m_editGeneration += 1;
 
         Provider::insert(offset, size);
     }
@@ -144,29 +415,139 @@ namespace hex::plugin::builtin {
         if ((offset + size) > this->getActualSize())
             size = this->getActualSize() - offset;
 
-        auto oldSize = this->getActualSize();
+        this->m_pieceTable.remove(offset, size);
+        this->m_editGeneration += 1;
 
-        std::vector<u8> buffer(0x1000);
+        Provider::insert(offset, size);
+        Provider::remove(offset, size);
+    }
+
+    void FileProvider::rewriteFile() {
+        if (this->m_rewriteTask.isRunning())
+            return;
+
+        auto tempPath = this->m_path;
+        tempPath += ".tmp";
+
+        this->m_rewriteTask = TaskManager::createTask("hex.builtin.provider.file.rewriting", this->m_pieceTable.getSize(),
+            [providerId = this->getID(), path = this->m_path, tempPath, pieces = this->m_pieceTable.getPieces(), editGeneration = this->m_editGeneration](Task &task) {
+                // Read from a separate handle so the provider can keep using its mapping while the file is being written
+                wolv::io::File originalFile(path, wolv::io::File::Mode::Read);
+                wolv::io::File tempFile(tempPath, wolv::io::File::Mode::Create);
+                if (!originalFile.isValid() || !tempFile.isValid())
+                    throw std::runtime_error(hex::format("Failed to create {}", wolv::util::toUTF8String(tempPath)));
+
+                bool finished = false;
+                ON_SCOPE_EXIT {
+                    tempFile.close();
+                    if (!finished) {
+                        std::error_code error;
+                        std::fs::remove(tempPath, error);
+                    }
+                };
+
+                constexpr static size_t BufferSize = 0x10'0000;
+                std::vector<u8> buffer(BufferSize);
+
+                u64 written = 0;
+                for (const auto &piece : pieces) {
+                    for (u64 pieceOffset = 0; pieceOffset < piece.size; pieceOffset += BufferSize) {
+                        const auto chunkSize = std::min<u64>(BufferSize, piece.size - pieceOffset);
+
+                        if (piece.originalAddress.has_value()) {
+                            originalFile.seek(*piece.originalAddress + pieceOffset);
+                            originalFile.readBuffer(buffer.data(), chunkSize);
+                        } else if (piece.data.empty()) {
+                            std::fill_n(buffer.begin(), chunkSize, 0x00);
+                        } else {
+                            std::copy_n(piece.data.begin() + pieceOffset, chunkSize, buffer.begin());
+                        }
+
+                        tempFile.writeBuffer(buffer.data(), chunkSize);
+
+                        written += chunkSize;
+                        task.update(written);
+                    }
+                }
 
-        const auto newSize = oldSize - size;
-        auto position = offset;
-        while (position < newSize) {
-            const auto readSize = std::min<size_t>(newSize - position, buffer.size());
+                tempFile.flush();
+                copyFileMetadata(path, tempPath);
+                finished = true;
 
-            this->readRaw(position + size, buffer.data(), readSize);
-            this->writeRaw(position, buffer.data(), readSize);
+                doLaterWithoutTasks([providerId, tempPath, editGeneration] {
+                    auto provider = dynamic_cast<FileProvider*>(ImHexApi::Provider::getById(providerId));
+                    if (provider == nullptr) {
+                        std::error_code error;
+                        std::fs::remove(tempPath, error);
+                        return;
+                    }
+
+                    provider->finishRewrite(tempPath, editGeneration);
+                });
+            });
+    }
 
-            position += readSize;
+    void FileProvider::finishRewrite(const std::fs::path &tempPath, u64 editGeneration) {
+        std::error_code error;
+
+        // Bytes were inserted or removed while the file was being written, so what got written is outdated already.
+        // Write the file again with the current edits instead so the save doesn't get lost
+        if (editGeneration != this->m_editGeneration) {
+            std::fs::remove(tempPath, error);
+            this->rewriteFile();
+            return;
         }
 
-        this->resize(newSize);
+        auto pieceTable = std::move(this->m_pieceTable);
 
-        Provider::insert(offset, size);
-        Provider::remove(offset, size);
+        this->close();
+
+        // Replacing a file that has multiple names would detach this name from the others, so its contents get overwritten instead
+        if (isHardLinked(this->m_path)) {
+            if (!copyFileContents(tempPath, this->m_path)) {
+                log::error("Failed to overwrite {} with rewritten file {}", wolv::util::toUTF8String(this->m_path), wolv::util::toUTF8String(tempPath));
+                EventManager::post<RequestOpenErrorPopup>(hex::format("hex.builtin.provider.file.error.overwrite"_lang, wolv::util::toUTF8String(this->m_path), wolv::util::toUTF8String(tempPath)));
+
+                // The rewritten file is only kept around in case the original file got partially overwritten
+                (void)this->reopen();
+                this->m_pieceTable = std::move(pieceTable);
+                return;
+            }
+
+            std::fs::remove(tempPath, error);
+            error.clear();
+        } else {
+            std::fs::rename(tempPath, this->m_path, error);
+        }
+
+        if (error) {
+            log::error("Failed to replace {} with rewritten file: {}", wolv::util::toUTF8String(this->m_path), error.message());
+            EventManager::post<RequestOpenErrorPopup>(hex::format("hex.builtin.provider.file.error.rewrite"_lang, wolv::util::toUTF8String(this->m_path), error.message()));
+            std::fs::remove(tempPath, error);
+
+            // Nothing got written, keep the edits around so saving can be tried again
+            (void)this->reopen();
+            this->m_pieceTable = std::move(pieceTable);
+            return;
+        }
+
+        // The file now contains all edits, so the patches can be applied to it directly
+        if (this->reopen())
+            this->save();
+    }
+
+    bool FileProvider::reopen() {
+        if (this->open())
+            return true;
+
+        log::error("Failed to reopen {}: {}", wolv::util::toUTF8String(this->m_path), this->getErrorMessage());
+        EventManager::post<RequestOpenErrorPopup>(hex::format("hex.builtin.provider.file.error.reopen"_lang, wolv::util::toUTF8String(this->m_path), this->getErrorMessage()));
+
+        return false;
     }
 
     size_t FileProvider::getActualSize() const {
-        return this->m_fileSize;
+        return this->m_pieceTable.getSize();
     }
 
     std::string FileProvider::getName() const {
@@ -257,13 +638,20 @@ namespace hex::plugin::builtin {
             }
         }
 
+        std::unique_lock lock(this->m_loadMutex);
+
         this->m_fileStats = file.getFileInfo();
         this->m_file      = std::move(file);
 
-        this->m_file.map();
-        this->m_fileSize = this->m_file.getSize();
+        this->m_pieceTable.reset(this->m_file.getSize());
+        this->loadHoles();
+
+        // The file gets loaded on whatever thread first accesses it, where the settings can't be read
+        this->m_ioQueueDepth = u32(ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.io_queue_depth", 8));
 
+        // Mapping the file is deferred until its data gets accessed, so opening lots of files at once doesn't map all of them
         this->m_file.close();
+        this->m_fileLoaded = false;
 
         AchievementManager::unlockAchievement("hex.builtin.achievement.starting_out", "hex.builtin.achievement.starting_out.open_file.name");
 
@@ -271,7 +659,124 @@ namespace hex::plugin::builtin {
     }
 
     void FileProvider::close() {
+        std::unique_lock lock(this->m_loadMutex);
+
+        this->unloadFile();
+    }
+
+    void FileProvider::releaseResources() {
+        // Saving writes through the file, it has to stay open until that's done
+        if (this->m_rewriteTask.isRunning())
+            return;
+
+        std::unique_lock lock(this->m_loadMutex, std::try_to_lock);
+        if (!lock.owns_lock() || !this->m_fileLoaded)
+            return;
+
+        this->unloadFile();
+    }
+
+    std::shared_lock<std::shared_mutex> FileProvider::acquireFile() {
+        std::shared_lock lock(this->m_loadMutex);
+
+        // The file may get released again between loading it and taking the shared lock, so check again once the lock is held
+        while (!this->m_fileLoaded) {
+            lock.unlock();
+            {
+                std::unique_lock loadLock(this->m_loadMutex);
+                if (!this->m_fileLoaded)
+                    this->loadFile();
+            }
+            lock.lock();
+        }
+
+        return lock;
+    }
+
+    void FileProvider::loadFile() {
+        // Also counts as loaded if opening failed, reads then don't return any data instead of trying to open the file over and over
+        this->m_fileLoaded = true;
+
+        wolv::io::File file(this->m_path, this->m_writable ? wolv::io::File::Mode::Write : wolv::io::File::Mode::Read);
+        if (!file.isValid()) {
+            log::error("Failed to open {}: {}", wolv::util::toUTF8String(this->m_path), ::strerror(errno));
+            return;
+        }
+
+        this->m_file = std::move(file);
+
+        // The piece table refers to the file as it was when the provider was opened. A mapping of a file that was
+        // truncated by another program in the meantime would be smaller than that
+        if (this->m_file.getSize() != this->m_pieceTable.getOriginalSize())
+            log::warn("Size of {} changed since it was opened", wolv::util::toUTF8String(this->m_path));
+        else if (this->m_accessMode == AccessMode::Mapped)
+            this->m_file.map();
+
+        // Without a mapping, the file is read through a cache instead, so it needs to stay open
+        if (this->m_file.getMapping() != nullptr) {
+            this->m_file.close();
+        } else {
+            if (this->m_accessMode == AccessMode::DirectIO)
+                this->openDirect();
+
+            auto ioRing = std::make_unique<prv::IoRing>(this->m_ioQueueDepth);
+            if (ioRing->isValid())
+                this->m_ioRing = std::move(ioRing);
+        }
+    }
+
+    void FileProvider::unloadFile() {
+        this->m_cache.clear();
+        this->m_ioRing.reset();
+
         this->m_file.unmap();
+        this->m_file.close();
+
+        #if !defined(OS_WINDOWS)
+            if (this->m_directFd != -1)
+                ::close(this->m_directFd);
+        #endif
+
+        this->m_directFd = -1;
+        this->m_directBuffer = { };
+
+        this->m_fileLoaded = false;
+    }
+
+    void FileProvider::drawInterface() {
+        ImGui::Header("hex.builtin.provider.file.access_mode"_lang, true);
+
+        // Reopening the file would drop inserted and removed bytes that weren't saved yet and pull the mapping out from under tasks using it
+        ImGui::BeginDisabled(this->m_pieceTable.isModified() || areTasksRunning());
+        {
+            auto accessMode = this->m_accessMode;
+            if (ImGui::RadioButton("hex.builtin.provider.file.access_mode.mapped"_lang, accessMode == AccessMode::Mapped))
+                accessMode = AccessMode::Mapped;
+            if (ImGui::RadioButton("hex.builtin.provider.file.access_mode.direct"_lang, accessMode == AccessMode::DirectIO))
+                accessMode = AccessMode::DirectIO;
+
+            if (accessMode != this->m_accessMode) {
+                const auto previousAccessMode = this->m_accessMode;
+
+                this->close();
+                this->m_accessMode = accessMode;
+                if (!this->open()) {
+                    log::error("Failed to reopen {}: {}", wolv::util::toUTF8String(this->m_path), this->getErrorMessage());
+
+                    this->m_accessMode = previousAccessMode;
+                    (void)this->open();
+                }
+            }
+        }
+        ImGui::EndDisabled();
+
+        ImGui::BeginDisabled(this->m_accessMode != AccessMode::DirectIO);
+        {
+            int cacheSize = int(this->m_cache.getBudget() / 0x10'0000);
+            if (ImGui::SliderInt("hex.builtin.provider.file.cache_size"_lang, &cacheSize, 1, 1024, "%d MiB", ImGuiSliderFlags_AlwaysClamp))
+                this->m_cache.setBudget(size_t(cacheSize) * 0x10'0000);
+        }
+        ImGui::EndDisabled();
     }
 
     void FileProvider::loadSettings(const nlohmann::json &settings) {
@@ -293,6 +798,11 @@ namespace hex::plugin::builtin {
         }
         else
             this->setPath(path);
+
+        if (settings.contains("access_mode"))
+            this->m_accessMode = settings["access_mode"].get<std::string>() == "direct" ? AccessMode::DirectIO : AccessMode::Mapped;
+        if (settings.contains("cache_size"))
+            this->m_cache.setBudget(settings["cache_size"].get<size_t>());
     }
 
     nlohmann::json FileProvider::storeSettings(nlohmann::json settings) const {
@@ -302,7 +812,9 @@ namespace hex::plugin::builtin {
         if (path.empty())
             path = wolv::util::toUTF8String(this->m_path);
 
-        settings["path"] = path;
+        settings["path"]        = path;
+        settings["access_mode"] = this->m_accessMode == AccessMode::DirectIO ? "direct" : "mapped";
+        settings["cache_size"]  = this->m_cache.getBudget();
 
         return Provider::storeSettings(settings);
     }
@@ -316,6 +828,80 @@ namespace hex::plugin::builtin {
             return { Region::Invalid(), false };
     }
 
+    std::pair<Region, bool> FileProvider::getZeroRegion(u64 address) const {
+        const u64 offset = address - this->getBaseAddress();
+
+        const auto piece = this->m_pieceTable.getPiece(offset);
+        if (piece == nullptr)
+            return { Region::Invalid(), false };
+
+        u64 runSize = piece->address + piece->size - offset;
+        bool zero;
+
+        if (!piece->originalAddress.has_value()) {
+            // Inserted bytes are zero until something gets written to them
+            zero = piece->data.empty();
+        } else {
+            const u64 originalOffset = *piece->originalAddress + (offset - piece->address);
+
+            auto nextHole = this->m_holes.upper_bound(originalOffset);
+            if (nextHole != this->m_holes.begin() && std::prev(nextHole)->second > originalOffset) {
+                zero    = true;
+                runSize = std::min(runSize, std::prev(nextHole)->second - originalOffset);
+            } else {
+                zero = false;
+                if (nextHole != this->m_holes.end())
+                    runSize = std::min(runSize, nextHole->first - originalOffset);
+            }
+        }
+
+        // Patches and overlays may have put data into the zero bytes
+        if (zero) {
+            if (auto modification = this->findFirstModification({ address, runSize }); modification.has_value()) {
+                if (*modification == address)
+                    zero = false;
+                else
+                    runSize = *modification - address;
+            }
+        }
+
+        return { Region { address, runSize }, zero };
+    }
+
+    void FileProvider::loadHoles() {
+        this->m_holes.clear();
+
+        #if defined(SEEK_HOLE) && defined(SEEK_DATA)
+            // Files with a huge amount of holes are treated as regular data past this point to keep the map small
+            constexpr static size_t MaxHoleCount = 0x1'0000;
+
+            const auto fileHandle = this->m_file.getHandle();
+            if (fileHandle == nullptr)
+                return;
+
+            const int fd        = fileno(fileHandle);
+            const auto fileSize = this->m_file.getSize();
+
+            u64 position = 0;
+            while (position < fileSize && this->m_holes.size() < MaxHoleCount) {
+                const auto holeStart = ::lseek(fd, position, SEEK_HOLE);
+                if (holeStart < 0 || u64(holeStart) >= fileSize)
+                    break;
+
+                // Fails with ENXIO if there's no more data until the end of the file
+                auto dataStart = ::lseek(fd, holeStart, SEEK_DATA);
+                if (dataStart < 0 || u64(dataStart) > fileSize)
+                    dataStart = fileSize;
+
+                if (dataStart <= holeStart)
+                    break;
+
+                this->m_holes[holeStart] = dataStart;
+                position = dataStart;
+            }
+        #endif
+    }
+
     void FileProvider::convertToMemoryFile() {
         auto newProvider = hex::ImHexApi::Provider::createProvider("hex.builtin.provider.mem_file", true);
 
@@ -1,6 +1,8 @@
 #include "content/providers/gdb_provider.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <optional>
 #include <thread>
 #include <chrono>
 
@@ -8,7 +10,6 @@
 #include <hex/ui/imgui_imhex_extensions.h>
 
 #include <hex/helpers/fmt.hpp>
-#include <hex/helpers/crypto.hpp>
 #include <hex/api/localization.hpp>
 
 #include <nlohmann/json.hpp>
@@ -17,179 +18,331 @@ namespace hex::plugin::builtin {
 
     using namespace std::chrono_literals;
 
-    namespace gdb {
+    GDBProvider::GDBProvider() : Provider(), m_size(0xFFFF'FFFF) {
+    }
 
-        namespace {
+    bool GDBProvider::isAvailable() const {
+        return this->m_client.isConnected();
+    }
 
-            u8 calculateChecksum(const std::string &data) {
-                u64 checksum = 0;
+    bool GDBProvider::isReadable() const {
+        return this->m_client.isConnected();
+    }
 
-                for (const auto &c : data)
-                    checksum += c;
+    bool GDBProvider::isWritable() const {
+        return true;
+    }
 
-                return checksum & 0xFF;
-            }
+    bool GDBProvider::isResizable() const {
+        return false;
+    }
 
-            std::string createPacket(const std::string &data) {
-                return hex::format("${}#{:02x}", data, calculateChecksum(data));
-            }
+    bool GDBProvider::isSavable() const {
+        return false;
+    }
 
-            std::optional<std::string> parsePacket(const std::string &packet) {
-                if (packet.length() < 4)
-                    return std::nullopt;
 
-                if (!packet.starts_with('$'))
-                    return std::nullopt;
+    void GDBProvider::read(u64 offset, void *buffer, size_t size, bool overlays) {
+        if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
+            return;
+
+        prv::IoStatistics::ReadScope readScope(this, offset, size);
 
-                if (packet[packet.length() - 3] != '#')
-                    return std::nullopt;
+        offset -= this->getBaseAddress();
 
-                std::string data     = packet.substr(1, packet.length() - 4);
-                std::string checksum = packet.substr(packet.length() - 2, 2);
+        auto bytes = static_cast<u8 *>(buffer);
+        const u64 endOffset = offset + size;
 
-                auto decodedChecksum = crypt::decode16(checksum);
-                if (checksum.length() != 2 || decodedChecksum.empty() || decodedChecksum[0] != calculateChecksum(data))
-                    return std::nullopt;
+        // Copy everything that's cached already and remember which lines are missing
+        std::optional<u64> firstMissingLine, lastMissingLine;
+        {
+            std::scoped_lock lock(this->m_cacheLock);
 
-                return data;
+            const auto now = std::chrono::steady_clock::now();
+            for (u64 lineAddress = offset - (offset % CacheLineSize); lineAddress < endOffset; lineAddress += CacheLineSize) {
+                if (auto cacheLine = this->useCacheLine(lineAddress); cacheLine != nullptr) {
+                    const u64 copyStart = std::max(lineAddress, offset);
+                    const u64 copyEnd   = std::min(lineAddress + CacheLineSize, endOffset);
+
+                    std::memcpy(bytes + (copyStart - offset), cacheLine->data.data() + (copyStart - lineAddress), copyEnd - copyStart);
+                    cacheLine->lastAccess = now;
+                    prv::IoStatistics::recordCacheAccess(true);
+                } else {
+                    prv::IoStatistics::recordCacheAccess(false);
+
+                    if (!firstMissingLine.has_value())
+                        firstMissingLine = lineAddress;
+                    lastMissingLine = lineAddress;
+                }
             }
 
+            // Let the cache update thread load lines for small reads so drawing never has to wait for the target
+            if (firstMissingLine.has_value() && size <= CacheLineSize) {
+                this->requestCacheLine(*firstMissingLine);
+                this->requestCacheLine(*lastMissingLine);
+                firstMissingLine.reset();
+            }
         }
 
-        void sendAck(wolv::net::SocketClient &socket) {
-            socket.writeString("+");
-        }
+        if (firstMissingLine.has_value()) {
+            const u64 missStart = *firstMissingLine;
+            const u64 missEnd   = *lastMissingLine + CacheLineSize;
 
-        void continueExecution(wolv::net::SocketClient &socket) {
-            socket.writeString(createPacket("vCont;c"));
-        }
+            if ((missEnd - missStart) / CacheLineSize > MaxCacheLines) {
+                // Reads larger than the cache would only evict everything else
+                const u64 readStart = std::max(missStart, offset);
+                const u64 readEnd   = std::min(missEnd, endOffset);
 
-        std::vector<u8> readMemory(wolv::net::SocketClient &socket, u64 address, size_t size) {
-            std::string packet = createPacket(hex::format("m{:X},{:X}", address, size));
+                auto data = this->readMemory(readStart, readEnd - readStart);
+                if (!data.empty())
+                    std::memcpy(bytes + (readStart - offset), data.data(), data.size());
+            } else {
+                // Load all missing lines at once. Lines in between that were cached already simply get refreshed
+                auto data = this->readMemory(missStart, missEnd - missStart);
+                if (data.size() == missEnd - missStart) {
+                    const u64 copyStart = std::max(missStart, offset);
+                    const u64 copyEnd   = std::min(missEnd, endOffset);
+                    std::memcpy(bytes + (copyStart - offset), data.data() + (copyStart - missStart), copyEnd - copyStart);
+
+                    std::scoped_lock lock(this->m_cacheLock);
+                    this->storeCacheLines(missStart, data);
+                }
+            }
+        }
 
-            socket.writeString(packet);
+        if (overlays) {
+            this->getPatches().apply(offset + this->getPageSize() * this->m_currPage, buffer, size);
+            this->applyOverlays(offset, buffer, size);
+        }
+    }
 
-            auto receivedPacket = socket.readString(size * 2 + 4);
+    void GDBProvider::readv(std::span<const ReadRequest> requests, bool overlays) {
+        std::vector<ReadRequest> validRequests;
+        validRequests.reserve(requests.size());
 
-            if (receivedPacket.empty())
-                return {};
+        size_t totalSize = 0;
+        for (const auto &request : requests) {
+            if ((request.offset - this->getBaseAddress()) > (this->getActualSize() - request.size) || request.buffer == nullptr || request.size == 0)
+                continue;
 
-            auto receivedData = parsePacket(receivedPacket);
-            if (!receivedData.has_value())
-                return {};
+            validRequests.push_back({ request.offset - this->getBaseAddress(), request.size, request.buffer });
+            totalSize += request.size;
+        }
 
-            if (receivedData->size() == 3 && receivedData->starts_with("E"))
-                return {};
+        if (validRequests.empty())
+            return;
 
-            auto data = crypt::decode16(receivedData.value());
+        prv::IoStatistics::ReadScope readScope(this, requests.front().offset, totalSize);
 
-            data.resize(size);
+        // Copy everything that's cached already and collect the lines that are missing from all requests together
+        std::vector<u64> missingLines;
+        {
+            std::scoped_lock lock(this->m_cacheLock);
 
-            return data;
+            const auto now = std::chrono::steady_clock::now();
+            for (const auto &request : validRequests) {
+                auto bytes = static_cast<u8 *>(request.buffer);
+                const u64 endOffset = request.offset + request.size;
+
+                for (u64 lineAddress = request.offset - (request.offset % CacheLineSize); lineAddress < endOffset; lineAddress += CacheLineSize) {
+                    if (auto cacheLine = this->useCacheLine(lineAddress); cacheLine != nullptr) {
+                        const u64 copyStart = std::max(lineAddress, request.offset);
+                        const u64 copyEnd   = std::min(lineAddress + CacheLineSize, endOffset);
+
+                        std::memcpy(bytes + (copyStart - request.offset), cacheLine->data.data() + (copyStart - lineAddress), copyEnd - copyStart);
+                        cacheLine->lastAccess = now;
+                        prv::IoStatistics::recordCacheAccess(true);
+                    } else {
+                        prv::IoStatistics::recordCacheAccess(false);
+
+                        // Same as in read(), lines of small requests get loaded by the cache update thread so drawing never has to wait for the target
+                        if (request.size <= CacheLineSize)
+                            this->requestCacheLine(lineAddress);
+                        else
+                            missingLines.push_back(lineAddress);
+                    }
+                }
+            }
         }
 
-        void writeMemory(wolv::net::SocketClient &socket, u64 address, const void *buffer, size_t size) {
-            std::vector<u8> bytes(size);
-            std::memcpy(bytes.data(), buffer, size);
+        if (!missingLines.empty()) {
+            // Reads larger than the cache would only evict everything else
+            const bool cacheable = missingLines.size() <= MaxCacheLines;
 
-            std::string byteString = crypt::encode16(bytes);
+            // All missing lines of all requests are read with a single pipelined batch of packets
+            const auto runs = this->mergeCacheLines(std::move(missingLines));
+            const auto runData = this->readMemory(runs);
 
-            std::string packet = createPacket(hex::format("M{:X},{:X}:{}", address, size, byteString));
+            for (size_t i = 0; i < runs.size(); i++) {
+                const auto &run = runs[i];
+                if (runData[i].size() != run.size)
+                    continue;
 
-            socket.writeString(packet);
+                for (const auto &request : validRequests) {
+                    const u64 copyStart = std::max(run.address, request.offset);
+                    const u64 copyEnd   = std::min(run.address + run.size, request.offset + request.size);
+                    if (copyStart < copyEnd)
+                        std::memcpy(static_cast<u8 *>(request.buffer) + (copyStart - request.offset), runData[i].data() + (copyStart - run.address), copyEnd - copyStart);
+                }
 
-            auto receivedPacket = socket.readString(6);
+                if (cacheable) {
+                    std::scoped_lock lock(this->m_cacheLock);
+                    this->storeCacheLines(run.address, runData[i]);
+                }
+            }
         }
 
-        bool enableNoAckMode(wolv::net::SocketClient &socket) {
-            socket.writeString(createPacket("QStartNoAckMode"));
-
-            auto ack = socket.readString(1);
-
-            if (ack.empty() || ack[0] != '+')
-                return false;
+        if (overlays) {
+            for (const auto &request : validRequests) {
+                this->getPatches().apply(request.offset + this->getPageSize() * this->m_currPage, request.buffer, request.size);
+                this->applyOverlays(request.offset, request.buffer, request.size);
+            }
+        }
+    }
 
-            auto receivedPacket = socket.readString(6);
+    bool GDBProvider::isDataAvailable(u64 offset, size_t size) const {
+        if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || size == 0)
+            return true;
 
-            auto receivedData = parsePacket(receivedPacket);
+        offset -= this->getBaseAddress();
 
-            if (receivedData && *receivedData == "OK") {
-                sendAck(socket);
-                return true;
-            } else {
+        std::scoped_lock lock(this->m_cacheLock);
+        for (u64 lineAddress = offset - (offset % CacheLineSize); lineAddress < offset + size; lineAddress += CacheLineSize) {
+            if (!this->m_cacheLookup.contains(lineAddress))
                 return false;
-            }
         }
 
+        return true;
     }
 
-    GDBProvider::GDBProvider() : Provider(), m_size(0xFFFF'FFFF) {
-    }
+    void GDBProvider::prefetch(const Region &region) {
+        if (region.getStartAddress() < this->getBaseAddress() || region.getSize() == 0)
+            return;
 
-    bool GDBProvider::isAvailable() const {
-        return this->m_socket.isConnected();
-    }
+        const u64 offset = region.getStartAddress() - this->getBaseAddress();
+        if (offset >= this->getActualSize())
+            return;
 
-    bool GDBProvider::isReadable() const {
-        return this->m_socket.isConnected();
-    }
+        // Never request more lines than the cache can hold, they would just evict each other again
+        const u64 endOffset = std::min<u64>({ offset + region.getSize(), this->getActualSize(), offset + MaxCacheLines * CacheLineSize });
 
-    bool GDBProvider::isWritable() const {
-        return true;
+        std::scoped_lock lock(this->m_cacheLock);
+        for (u64 lineAddress = offset - (offset % CacheLineSize); lineAddress < endOffset; lineAddress += CacheLineSize) {
+            if (!this->m_cacheLookup.contains(lineAddress))
+                this->requestCacheLine(lineAddress);
+        }
     }
 
-    bool GDBProvider::isResizable() const {
-        return false;
+    GDBProvider::CacheLine *GDBProvider::useCacheLine(u64 alignedOffset) {
+        auto it = this->m_cacheLookup.find(alignedOffset);
+        if (it == this->m_cacheLookup.end())
+            return nullptr;
+
+        this->m_cache.splice(this->m_cache.begin(), this->m_cache, it->second);
+
+        return &*it->second;
     }
 
-    bool GDBProvider::isSavable() const {
-        return false;
+    void GDBProvider::requestCacheLine(u64 alignedOffset) {
+        if (this->m_pendingCacheLineLookup.contains(alignedOffset))
+            return;
+
+        if (this->m_pendingCacheLines.size() >= MaxCacheLines) {
+            this->m_pendingCacheLineLookup.erase(this->m_pendingCacheLines.front());
+            this->m_pendingCacheLines.pop_front();
+        }
+
+        this->m_pendingCacheLines.push_back(alignedOffset);
+        this->m_pendingCacheLineLookup.insert(alignedOffset);
     }
 
+    void GDBProvider::storeCacheLines(u64 alignedOffset, const std::vector<u8> &data) {
+        for (u64 dataOffset = 0; dataOffset + CacheLineSize <= data.size(); dataOffset += CacheLineSize) {
+            const u64 lineAddress = alignedOffset + dataOffset;
 
-    void GDBProvider::read(u64 offset, void *buffer, size_t size, bool overlays) {
-        if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
+            auto it = this->m_cacheLookup.find(lineAddress);
+            if (it == this->m_cacheLookup.end()) {
+                while (this->m_cache.size() >= MaxCacheLines) {
+                    this->m_cacheLookup.erase(this->m_cache.back().address);
+                    this->m_cache.pop_back();
+                }
+
+                this->m_cache.push_front({ lineAddress, { }, { } });
+                it = this->m_cacheLookup.emplace(lineAddress, this->m_cache.begin()).first;
+            }
+
+            std::memcpy(it->second->data.data(), data.data() + dataOffset, CacheLineSize);
+        }
+    }
+
+    void GDBProvider::invalidateCacheLines(u64 offset, size_t size) {
+        if (size == 0)
             return;
 
-        offset -= this->getBaseAddress();
+        std::scoped_lock lock(this->m_cacheLock);
+        for (u64 lineAddress = offset - (offset % CacheLineSize); lineAddress < offset + size; lineAddress += CacheLineSize) {
+            if (auto it = this->m_cacheLookup.find(lineAddress); it != this->m_cacheLookup.end()) {
+                this->m_cache.erase(it->second);
+                this->m_cacheLookup.erase(it);
+            }
+        }
+    }
 
-        u64 alignedOffset = offset - (offset % CacheLineSize);
+    std::vector<gdb::Client::MemoryRange> GDBProvider::mergeCacheLines(std::vector<u64> addresses) const {
+        // Reading a few bytes more is a lot cheaper than another round trip to the target
+        constexpr static u64 MaxGapSize = 4 * CacheLineSize;
 
-        if (size <= CacheLineSize) {
-            std::scoped_lock lock(this->m_cacheLock);
+        // Merged runs are kept small enough to be read with a single packet
+        const u64 maxReadSize = std::max<u64>(this->m_client.getMaxReadSize(), CacheLineSize);
 
-            const auto &cacheLine = std::find_if(this->m_cache.begin(), this->m_cache.end(), [&](auto &line) {
-                return line.address == alignedOffset;
-            });
+        std::sort(addresses.begin(), addresses.end());
+        addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
 
-            if (cacheLine != this->m_cache.end()) {
-                // Cache hit
+        std::vector<gdb::Client::MemoryRange> result;
+        for (auto it = addresses.begin(); it != addresses.end();) {
+            const u64 runStart = *it;
+            u64 runEnd = runStart + CacheLineSize;
 
-            } else {
-                // Cache miss
+            for (++it; it != addresses.end() && *it <= runEnd + MaxGapSize && (*it + CacheLineSize - runStart) <= maxReadSize; ++it)
+                runEnd = *it + CacheLineSize;
 
-                this->m_cache.push_back({ alignedOffset, { 0 } });
-            }
+            result.push_back({ runStart, runEnd - runStart });
+        }
 
-            if (cacheLine != this->m_cache.end())
-                std::memcpy(buffer, &cacheLine->data[0] + (offset % CacheLineSize), std::min(size, cacheLine->data.size()));
-        } else {
-            while (size > 0) {
-                size_t readSize = std::min(size, CacheLineSize);
-                this->readRaw(offset, buffer, readSize);
+        return result;
+    }
 
-                size -= readSize;
-                offset += readSize;
-            }
+    void GDBProvider::loadCacheLines(std::vector<u64> addresses) {
+        // All runs are requested in one pipelined batch
+        const auto runs = this->mergeCacheLines(std::move(addresses));
+        const auto runData = this->readMemory(runs);
+
+        std::scoped_lock lock(this->m_cacheLock);
+        for (size_t i = 0; i < runs.size(); i++) {
+            if (runData[i].size() == runs[i].size)
+                this->storeCacheLines(runs[i].address, runData[i]);
         }
+    }
 
-        if (overlays) {
-            for (u64 i = 0; i < size; i++)
-                if (getPatches().contains(offset + i))
-                    reinterpret_cast<u8 *>(buffer)[i] = getPatches()[offset + this->getPageSize() * this->m_currPage + i];
+    std::vector<u8> GDBProvider::readMemory(u64 address, size_t size) {
+        std::scoped_lock lock(this->m_socketLock);
 
-            this->applyOverlays(offset, buffer, size);
+        return this->m_client.readMemory(address, size);
+    }
+
+    std::vector<std::vector<u8>> GDBProvider::readMemory(std::span<const gdb::Client::MemoryRange> ranges) {
+        std::scoped_lock lock(this->m_socketLock);
+
+        return this->m_client.readMemory(ranges);
+    }
+
+    void GDBProvider::writeMemory(u64 address, const void *buffer, size_t size) {
+        {
+            std::scoped_lock lock(this->m_socketLock);
+            this->m_client.writeMemory(address, buffer, size);
         }
+
+        this->invalidateCacheLines(address, size);
     }
 
     void GDBProvider::write(u64 offset, const void *buffer, size_t size) {
@@ -198,14 +351,14 @@ namespace hex::plugin::builtin {
 
         offset -= this->getBaseAddress();
 
-        gdb::writeMemory(this->m_socket, offset, buffer, size);
+        this->writeMemory(offset, buffer, size);
     }
 
     void GDBProvider::readRaw(u64 offset, void *buffer, size_t size) {
         if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
             return;
 
-        auto data = gdb::readMemory(this->m_socket, offset, size);
+        auto data = this->readMemory(offset, size);
         if (!data.empty())
             std::memcpy(buffer, &data[0], data.size());
     }
@@ -214,7 +367,7 @@ namespace hex::plugin::builtin {
         if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
             return;
 
-        gdb::writeMemory(this->m_socket, offset, buffer, size);
+        this->writeMemory(offset, buffer, size);
     }
 
     void GDBProvider::save() {
@@ -245,45 +398,57 @@ namespace hex::plugin::builtin {
     }
 
     bool GDBProvider::open() {
-        this->m_socket = wolv::net::SocketClient(wolv::net::SocketClient::Type::TCP);
-        this->m_socket.connect(this->m_ipAddress, this->m_port);
-        if (!gdb::enableNoAckMode(this->m_socket)) {
-            this->m_socket.disconnect();
+        if (!this->m_client.connect(this->m_ipAddress, this->m_port))
             return false;
-        }
 
-        if (this->m_socket.isConnected()) {
-            gdb::continueExecution(this->m_socket);
+        if (this->m_client.isConnected()) {
+            this->m_client.continueExecution();
 
             this->m_cacheUpdateThread = std::thread([this]() {
-                auto cacheLine = this->m_cache.begin();
+                // Lines that were read within this time are considered visible and are kept up to date
+                constexpr static auto VisibleTimeout  = 500ms;
+                constexpr static auto RefreshInterval = 100ms;
+
+                // Limits how many requested lines are loaded before checking for new requests again
+                const size_t maxPendingBatchSize = std::max<size_t>(this->m_client.getMaxReadSize() / CacheLineSize, 1);
+
+                auto lastRefresh = std::chrono::steady_clock::time_point();
                 while (this->isConnected()) {
+                    std::vector<u64> addresses;
                     {
                         std::scoped_lock lock(this->m_cacheLock);
 
                         if (this->m_resetCache) {
                             this->m_cache.clear();
+                            this->m_cacheLookup.clear();
+                            this->m_pendingCacheLines.clear();
+                            this->m_pendingCacheLineLookup.clear();
                             this->m_resetCache = false;
-                            cacheLine = this->m_cache.begin();
                         }
 
-                        if (cacheLine != this->m_cache.end()) {
-                            std::vector<u8> data = gdb::readMemory(this->m_socket, cacheLine->address, CacheLineSize);
-
-                            while (std::count_if(this->m_cache.begin(), this->m_cache.end(), [&](auto &line) { return !line.data.empty(); }) > 100) {
-                                this->m_cache.pop_front();
-                                cacheLine = this->m_cache.begin();
+                        const auto now = std::chrono::steady_clock::now();
+                        if (!this->m_pendingCacheLines.empty()) {
+                            // Load the most recently requested lines first, they're the ones most likely to be on screen
+                            while (!this->m_pendingCacheLines.empty() && addresses.size() < maxPendingBatchSize) {
+                                addresses.push_back(this->m_pendingCacheLines.back());
+                                this->m_pendingCacheLineLookup.erase(this->m_pendingCacheLines.back());
+                                this->m_pendingCacheLines.pop_back();
+                            }
+                        } else if (now - lastRefresh >= RefreshInterval) {
+                            // Only refresh what's currently being looked at instead of going through every cached line
+                            for (const auto &cacheLine : this->m_cache) {
+                                if (now - cacheLine.lastAccess < VisibleTimeout)
+                                    addresses.push_back(cacheLine.address);
                             }
 
-                            std::memcpy(cacheLine->data.data(), data.data(), data.size());
+                            lastRefresh = now;
                         }
-
-                        if (cacheLine == this->m_cache.end())
-                            cacheLine = this->m_cache.begin();
-                        else
-                            cacheLine++;
                     }
-                    std::this_thread::sleep_for(10ms);
+
+                    if (!addresses.empty())
+                        this->loadCacheLines(std::move(addresses));
+                    else
+                        std::this_thread::sleep_for(10ms);
                 }
             });
 
@@ -294,7 +459,7 @@ namespace hex::plugin::builtin {
     }
 
     void GDBProvider::close() {
-        this->m_socket.disconnect();
+        this->m_client.disconnect();
 
         if (this->m_cacheUpdateThread.joinable()) {
             this->m_cacheUpdateThread.join();
@@ -302,7 +467,7 @@ namespace hex::plugin::builtin {
     }
 
     bool GDBProvider::isConnected() const {
-        return this->m_socket.isConnected();
+        return this->m_client.isConnected();
     }
 
 
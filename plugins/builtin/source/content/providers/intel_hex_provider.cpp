@@ -1,7 +1,13 @@
 #include "content/providers/intel_hex_provider.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <memory>
+#include <numeric>
+#include <string_view>
 
+#include <hex/api/event.hpp>
 #include <hex/api/imhex_api.hpp>
 #include <hex/api/localization.hpp>
 #include <hex/helpers/utils.hpp>
@@ -27,18 +33,47 @@ namespace hex::plugin::builtin {
                 throw std::runtime_error("Failed to parse hex digit");
         }
 
-        std::map<u64, std::vector<u8>> parseIntelHex(const std::string &string) {
-            std::map<u64, std::vector<u8>> result;
+        /**
+         * @brief Parses Intel HEX records as the file is read, merging records that directly follow each other into one chunk
+         */
+        class Parser {
+        public:
+            /**
+             * @brief Parses the next part of the file. Records may be split across multiple parts
+             */
+            void feed(std::string_view data) {
+                // Only whole lines are parsed, whatever comes after the last line break is kept until the rest of it arrives
+                const auto firstLineEnd = data.find_first_of("\r\n");
+                if (firstLineEnd == std::string_view::npos) {
+                    this->m_remainder.append(data);
+                    return;
+                }
+
+                const auto lastLineEnd = data.find_last_of("\r\n");
+
+                this->m_remainder.append(data.substr(0, firstLineEnd));
+                this->parseLines(this->m_remainder);
+                this->m_remainder.clear();
+
+                this->parseLines(data.substr(firstLineEnd, lastLineEnd - firstLineEnd));
+                this->m_remainder.assign(data.substr(lastLineEnd + 1));
+            }
 
-            u8 checksum = 0x00;
-            u64 offset = 0x00;
+            /**
+             * @brief Parses whatever is left of the file
+             * @return Chunks of data in the order they appeared in the file
+             */
+            std::vector<IntelHexProvider::Chunk> finish() {
+                this->parseLines(this->m_remainder);
+                this->m_remainder.clear();
 
-            u8 byteCount = 0x00;
-            u32 segmentAddress = 0x0000'0000;
-            u32 extendedLinearAddress = 0x0000'0000;
-            u16 address = 0x0000;
-            std::vector<u8> data;
+                if (this->m_chunks.empty())
+                    throw std::runtime_error("No data records found");
 
+                return std::move(this->m_chunks);
+            }
+
+        private:
             enum class RecordType {
                 Data                    = 0x00,
                 EndOfFile               = 0x01,
@@ -46,142 +81,190 @@ namespace hex::plugin::builtin {
                 StartSegmentAddress     = 0x03,
                 ExtendedLinearAddress   = 0x04,
                 StartLinearAddress      = 0x05
-            } recordType;
+            };
 
-            auto c = [&]() {
-                while (std::isspace(string[offset]) && offset < string.length())
-                    offset++;
+            void parseLines(std::string_view lines) {
+                size_t offset = 0;
+                while (true) {
+                    while (offset < lines.size() && std::isspace(u8(lines[offset])))
+                        offset++;
 
-                if (offset >= string.length())
-                    throw std::runtime_error("Unexpected end of file");
+                    if (offset >= lines.size())
+                        break;
 
-                return string[offset++];
-            };
+                    // Parse start code
+                    if (lines[offset] != ':')
+                        throw std::runtime_error("Expected start code");
 
-            auto parseValue = [&](u8 byteCount) {
-                u64 value = 0x00;
-                for (u8 i = 0; i < byteCount; i++) {
-                    u8 byte = (parseHexDigit(c()) << 4) | parseHexDigit(c());
-                    value <<= 8;
-                    value |= byte;
+                    auto recordEnd = offset + 1;
+                    while (recordEnd < lines.size() && !std::isspace(u8(lines[recordEnd])))
+                        recordEnd++;
 
-                    checksum += byte;
+                    this->parseRecord(lines.substr(offset + 1, recordEnd - offset - 1));
+                    offset = recordEnd;
                 }
+            }
 
+            void parseRecord(std::string_view record) {
+                if (this->m_endOfFile)
+                    throw std::runtime_error("Unexpected end of file");
 
-                return value;
-            };
+                // Byte count, address, record type and checksum take up five bytes
+                if (record.size() % 2 != 0 || record.size() < 5 * 2)
+                    throw std::runtime_error("Unexpected end of record");
 
-            bool endOfFile = false;
-            try {
-                while (offset < string.length()) {
-                    // Parse start code
-                    if (c() != ':')
-                        return { };
+                const size_t size = record.size() / 2;
+                u8 checksum = 0x00;
+                for (size_t i = 0; i < size; i++) {
+                    this->m_record[i] = (parseHexDigit(record[i * 2]) << 4) | parseHexDigit(record[i * 2 + 1]);
+                    checksum += this->m_record[i];
+                }
 
-                    checksum = 0x00;
+                const u8 byteCount = this->m_record[0];
+                if (size != byteCount + 5u)
+                    throw std::runtime_error("Unexpected byte count");
 
-                    if (endOfFile)
-                        throw std::runtime_error("Unexpected end of file");
+                if (byteCount != 0 && checksum != 0x00)
+                    throw std::runtime_error("Checksum mismatch");
 
-                    // Parse byte count
-                    byteCount = parseValue(1);
+                const u16 address = (this->m_record[1] << 8) | this->m_record[2];
+                const auto recordType = static_cast<RecordType>(this->m_record[3]);
+                const u8 *data = &this->m_record[4];
 
-                    // Parse address
-                    address = parseValue(2);
+                // Construct region
+                switch (recordType) {
+                    case RecordType::Data: {
+                        if (byteCount == 0)
+                            break;
 
-                    // Parse record type
-                    recordType = static_cast<RecordType>(parseValue(1));
+                        const u64 dataAddress = this->m_extendedLinearAddress | (this->m_segmentAddress + address);
 
-                    data.clear();
-                    for (u32 i = 0; i < byteCount; i++) {
-                        data.push_back(parseValue(1));
+                        // Records usually follow each other directly and end up in one large chunk
+                        if (this->m_chunks.empty() || this->m_chunks.back().address + this->m_chunks.back().data.size() != dataAddress)
+                            this->m_chunks.push_back({ dataAddress, { } });
+
+                        this->m_chunks.back().data.insert(this->m_chunks.back().data.end(), data, data + byteCount);
+                        break;
+                    }
+                    case RecordType::EndOfFile: {
+                        this->m_endOfFile = true;
+                        break;
                     }
+                    case RecordType::ExtendedSegmentAddress: {
+                        if (byteCount != 2)
+                            throw std::runtime_error("Unexpected byte count");
 
-                    parseValue(1);
-                    if (!data.empty() && checksum != 0x00)
-                        throw std::runtime_error("Checksum mismatch");
+                        this->m_segmentAddress = (data[0] << 8 | data[1]) * 16;
+                        break;
+                    }
+                    case RecordType::StartSegmentAddress: {
+                        if (byteCount != 4)
+                            throw std::runtime_error("Unexpected byte count");
 
-                    while (std::isspace(string[offset]) && offset < string.length())
-                        offset++;
+                        // Can be safely ignored
+                        break;
+                    }
+                    case RecordType::ExtendedLinearAddress: {
+                        if (byteCount != 2)
+                            throw std::runtime_error("Unexpected byte count");
 
-                    // Construct region
-                    switch (recordType) {
-                        case RecordType::Data: {
-                            result[extendedLinearAddress | (segmentAddress + address)] = data;
-                            break;
-                        }
-                        case RecordType::EndOfFile: {
-                            endOfFile = true;
-                            break;
-                        }
-                        case RecordType::ExtendedSegmentAddress: {
-                            if (byteCount != 2)
-                                throw std::runtime_error("Unexpected byte count");
+                        this->m_extendedLinearAddress = (data[0] << 8 | data[1]) << 16;
+                        break;
+                    }
+                    case RecordType::StartLinearAddress: {
+                        if (byteCount != 4)
+                            throw std::runtime_error("Unexpected byte count");
 
-                            segmentAddress = (data[0] << 8 | data[1]) * 16;
-                            break;
-                        }
-                        case RecordType::StartSegmentAddress: {
-                            if (byteCount != 4)
-                                throw std::runtime_error("Unexpected byte count");
+                        // Can be safely ignored
+                        break;
+                    }
+                }
+            }
 
-                            // Can be safely ignored
-                            break;
-                        }
-                        case RecordType::ExtendedLinearAddress: {
-                            if (byteCount != 2)
-                                throw std::runtime_error("Unexpected byte count");
+            std::string m_remainder;
+            std::vector<IntelHexProvider::Chunk> m_chunks;
 
-                            extendedLinearAddress = (data[0] << 8 | data[1]) << 16;
-                            break;
-                        }
-                        case RecordType::StartLinearAddress: {
-                            if (byteCount != 4)
-                                throw std::runtime_error("Unexpected byte count");
+            std::array<u8, 0xFF + 5> m_record = { };
+            u32 m_segmentAddress = 0x0000'0000;
+            u32 m_extendedLinearAddress = 0x0000'0000;
+            bool m_endOfFile = false;
+        };
 
-                            // Can be safely ignored
-                            break;
-                        }
-                    }
+    }
 
-                    while (std::isspace(string[offset]) && offset < string.length())
-                        offset++;
+    std::vector<IntelHexProvider::Chunk> IntelHexProvider::mergeChunks(std::vector<Chunk> chunks) {
+        std::erase_if(chunks, [](const Chunk &chunk) { return chunk.data.empty(); });
+
+        // Sort indices instead of the chunks themselves so it's still known which chunk came later in the file
+        std::vector<size_t> order(chunks.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return chunks[a].address < chunks[b].address; });
+
+        std::vector<Chunk> result;
+        for (size_t i = 0; i < order.size();) {
+            const u64 start = chunks[order[i]].address;
+            u64 end = start + chunks[order[i]].data.size();
+
+            size_t groupEnd = i + 1;
+            for (; groupEnd < order.size() && chunks[order[groupEnd]].address <= end; groupEnd++)
+                end = std::max<u64>(end, chunks[order[groupEnd]].address + chunks[order[groupEnd]].data.size());
+
+            if (groupEnd == i + 1) {
+                result.push_back(std::move(chunks[order[i]]));
+            } else {
+                // Copy the chunks in file order so bytes that were defined multiple times end up with their last value
+                std::sort(order.begin() + i, order.begin() + groupEnd);
+
+                Chunk merged = { start, std::vector<u8>(end - start) };
+                for (size_t j = i; j < groupEnd; j++) {
+                    const auto &chunk = chunks[order[j]];
+                    std::copy(chunk.data.begin(), chunk.data.end(), merged.data.begin() + (chunk.address - start));
                 }
 
-            } catch (const std::runtime_error &e) {
-                return { };
+                result.push_back(std::move(merged));
             }
 
-            return result;
+            i = groupEnd;
         }
 
+        return result;
     }
 
-    void IntelHexProvider::setBaseAddress(u64 address) {
-        auto oldBase = this->getBaseAddress();
-
-        auto regions = this->m_data.overlapping({ oldBase, oldBase + this->getActualSize() });
+    void IntelHexProvider::setChunks(std::vector<Chunk> chunks) {
+        std::scoped_lock lock(this->m_chunkMutex);
 
-        decltype(this->m_data) newIntervals;
-        for (auto &[interval, data] : regions) {
-            newIntervals.insert({ interval.start - oldBase + address, interval.end - oldBase + address }, *data);
-        }
-        this->m_data = newIntervals;
-
-        Provider::setBaseAddress(address);
+        this->m_dataSize = chunks.empty() ? 0 : chunks.back().address + chunks.back().data.size();
+        this->m_chunks   = std::move(chunks);
     }
 
     void IntelHexProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        auto intervals = this->m_data.overlapping({ offset, (offset + size) - 1 });
+        auto bytes = static_cast<u8 *>(buffer);
+        const u64 endOffset = offset + size;
 
-        std::memset(buffer, 0x00, size);
-        auto bytes = reinterpret_cast<u8*>(buffer);
-        for (const auto &[interval, data] : intervals) {
-            for (u32 i = std::max(interval.start, offset); i <= interval.end && (i - offset) < size; i++) {
-                bytes[i - offset] = (*data)[i - interval.start];
-            }
+        std::scoped_lock lock(this->m_chunkMutex);
+
+        // Start at the last chunk that begins at or before the offset, it may still contain the start of the range
+        auto it = std::upper_bound(this->m_chunks.begin(), this->m_chunks.end(), offset, [](u64 value, const Chunk &chunk) { return value < chunk.address; });
+        if (it != this->m_chunks.begin())
+            --it;
+
+        // Bytes that aren't part of any record read as zero
+        u64 position = offset;
+        for (; it != this->m_chunks.end() && it->address < endOffset; ++it) {
+            const u64 chunkEnd = it->address + it->data.size();
+            if (chunkEnd <= position)
+                continue;
+
+            const u64 copyStart = std::max(position, it->address);
+            const u64 copyEnd   = std::min(chunkEnd, endOffset);
+
+            std::memset(bytes + (position - offset), 0x00, copyStart - position);
+            std::memcpy(bytes + (copyStart - offset), it->data.data() + (copyStart - it->address), copyEnd - copyStart);
+
+            position = copyEnd;
         }
+
+        std::memset(bytes + (position - offset), 0x00, endOffset - position);
     }
 
     void IntelHexProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
@@ -197,27 +280,77 @@ namespace hex::plugin::builtin {
         if (!file.isValid())
             return false;
 
-        auto data = intel_hex::parseIntelHex(file.readString());
-        if (data.empty())
-            return false;
+        this->m_dataValid = true;
 
-        u64 maxAddress = 0x00;
-        for (auto &[address, bytes] : data) {
-            auto endAddress = (address + bytes.size()) - 1;
-            this->m_data.emplace({ address, endAddress }, std::move(bytes));
+        // Large files take a while to parse, so the data only shows up once the parser is done with them.
+        // The task looks the provider up by its ID as it may have been closed or even reopened by then
+        const auto generation = ++this->m_loadGeneration;
+        this->m_loadingTask = TaskManager::createTask("hex.builtin.provider.intel_hex.parsing", file.getSize(), [providerId = this->getID(), generation, path = this->m_sourceFilePath](Task &task) {
+            const auto getProvider = [providerId, generation]() -> IntelHexProvider * {
+                auto provider = dynamic_cast<IntelHexProvider *>(ImHexApi::Provider::getById(providerId));
+                if (provider == nullptr || provider->m_loadGeneration != generation)
+                    return nullptr;
 
-            if (endAddress > maxAddress)
-                maxAddress = endAddress;
-        }
+                return provider;
+            };
 
-        this->m_dataSize = maxAddress + 1;
-        this->m_dataValid = true;
+            const auto removeProvider = [getProvider] {
+                TaskManager::doLater([getProvider] {
+                    if (auto provider = getProvider(); provider != nullptr)
+                        ImHexApi::Provider::remove(provider);
+                });
+            };
+
+            task.setInterruptCallback(removeProvider);
+
+            auto file = wolv::io::File(path, wolv::io::File::Mode::Read);
+            if (!file.isValid()) {
+                removeProvider();
+                throw std::runtime_error(hex::format("Failed to open {}", wolv::util::toUTF8String(path)));
+            }
+
+            constexpr static size_t BufferSize = 0x10'0000;
+            std::vector<u8> buffer(BufferSize);
+
+            auto chunks = std::make_shared<std::vector<Chunk>>();
+            try {
+                intel_hex::Parser parser;
+
+                const auto fileSize = file.getSize();
+                for (u64 offset = 0; offset < fileSize; offset += BufferSize) {
+                    const auto readSize = std::min<u64>(BufferSize, fileSize - offset);
+                    file.readBuffer(buffer.data(), readSize);
+
+                    parser.feed({ reinterpret_cast<const char *>(buffer.data()), readSize });
+                    task.update(offset);
+                }
+
+                *chunks = mergeChunks(parser.finish());
+            } catch (const std::runtime_error &) {
+                removeProvider();
+                throw;
+            }
+
+            TaskManager::doLater([getProvider, chunks] {
+                auto provider = getProvider();
+                if (provider == nullptr)
+                    return;
+
+                provider->setChunks(std::move(*chunks));
+
+                // Everything that looked at the still empty provider after it got opened needs to do so again
+                EventManager::post<EventProviderDataReloaded>(provider);
+                EventManager::post<EventDataChanged>();
+            });
+        });
 
         return true;
     }
 
     void IntelHexProvider::close() {
-
+        // Keeps the loading task from removing the provider when it gets interrupted here
+        this->m_loadGeneration++;
+        this->m_loadingTask.interrupt();
     }
 
     [[nodiscard]] std::string IntelHexProvider::getName() const {
@@ -261,18 +394,34 @@ namespace hex::plugin::builtin {
     }
 
     std::pair<Region, bool> IntelHexProvider::getRegionValidity(u64 address) const {
-        auto intervals = this->m_data.overlapping({ address, address });
-        if (intervals.empty()) {
-            return Provider::getRegionValidity(address);
-        }
+        const u64 offset = address - this->getBaseAddress();
+        if (offset >= this->getActualSize())
+            return { Region::Invalid(), false };
+
+        u64 gapEnd;
+        {
+            std::scoped_lock lock(this->m_chunkMutex);
+
+            auto it = std::upper_bound(this->m_chunks.begin(), this->m_chunks.end(), offset, [](u64 value, const Chunk &chunk) { return value < chunk.address; });
+            if (it != this->m_chunks.begin()) {
+                const auto &chunk = *std::prev(it);
+                if (offset < chunk.address + chunk.data.size())
+                    return { Region { address, chunk.address + chunk.data.size() - offset }, true };
+            }
 
-        decltype(this->m_data)::Interval closestInterval = { 0, 0 };
-        for (const auto &[interval, data] : intervals) {
-            if (interval.start <= closestInterval.end)
-                closestInterval = interval;
+            gapEnd = it != this->m_chunks.end() ? it->address : this->getActualSize();
         }
-        return { Region { closestInterval.start, (closestInterval.end - closestInterval.start) + 1}, true };
 
+        // Between two chunks only patches and overlays hold any data
+        auto [region, valid] = Provider::getRegionValidity(address);
+        if (valid)
+            return { region, true };
+
+        u64 end = gapEnd + this->getBaseAddress();
+        if (region.getSize() != 0)
+            end = std::min<u64>(end, region.getEndAddress() + 1);
+
+        return { Region { address, end - address }, false };
     }
 
     void IntelHexProvider::loadSettings(const nlohmann::json &settings) {
@@ -2,7 +2,7 @@
 #include "content/providers/file_provider.hpp"
 #include "content/popups/popup_text_input.hpp"
 
-#include <cstring>
+#include <algorithm>
 
 #include <hex/api/imhex_api.hpp>
 #include <hex/api/localization.hpp>
@@ -13,7 +13,7 @@
 namespace hex::plugin::builtin {
 
     bool MemoryFileProvider::open() {
-        if (this->m_data.empty()) {
+        if (this->m_data.getSize() == 0) {
             this->m_data.resize(1);
             this->markDirty();
         }
@@ -21,18 +21,28 @@ namespace hex::plugin::builtin {
         return true;
     }
 
+    std::optional<std::span<const u8>> MemoryFileProvider::tryGetSpan(u64 offset, size_t size) {
+        if (size == 0 || size > this->getActualSize() || (offset - this->getBaseAddress()) > (this->getActualSize() - size))
+            return std::nullopt;
+
+        if (!this->isUnmodified(offset, size))
+            return std::nullopt;
+
+        return this->m_data.getSpan(offset - this->getBaseAddress(), size);
+    }
+
     void MemoryFileProvider::readRaw(u64 offset, void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, &this->m_data.front() + offset, size);
+        this->m_data.read(offset, static_cast<u8 *>(buffer), size);
     }
 
     void MemoryFileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(&this->m_data.front() + offset, buffer, size);
+        this->m_data.write(offset, static_cast<const u8 *>(buffer), size);
     }
 
     void MemoryFileProvider::save() {
@@ -62,51 +72,37 @@ namespace hex::plugin::builtin {
     }
 
     void MemoryFileProvider::resize(size_t newSize) {
+        const auto oldSize = this->getActualSize();
+        this->materializeSnapshots({ this->getBaseAddress() + std::min(oldSize, newSize), std::max(oldSize, newSize) - std::min(oldSize, newSize) });
+
         this->m_data.resize(newSize);
 
         Provider::resize(newSize);
     }
 
     void MemoryFileProvider::insert(u64 offset, size_t size) {
-        auto oldSize = this->getActualSize();
-        this->resize(oldSize + size);
-
-        std::vector<u8> buffer(0x1000);
-        const std::vector<u8> zeroBuffer(0x1000);
-
-        auto position = oldSize;
-        while (position > offset) {
-            const auto readSize = std::min<size_t>(position - offset, buffer.size());
+        if (offset > this->getActualSize() || size == 0)
+            return;
 
-            position -= readSize;
+        // Everything after the inserted bytes moves, so snapshots need to hold on to the old data
+        this->materializeSnapshots({ this->getBaseAddress() + offset, this->getActualSize() - offset });
 
-            this->readRaw(position, buffer.data(), readSize);
-            this->writeRaw(position, zeroBuffer.data(), readSize);
-            this->writeRaw(position + size, buffer.data(), readSize);
-        }
+        this->m_data.insert(offset, size);
 
+        Provider::resize(this->getActualSize());
         Provider::insert(offset, size);
     }
 
     void MemoryFileProvider::remove(u64 offset, size_t size) {
-        auto oldSize = this->getActualSize();
-        this->resize(oldSize + size);
-
-        std::vector<u8> buffer(0x1000);
-
-        const auto newSize = oldSize - size;
-        auto position = offset;
-        while (position < newSize) {
-            const auto readSize = std::min<size_t>(newSize - position, buffer.size());
-
-            this->readRaw(position + size, buffer.data(), readSize);
-            this->writeRaw(position, buffer.data(), readSize);
+        if (offset > this->getActualSize() || size == 0)
+            return;
 
-            position += readSize;
-        }
+        size = std::min<u64>(size, this->getActualSize() - offset);
+        this->materializeSnapshots({ this->getBaseAddress() + offset, this->getActualSize() - offset });
 
-        this->resize(newSize);
+        this->m_data.remove(offset, size);
 
+        Provider::resize(this->getActualSize());
         Provider::insert(offset, size);
         Provider::remove(offset, size);
     }
@@ -136,13 +132,13 @@ namespace hex::plugin::builtin {
     void MemoryFileProvider::loadSettings(const nlohmann::json &settings) {
         Provider::loadSettings(settings);
 
-        this->m_data = settings["data"].get<std::vector<u8>>();
+        this->m_data = prv::GapBuffer(settings["data"].get<std::vector<u8>>());
         this->m_name = settings["name"].get<std::string>();
         this->m_readOnly = settings["readOnly"].get<bool>();
     }
 
     [[nodiscard]] nlohmann::json MemoryFileProvider::storeSettings(nlohmann::json settings) const {
-        settings["data"] = this->m_data;
+        settings["data"] = this->m_data.toVector();
         settings["name"] = this->m_name;
         settings["readOnly"] = this->m_readOnly;
 
@@ -179,16 +179,11 @@ namespace hex::plugin::builtin {
         if (data.empty())
             return false;
 
-        u64 maxAddress = 0x00;
-        for (auto &[address, bytes] : data) {
-            auto endAddress = (address + bytes.size()) - 1;
-            this->m_data.emplace({ address, endAddress }, std::move(bytes));
+        std::vector<Chunk> chunks;
+        for (auto &[address, bytes] : data)
+            chunks.push_back({ address, std::move(bytes) });
 
-            if (endAddress > maxAddress)
-                maxAddress = endAddress;
-        }
-
-        this->m_dataSize = maxAddress + 1;
+        this->setChunks(mergeChunks(std::move(chunks)));
         this->m_dataValid = true;
 
         return true;
@@ -0,0 +1,426 @@
+#if defined(OS_LINUX)
+
+#include <content/providers/process_memory_provider.hpp>
+
+#include <imgui.h>
+#include <hex/ui/imgui_imhex_extensions.h>
+#include <hex/api/imhex_api.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/helpers/fmt.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace hex::plugin::builtin {
+
+    namespace {
+
+        #if defined(IOV_MAX)
+            constexpr static size_t MaxIoVectors = IOV_MAX;
+        #else
+            constexpr static size_t MaxIoVectors = 1024;
+        #endif
+
+        std::optional<u64> parseHexNumber(std::string_view string) {
+            u64 value = 0;
+            if (auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), value, 16); error != std::errc() || end != string.data() + string.size())
+                return std::nullopt;
+
+            return value;
+        }
+
+    }
+
+    bool ProcessMemoryProvider::open() {
+        if (this->m_selectedProcess == nullptr)
+            return false;
+
+        const auto memPath = hex::format("/proc/{}/mem", this->m_selectedProcess->id);
+
+        this->m_memoryFd = ::open(memPath.c_str(), O_RDWR | O_CLOEXEC);
+        this->m_writable = this->m_memoryFd != -1;
+        if (this->m_memoryFd == -1)
+            this->m_memoryFd = ::open(memPath.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (this->m_memoryFd == -1)
+            return false;
+
+        this->m_vmReadvSupported = true;
+        this->reloadMemoryRegions();
+
+        return true;
+    }
+
+    void ProcessMemoryProvider::close() {
+        if (this->m_memoryFd != -1)
+            ::close(this->m_memoryFd);
+
+        this->m_memoryFd = -1;
+        this->m_writable = false;
+    }
+
+    void ProcessMemoryProvider::collectTransfers(u64 address, u8 *buffer, size_t size, std::vector<Transfer> &transfers) const {
+        // Unmapped memory reads as zero
+        std::memset(buffer, 0x00, size);
+
+        const u64 endAddress = address + size;
+
+        auto region = std::upper_bound(this->m_readableRegions.begin(), this->m_readableRegions.end(), address, [](u64 value, const Region &region) {
+            return value < region.getStartAddress();
+        });
+        if (region != this->m_readableRegions.begin())
+            region = std::prev(region);
+
+        for (; region != this->m_readableRegions.end() && region->getStartAddress() < endAddress; ++region) {
+            const u64 start = std::max(address, region->getStartAddress());
+            const u64 end   = std::min(endAddress, region->getStartAddress() + region->getSize());
+            if (start >= end)
+                continue;
+
+            transfers.push_back({ start, buffer + (start - address), end - start });
+        }
+    }
+
+    void ProcessMemoryProvider::readTransfers(std::span<const Transfer> transfers) {
+        const auto pid = this->m_selectedProcess->id;
+
+        auto readFallback = [this](const Transfer &transfer) {
+            // /proc/<pid>/mem can still read pages process_vm_readv refuses, e.g. ones without read permission
+            for (size_t offset = 0; offset < transfer.size; ) {
+                const auto result = ::pread(this->m_memoryFd, transfer.buffer + offset, transfer.size - offset, off_t(transfer.address + offset));
+                if (result <= 0)
+                    break;
+
+                offset += result;
+            }
+        };
+
+        std::vector<iovec> localVectors, remoteVectors;
+        localVectors.reserve(std::min(transfers.size(), MaxIoVectors));
+        remoteVectors.reserve(std::min(transfers.size(), MaxIoVectors));
+
+        size_t index = 0;
+        while (index < transfers.size()) {
+            if (!this->m_vmReadvSupported) {
+                readFallback(transfers[index]);
+                index++;
+                continue;
+            }
+
+            // Read as many transfers as the kernel allows with one call
+            const auto batch = transfers.subspan(index, std::min(transfers.size() - index, MaxIoVectors));
+            const auto batchEnd = index + batch.size();
+
+            localVectors.clear();
+            remoteVectors.clear();
+            for (const auto &transfer : batch) {
+                localVectors.push_back({ transfer.buffer, transfer.size });
+                remoteVectors.push_back({ reinterpret_cast<void*>(transfer.address), transfer.size });
+            }
+
+            const auto result = ::process_vm_readv(pid, localVectors.data(), localVectors.size(), remoteVectors.data(), remoteVectors.size(), 0);
+            if (result < 0) {
+                if (errno == ENOSYS || errno == EPERM)
+                    this->m_vmReadvSupported = false;
+
+                readFallback(transfers[index]);
+                index++;
+                continue;
+            }
+
+            // The kernel stops at the first page it can't read. Skip everything that was read and let the fallback read the rest of the transfer it stopped in
+            size_t bytesRead = result;
+            while (index < batchEnd && bytesRead >= transfers[index].size) {
+                bytesRead -= transfers[index].size;
+                index++;
+            }
+
+            if (index < batchEnd) {
+                const auto &transfer = transfers[index];
+                readFallback({ transfer.address + bytesRead, transfer.buffer + bytesRead, transfer.size - bytesRead });
+                index++;
+            }
+        }
+    }
+
+    void ProcessMemoryProvider::readRaw(u64 address, void *buffer, size_t size) {
+        std::vector<Transfer> transfers;
+        {
+            std::scoped_lock lock(this->m_regionMutex);
+            this->collectTransfers(address, static_cast<u8*>(buffer), size, transfers);
+        }
+
+        this->readTransfers(transfers);
+    }
+
+    void ProcessMemoryProvider::readv(std::span<const ReadRequest> requests, bool) {
+        // All requests are read together so they can share system calls
+        std::vector<Transfer> transfers;
+        size_t totalSize = 0;
+        {
+            std::scoped_lock lock(this->m_regionMutex);
+            for (const auto &request : requests) {
+                if (request.size > 0 && request.buffer != nullptr) {
+                    this->collectTransfers(request.offset, static_cast<u8*>(request.buffer), request.size, transfers);
+                    totalSize += request.size;
+                }
+            }
+        }
+
+        if (totalSize == 0)
+            return;
+
+        prv::IoStatistics::ReadScope readScope(this, requests.front().offset, totalSize);
+
+        this->readTransfers(transfers);
+    }
+
+    void ProcessMemoryProvider::writeRaw(u64 address, const void *buffer, size_t size) {
+        if (!this->m_writable)
+            return;
+
+        iovec localVector  = { const_cast<void*>(buffer), size };
+        iovec remoteVector = { reinterpret_cast<void*>(address), size };
+        if (::process_vm_writev(this->m_selectedProcess->id, &localVector, 1, &remoteVector, 1, 0) == ssize_t(size))
+            return;
+
+        // Writing through /proc/<pid>/mem also works for read-only pages such as code
+        auto bytes = static_cast<const u8*>(buffer);
+        for (size_t offset = 0; offset < size; ) {
+            const auto result = ::pwrite(this->m_memoryFd, bytes + offset, size - offset, off_t(address + offset));
+            if (result <= 0)
+                break;
+
+            offset += result;
+        }
+    }
+
+    std::pair<Region, bool> ProcessMemoryProvider::getRegionValidity(u64 address) const {
+        std::scoped_lock lock(this->m_regionMutex);
+
+        auto region = std::upper_bound(this->m_readableRegions.begin(), this->m_readableRegions.end(), address, [](u64 value, const Region &region) {
+            return value < region.getStartAddress();
+        });
+
+        if (region != this->m_readableRegions.begin()) {
+            if (auto previous = std::prev(region); previous->overlaps({ address, 1 }))
+                return { *previous, true };
+        }
+
+        if (address >= this->getActualSize())
+            return { Region::Invalid(), false };
+
+        // Report the unmapped space up to the next readable region
+        const u64 nextStart = region != this->m_readableRegions.end() ? region->getStartAddress() : this->getActualSize();
+        return { Region { address, nextStart - address }, false };
+    }
+
+    std::pair<Region, bool> ProcessMemoryProvider::getZeroRegion(u64 address) const {
+        auto [region, valid] = this->getRegionValidity(address);
+        if (region == Region::Invalid())
+            return { Region::Invalid(), false };
+
+        // Unmapped memory reads as zero and doesn't need to be read at all
+        if (!valid)
+            return { region, true };
+
+        return { Region { address, region.getEndAddress() - address + 1 }, false };
+    }
+
+    bool ProcessMemoryProvider::drawLoadInterface() {
+        if (this->m_processes.empty() && !this->m_enumerationFailed) {
+            std::error_code error;
+            for (const auto &entry : std::filesystem::directory_iterator("/proc", error)) {
+                const auto fileName = entry.path().filename().string();
+
+                pid_t processId = 0;
+                if (auto [end, parseError] = std::from_chars(fileName.data(), fileName.data() + fileName.size(), processId); parseError != std::errc() || end != fileName.data() + fileName.size())
+                    continue;
+
+                std::ifstream commFile(entry.path() / "comm");
+                std::string processName;
+                if (!commFile.is_open() || !std::getline(commFile, processName))
+                    continue;
+
+                this->m_processes.push_back({ processId, std::move(processName) });
+            }
+
+            if (error)
+                this->m_enumerationFailed = true;
+
+            std::sort(this->m_processes.begin(), this->m_processes.end(), [](const Process &a, const Process &b) {
+                return a.id < b.id;
+            });
+        }
+
+        if (this->m_enumerationFailed) {
+            ImGui::TextUnformatted("hex.builtin.provider.process_memory.enumeration_failed"_lang);
+        } else {
+            ImGui::PushItemWidth(350_scaled);
+            const auto &filtered = this->m_processSearchWidget.draw(this->m_processes);
+            ImGui::PopItemWidth();
+            if (ImGui::BeginTable("##process_table", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY, ImVec2(350_scaled, 500_scaled))) {
+                ImGui::TableSetupColumn("hex.builtin.provider.process_memory.process_id"_lang);
+                ImGui::TableSetupColumn("hex.builtin.provider.process_memory.process_name"_lang);
+                ImGui::TableSetupScrollFreeze(0, 1);
+
+                ImGui::TableHeadersRow();
+
+                for (auto &process : filtered) {
+                    ImGui::PushID(process);
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", process->id);
+
+                    ImGui::TableNextColumn();
+                    if (ImGui::Selectable(process->name.c_str(), this->m_selectedProcess != nullptr && process->id == this->m_selectedProcess->id, ImGuiSelectableFlags_SpanAllColumns))
+                        this->m_selectedProcess = process;
+
+                    ImGui::PopID();
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
+        return this->m_selectedProcess != nullptr;
+    }
+
+    void ProcessMemoryProvider::drawInterface() {
+        ImGui::Header("hex.builtin.provider.process_memory.memory_regions"_lang, true);
+
+        auto availableX = ImGui::GetContentRegionAvail().x;
+        ImGui::PushItemWidth(availableX);
+        const auto &filtered = this->m_regionSearchWidget.draw(this->m_memoryRegions);
+        ImGui::PopItemWidth();
+        if (ImGui::BeginTable("##module_table", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY, ImVec2(availableX, 400_scaled))) {
+            ImGui::TableSetupColumn("hex.builtin.common.region"_lang);
+            ImGui::TableSetupColumn("hex.builtin.common.size"_lang);
+            ImGui::TableSetupColumn("hex.builtin.common.name"_lang);
+            ImGui::TableSetupScrollFreeze(0, 1);
+
+            ImGui::TableHeadersRow();
+
+            for (auto &memoryRegion : filtered) {
+                ImGui::PushID(memoryRegion->region.getStartAddress());
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextFormatted("0x{:016X} - 0x{:016X}", memoryRegion->region.getStartAddress(), memoryRegion->region.getEndAddress());
+
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(memoryRegion->region.getSize()).c_str());
+
+                ImGui::TableNextColumn();
+                ImGui::BeginDisabled(!memoryRegion->readable);
+                if (ImGui::Selectable(memoryRegion->name.c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                    ImHexApi::HexEditor::setSelection(memoryRegion->region);
+                ImGui::EndDisabled();
+
+                ImGui::PopID();
+            }
+
+            ImGui::EndTable();
+        }
+
+        if (ImGui::Button("hex.builtin.provider.process_memory.reload"_lang))
+            this->reloadMemoryRegions();
+    }
+
+    void ProcessMemoryProvider::reloadMemoryRegions() {
+        std::vector<MemoryRegion> memoryRegions;
+        std::vector<Region> readableRegions;
+
+        std::ifstream mapsFile(hex::format("/proc/{}/maps", this->m_selectedProcess->id));
+
+        // Every line looks like "start-end perms offset dev inode [path]" with the path padded by spaces
+        std::string line;
+        while (std::getline(mapsFile, line)) {
+            std::istringstream lineStream(line);
+
+            std::string range, permissions, offset, device, inode;
+            if (!(lineStream >> range >> permissions >> offset >> device >> inode))
+                continue;
+
+            const auto separator = range.find('-');
+            if (separator == std::string::npos)
+                continue;
+
+            const auto start = parseHexNumber(std::string_view(range).substr(0, separator));
+            const auto end   = parseHexNumber(std::string_view(range).substr(separator + 1));
+            if (!start.has_value() || !end.has_value() || *end <= *start || *start >= this->getActualSize())
+                continue;
+
+            const Region region = { *start, std::min<u64>(*end, this->getActualSize()) - *start };
+            const bool readable = permissions.starts_with('r');
+
+            // The path may itself contain spaces, so take everything that's left on the line
+            std::string name;
+            std::getline(lineStream >> std::ws, name);
+            if (name.empty())
+                name = hex::format("[{}]", permissions);
+
+            memoryRegions.push_back({ region, std::move(name), readable });
+
+            if (!readable)
+                continue;
+
+            // Neighbouring mappings are merged so a read spanning them only needs one transfer
+            if (!readableRegions.empty() && readableRegions.back().getEndAddress() + 1 == region.getStartAddress())
+                readableRegions.back().size += region.getSize();
+            else
+                readableRegions.push_back(region);
+        }
+
+        std::sort(readableRegions.begin(), readableRegions.end(), [](const Region &a, const Region &b) {
+            return a.getStartAddress() < b.getStartAddress();
+        });
+
+        {
+            std::scoped_lock lock(this->m_regionMutex);
+            this->m_readableRegions = std::move(readableRegions);
+        }
+
+        this->m_memoryRegions = std::move(memoryRegions);
+        this->m_regionSearchWidget.reset();
+    }
+
+    std::variant<std::string, i128> ProcessMemoryProvider::queryInformation(const std::string &category, const std::string &argument) {
+        auto findRegionByName = [this](const std::string &name) {
+            return std::find_if(this->m_memoryRegions.begin(), this->m_memoryRegions.end(),
+                [name](const auto &region) {
+                    return region.name == name;
+                });
+        };
+
+        if (category == "region_address") {
+            if (auto iter = findRegionByName(argument); iter != this->m_memoryRegions.end())
+                return iter->region.getStartAddress();
+            else
+                return 0;
+        } else if (category == "region_size") {
+            if (auto iter = findRegionByName(argument); iter != this->m_memoryRegions.end())
+                return iter->region.getSize();
+            else
+                return 0;
+        } else if (category == "process_id") {
+            return this->m_selectedProcess->id;
+        } else if (category == "process_name") {
+            return this->m_selectedProcess->name;
+        } else
+            return Provider::queryInformation(category, argument);
+    }
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include "content/providers/snapshot_provider.hpp"
+
+#include <hex/api/localization.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/utils.hpp>
+
+namespace hex::plugin::builtin {
+
+    void SnapshotProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if (this->m_snapshot == nullptr || buffer == nullptr || size == 0)
+            return;
+
+        this->m_snapshot->read(offset, buffer, size);
+    }
+
+    void SnapshotProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        hex::unused(offset, buffer, size);
+    }
+
+    size_t SnapshotProvider::getActualSize() const {
+        if (this->m_snapshot == nullptr)
+            return 0;
+
+        return this->m_snapshot->getSize();
+    }
+
+    bool SnapshotProvider::open() {
+        // Snapshots only exist in memory, so there's nothing to restore them from when loading a project
+        if (this->m_snapshot == nullptr) {
+            this->setErrorMessage("hex.builtin.provider.snapshot.error.no_snapshot"_lang);
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string SnapshotProvider::getName() const {
+        return hex::format("hex.builtin.provider.snapshot.name"_lang, this->m_sourceName, this->m_number);
+    }
+
+    std::vector<SnapshotProvider::Description> SnapshotProvider::getDataDescription() const {
+        std::vector<Description> result;
+
+        std::string creationTime;
+        try { creationTime = hex::format("{:%Y-%m-%d %H:%M:%S}", fmt::localtime(std::chrono::system_clock::to_time_t(this->m_creationTime))); }
+        catch (const std::exception&) { creationTime = "???"; }
+
+        result.emplace_back("hex.builtin.provider.snapshot.source"_lang, this->m_sourceName);
+        result.emplace_back("hex.builtin.provider.snapshot.creation"_lang, creationTime);
+
+        if (this->m_snapshot != nullptr) {
+            result.emplace_back("hex.builtin.provider.snapshot.size"_lang, hex::toByteString(this->m_snapshot->getSize()));
+            result.emplace_back("hex.builtin.provider.snapshot.stored_size"_lang, hex::toByteString(this->m_snapshot->getStoredSize()));
+        }
+
+        return result;
+    }
+
+    std::pair<Region, bool> SnapshotProvider::getRegionValidity(u64 address) const {
+        if (this->m_snapshot == nullptr)
+            return { Region::Invalid(), false };
+
+        auto [region, valid] = this->m_snapshot->getRegionValidity(address - this->getBaseAddress());
+        if (region.getSize() == 0)
+            return { Region::Invalid(), false };
+
+        region.address += this->getBaseAddress();
+        if (valid)
+            return { region, true };
+
+        // The source didn't have any data there, only overlays may hold data now
+        auto [overlayRegion, overlayValid] = Provider::getRegionValidity(address);
+        if (overlayValid)
+            return { overlayRegion, true };
+
+        if (overlayRegion.getSize() != 0)
+            region.size = std::min<u64>(region.getSize(), overlayRegion.getSize());
+
+        return { region, false };
+    }
+
+    std::pair<Region, bool> SnapshotProvider::getZeroRegion(u64 address) const {
+        if (this->m_snapshot == nullptr)
+            return { Region::Invalid(), false };
+
+        auto [region, zero] = this->m_snapshot->getZeroRegion(address - this->getBaseAddress());
+        if (region.getSize() == 0)
+            return { Region::Invalid(), false };
+
+        region.address += this->getBaseAddress();
+
+        // Overlays may have put data into the zero bytes
+        if (zero) {
+            if (auto modification = this->findFirstModification(region); modification.has_value()) {
+                if (*modification == address)
+                    zero = false;
+                else
+                    region.size = *modification - address;
+            }
+        }
+
+        return { region, zero };
+    }
+
+    void SnapshotProvider::setSnapshot(std::shared_ptr<prv::Snapshot> snapshot, std::string sourceName, u32 sourceId, u32 number) {
+        this->m_snapshot     = std::move(snapshot);
+        this->m_sourceName   = std::move(sourceName);
+        this->m_sourceId     = sourceId;
+        this->m_number       = number;
+        this->m_creationTime = std::chrono::system_clock::now();
+
+        this->m_baseAddress = this->m_snapshot->getBaseAddress();
+    }
+
+}
@@ -0,0 +1,174 @@
+#include "content/providers/view_provider.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace hex::plugin::builtin {
+
+    void ViewProvider::save() {
+        if (this->m_provider == nullptr)
+            return;
+
+        // Changes made through the view only reach the parent once the view gets saved
+        this->applyPatches();
+
+        if (this->m_provider->isSavable())
+            this->m_provider->save();
+    }
+
+    void ViewProvider::write(u64 offset, const void *buffer, size_t size) {
+        if (!this->isInside(offset - this->getBaseAddress(), size) || buffer == nullptr || size == 0)
+            return;
+
+        this->addPatch(offset, buffer, size, true);
+    }
+
+    prv::Provider::PreparedFill ViewProvider::prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback) {
+        if (!this->isInside(offset - this->getBaseAddress(), size) || pattern.empty() || size == 0)
+            return { offset, 0, pattern, { } };
+
+        return this->preparePatchFill(offset, size, pattern, progressCallback);
+    }
+
+    void ViewProvider::fill(const PreparedFill &fill) {
+        if (!this->isInside(fill.offset - this->getBaseAddress(), fill.size) || fill.pattern.empty() || fill.size == 0)
+            return;
+
+        this->addFillPatch(fill, true);
+    }
+
+    void ViewProvider::insert(u64 offset, size_t size) {
+        if (this->m_provider == nullptr)
+            return;
+
+        this->m_size += size;
+        this->m_provider->insert(offset + this->m_startAddress, size);
+
+        Provider::insert(offset, size);
+    }
+
+    void ViewProvider::remove(u64 offset, size_t size) {
+        if (this->m_provider == nullptr)
+            return;
+
+        this->m_size -= size;
+        this->m_provider->remove(offset + this->m_startAddress, size);
+
+        Provider::remove(offset, size);
+    }
+
+    void ViewProvider::readv(std::span<const ReadRequest> requests, bool overlays) {
+        if (this->m_provider == nullptr)
+            return;
+
+        // Hand the whole batch to the parent so it can merge the requests in the way that suits it best
+        std::vector<ReadRequest> parentRequests;
+        parentRequests.reserve(requests.size());
+        size_t totalSize = 0;
+        for (const auto &request : requests) {
+            if (this->isInside(request.offset - this->getBaseAddress(), request.size)) {
+                parentRequests.push_back({ this->toParentAddress(request.offset), request.size, request.buffer });
+                totalSize += request.size;
+            }
+        }
+
+        if (parentRequests.empty())
+            return;
+
+        prv::IoStatistics::ReadScope readScope(this, requests.front().offset, totalSize);
+
+        this->m_provider->readv(parentRequests, true);
+
+        if (overlays) [[likely]] {
+            for (const auto &request : requests) {
+                this->getPatches().apply(request.offset, request.buffer, request.size);
+                this->applyOverlays(request.offset, request.buffer, request.size);
+            }
+        }
+    }
+
+    std::optional<std::span<const u8>> ViewProvider::tryGetSpan(u64 offset, size_t size) {
+        if (this->m_provider == nullptr || size == 0 || !this->isInside(offset - this->getBaseAddress(), size))
+            return std::nullopt;
+
+        if (!this->isUnmodified(offset, size))
+            return std::nullopt;
+
+        return this->m_provider->tryGetSpan(this->toParentAddress(offset), size);
+    }
+
+    bool ViewProvider::isDataAvailable(u64 offset, size_t size) const {
+        if (this->m_provider == nullptr || !this->isInside(offset - this->getBaseAddress(), size))
+            return true;
+
+        return this->m_provider->isDataAvailable(this->toParentAddress(offset), size);
+    }
+
+    void ViewProvider::prefetch(const Region &region) {
+        const u64 offset = region.getStartAddress() - this->getBaseAddress();
+        if (this->m_provider == nullptr || offset >= this->m_size)
+            return;
+
+        this->m_provider->prefetch({ this->toParentAddress(region.getStartAddress()), std::min<u64>(region.getSize(), this->m_size - offset) });
+    }
+
+    void ViewProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if (this->m_provider == nullptr || !this->isInside(offset, size))
+            return;
+
+        this->m_provider->read(offset + this->m_startAddress, buffer, size);
+    }
+
+    void ViewProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        if (this->m_provider == nullptr || !this->isInside(offset, size))
+            return;
+
+        this->m_provider->write(offset + this->m_startAddress, buffer, size);
+    }
+
+    std::pair<Region, bool> ViewProvider::getRegionValidity(u64 address) const {
+        const u64 offset = address - this->getBaseAddress();
+        if (this->m_provider == nullptr || offset >= this->m_size)
+            return { Region::Invalid(), false };
+
+        const u64 parentAddress = this->toParentAddress(address);
+        auto [region, valid] = this->m_provider->getRegionValidity(parentAddress);
+
+        // Parents without any information about the validity of their data have valid data everywhere up to their end.
+        // Views that got resized past the end of the parent have no data there at all
+        if (region.getSize() == 0) {
+            const u64 parentOffset = parentAddress - this->m_provider->getBaseAddress();
+            if (parentOffset >= this->m_provider->getActualSize())
+                return { Region::Invalid(), false };
+
+            return { Region { address, std::min<u64>(this->m_size - offset, this->m_provider->getActualSize() - parentOffset) }, true };
+        }
+
+        return { Region { address, std::min<u64>(region.getSize(), this->m_size - offset) }, valid };
+    }
+
+    std::pair<Region, bool> ViewProvider::getZeroRegion(u64 address) const {
+        const u64 offset = address - this->getBaseAddress();
+        if (this->m_provider == nullptr || offset >= this->m_size)
+            return { Region::Invalid(), false };
+
+        auto [region, zero] = this->m_provider->getZeroRegion(this->toParentAddress(address));
+        if (region.getSize() == 0)
+            return { Region::Invalid(), false };
+
+        Region result = { address, std::min<u64>(region.getSize(), this->m_size - offset) };
+
+        // Patches of the view itself may have put data into the zero bytes
+        if (zero) {
+            if (auto modification = this->findFirstModification(result); modification.has_value()) {
+                if (*modification == address)
+                    zero = false;
+                else
+                    result.size = *modification - address;
+            }
+        }
+
+        return { result, zero };
+    }
+
+}
@@ -4,6 +4,8 @@
 #include <hex/api/localization.hpp>
 #include <hex/api/theme_manager.hpp>
 
+#include <hex/providers/patch_history.hpp>
+
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/http_requests.hpp>
 #include <hex/helpers/logger.hpp>
@@ -95,6 +97,58 @@ namespace hex::plugin::builtin {
             return false;
         });
 
+        ContentRegistry::Settings::add("hex.builtin.setting.general", "hex.builtin.setting.general.undo_history_limit", 512, [](auto name, nlohmann::json &setting) {
+            static int limit = static_cast<int>(setting);
+
+            if (ImGui::SliderInt(name.data(), &limit, 16, 8192, "%d MiB", ImGuiSliderFlags_AlwaysClamp)) {
+                setting = limit;
+                prv::PatchHistory::setMemoryLimit(size_t(limit) * 1024 * 1024);
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.general", "hex.builtin.setting.general.disk_read_ahead", 1024, [](auto name, nlohmann::json &setting) {
+            static int readAhead = static_cast<int>(setting);
+
+            if (ImGui::SliderInt(name.data(), &readAhead, 0, 4096, "%d KiB", ImGuiSliderFlags_AlwaysClamp)) {
+                setting = readAhead;
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.general", "hex.builtin.setting.general.io_queue_depth", 8, [](auto name, nlohmann::json &setting) {
+            static int queueDepth = static_cast<int>(setting);
+
+            if (ImGui::SliderInt(name.data(), &queueDepth, 1, 64, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+                setting = queueDepth;
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.general", "hex.builtin.setting.general.provider_idle_timeout", 60, [](auto name, nlohmann::json &setting) {
+            static int timeout = static_cast<int>(setting);
+
+            auto format = [] -> std::string {
+                if (timeout == 0)
+                    return "hex.builtin.setting.general.provider_idle_timeout.never"_lang;
+                else
+                    return "%d s";
+            }();
+
+            if (ImGui::SliderInt(name.data(), &timeout, 0, 600, format.c_str(), ImGuiSliderFlags_AlwaysClamp)) {
+                setting = timeout;
+                return true;
+            }
+
+            return false;
+        });
+
         ContentRegistry::Settings::add("hex.builtin.setting.general", "hex.builtin.setting.general.network_interface", 0, [](auto name, nlohmann::json &setting) {
             static bool enabled = static_cast<int>(setting);
 
@@ -499,9 +553,16 @@ namespace hex::plugin::builtin {
         ImHexApi::System::setAdditionalFolderPaths(userFolders);
     }
 
+    static void loadUndoHistorySettings() {
+        auto limit = ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.undo_history_limit", 512);
+
+        prv::PatchHistory::setMemoryLimit(size_t(limit) * 1024 * 1024);
+    }
+
     void loadSettings() {
         loadThemeSettings();
         loadFoldersSettings();
+        loadUndoHistorySettings();
     }
 
 }
@@ -21,6 +21,7 @@
 #include "content/views/view_theme_manager.hpp"
 #include "content/views/view_logs.hpp"
 #include "content/views/view_achievements.hpp"
+#include "content/views/view_io_statistics.hpp"
 
 namespace hex::plugin::builtin {
 
@@ -48,6 +49,7 @@ namespace hex::plugin::builtin {
         ContentRegistry::Views::add<ViewThemeManager>();
         ContentRegistry::Views::add<ViewLogs>();
         ContentRegistry::Views::add<ViewAchievements>();
+        ContentRegistry::Views::add<ViewIoStatistics>();
     }
 
 }
\ No newline at end of file
@@ -58,13 +58,24 @@ namespace hex::plugin::builtin {
                 if (this->m_selectedProvider == nullptr)
                     return;
 
-                // Decode bytes using registered inspectors
+                // Read the data for all registered inspectors in one batch
+                std::vector<std::pair<const ContentRegistry::DataInspector::impl::Entry *, std::vector<u8>>> entryData;
+                std::vector<prv::Provider::ReadRequest> readRequests;
                 for (auto &entry : ContentRegistry::DataInspector::impl::getEntries()) {
                     if (validBytes < entry.requiredSize)
                         continue;
 
-                    std::vector<u8> buffer(validBytes > entry.maxSize ? entry.maxSize : validBytes);
-                    this->m_selectedProvider->read(startAddress, buffer.data(), buffer.size());
+                    entryData.emplace_back(&entry, std::vector<u8>(validBytes > entry.maxSize ? entry.maxSize : validBytes));
+                }
+
+                for (auto &[entry, buffer] : entryData)
+                    readRequests.push_back({ startAddress, buffer.size(), buffer.data() });
+
+                this->m_selectedProvider->readv(readRequests);
+
+                // Decode bytes using registered inspectors
+                for (auto &[entryPtr, buffer] : entryData) {
+                    auto &entry = *entryPtr;
 
                     if (invert) {
                         for (auto &byte : buffer)
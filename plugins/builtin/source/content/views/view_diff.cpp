@@ -1,18 +1,54 @@
 #include "content/views/view_diff.hpp"
+#include "content/providers/snapshot_provider.hpp"
 
 #include <hex/api/imhex_api.hpp>
 
 #include <hex/helpers/fmt.hpp>
 #include <hex/helpers/logger.hpp>
 
+#include <algorithm>
+#include <optional>
+#include <tuple>
+
 namespace hex::plugin::builtin {
 
     namespace {
 
+        constexpr static size_t ChunkSize = prv::Snapshot::BlockSize;
+
         u32 getDiffColor(u32 color) {
             return (color & 0x00FFFFFF) | 0x40000000;
         }
 
+        /**
+         * @brief Gets the number of bytes starting at an offset that are known to be identical in both providers without having to compare them
+         */
+        u64 getIdenticalSize(prv::Provider *providerA, prv::Provider *providerB, u64 offset, u64 maxSize) {
+            u64 result = 0;
+
+            // Snapshots sharing blocks with each other or with the provider they were taken of hold the same data there
+            auto snapshotA = dynamic_cast<SnapshotProvider*>(providerA);
+            auto snapshotB = dynamic_cast<SnapshotProvider*>(providerB);
+            if (providerA->getOverlays().empty() && providerB->getOverlays().empty()) {
+                if (snapshotA != nullptr && snapshotB != nullptr)
+                    result = snapshotA->getSnapshot()->getSharedSize(*snapshotB->getSnapshot(), offset);
+                else if (snapshotA != nullptr && snapshotA->getSnapshot()->getSource() == providerB && providerB->getBaseAddress() == snapshotA->getSnapshot()->getBaseAddress())
+                    result = snapshotA->getSnapshot()->getSourceBackedSize(offset);
+                else if (snapshotB != nullptr && snapshotB->getSnapshot()->getSource() == providerA && providerA->getBaseAddress() == snapshotB->getSnapshot()->getBaseAddress())
+                    result = snapshotB->getSnapshot()->getSourceBackedSize(offset);
+            }
+
+            // Bytes that are zero in both providers, e.g. holes in sparse files or memory that was never written to
+            if (result == 0) {
+                auto [zeroRegionA, zeroA] = providerA->getZeroRegion(providerA->getBaseAddress() + offset);
+                auto [zeroRegionB, zeroB] = providerB->getZeroRegion(providerB->getBaseAddress() + offset);
+                if (zeroA && zeroB)
+                    result = std::min(zeroRegionA.getSize(), zeroRegionB.getSize());
+            }
+
+            return std::min(result, maxSize);
+        }
+
     }
 
     ViewDiff::ViewDiff() : View("hex.builtin.view.diff.name") {
@@ -144,33 +180,61 @@ namespace hex::plugin::builtin {
                 auto providerB = providers[b.provider];
 
                 auto commonSize = std::min(providerA->getActualSize(), providerB->getActualSize());
-                this->m_diffTask = TaskManager::createTask("Diffing...", commonSize, [this, providerA, providerB](Task &task) {
+                this->m_diffTask = TaskManager::createTask("Diffing...", commonSize, [this, providerA, providerB, commonSize](Task &task) {
                     std::vector<Diff> differences;
 
-                    auto readerA = prv::ProviderReader(providerA);
-                    auto readerB = prv::ProviderReader(providerB);
+                    std::vector<u8> bufferA(ChunkSize), bufferB(ChunkSize);
 
-                    for (auto itA = readerA.begin(), itB = readerB.begin(); itA < readerA.end() && itB < readerB.end(); itA++, itB++) {
+                    // Differences may continue across chunk boundaries, so the start of the current one is tracked separately
+                    std::optional<u64> differenceStart;
+                    const auto endDifference = [&](u64 offset) {
+                        if (differenceStart.has_value()) {
+                            differences.push_back(Diff { Region { providerA->getBaseAddress() + *differenceStart, offset - *differenceStart }, ViewDiff::DifferenceType::Modified });
+                            differenceStart.reset();
+                        }
+                    };
+
+                    for (u64 offset = 0; offset < commonSize;) {
                         if (task.wasInterrupted())
                             break;
 
-                        if (*itA != *itB) {
-                            u64 start = itA.getAddress();
-                            size_t end = 0;
+                        if (const auto identicalSize = getIdenticalSize(providerA, providerB, offset, commonSize - offset); identicalSize > 0) {
+                            endDifference(offset);
+                            offset += identicalSize;
+                            task.update(offset);
+                            continue;
+                        }
+
+                        // Stay aligned to the chunk size so identical blocks can be detected at the start of the next chunk
+                        const auto size = std::min<u64>(ChunkSize - (offset % ChunkSize), commonSize - offset);
+                        providerA->read(providerA->getBaseAddress() + offset, bufferA.data(), size);
+                        providerB->read(providerB->getBaseAddress() + offset, bufferB.data(), size);
 
-                            while (itA != readerA.end() && itB != readerB.end() && *itA != *itB) {
-                                itA++;
-                                itB++;
-                                end++;
+                        const auto endA = bufferA.begin() + size;
+                        for (auto itA = bufferA.begin(), itB = bufferB.begin(); itA != endA;) {
+                            if (!differenceStart.has_value()) {
+                                std::tie(itA, itB) = std::mismatch(itA, endA, itB);
+                                if (itA == endA)
+                                    break;
+
+                                differenceStart = offset + (itA - bufferA.begin());
                             }
 
+                            while (itA != endA && *itA != *itB) {
+                                ++itA;
+                                ++itB;
+                            }
 
-                            differences.push_back(Diff { Region{ start, end }, ViewDiff::DifferenceType::Modified });
+                            if (itA != endA)
+                                endDifference(offset + (itA - bufferA.begin()));
                         }
 
-                        task.update(itA.getAddress());
+                        offset += size;
+                        task.update(offset);
                     }
 
+                    endDifference(commonSize);
+
                     if (providerA->getActualSize() != providerB->getActualSize()) {
                         auto endA = providerA->getActualSize() + 1;
                         auto endB = providerB->getActualSize() + 1;
@@ -4,8 +4,11 @@
 #include <hex/api/achievement_manager.hpp>
 
 #include <hex/providers/buffered_reader.hpp>
+#include <hex/providers/zero_regions.hpp>
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <regex>
 #include <string>
 #include <utility>
@@ -164,7 +167,7 @@ namespace hex::plugin::builtin {
         return hex::format("{}", value);
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Strings &settings) {
+    std::vector<ViewFind::Occurrence> ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, u64 progressOffset, const SearchSettings::Strings &settings) {
         using enum SearchSettings::StringType;
 
         std::vector<Occurrence> results;
@@ -173,16 +176,16 @@ namespace hex::plugin::builtin {
             auto newSettings = settings;
 
             newSettings.type = ASCII;
-            auto asciiResults = searchStrings(task, provider, searchRegion, newSettings);
+            auto asciiResults = searchStrings(task, provider, searchRegion, progressOffset, newSettings);
             std::copy(asciiResults.begin(), asciiResults.end(), std::back_inserter(results));
 
             if (settings.type == ASCII_UTF16BE) {
                 newSettings.type = UTF16BE;
-                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings);
+                auto utf16Results = searchStrings(task, provider, searchRegion, progressOffset, newSettings);
                 std::copy(utf16Results.begin(), utf16Results.end(), std::back_inserter(results));
             } else if (settings.type == ASCII_UTF16LE) {
                 newSettings.type = UTF16LE;
-                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings);
+                auto utf16Results = searchStrings(task, provider, searchRegion, progressOffset, newSettings);
                 std::copy(utf16Results.begin(), utf16Results.end(), std::back_inserter(results));
             }
 
@@ -208,7 +211,7 @@ namespace hex::plugin::builtin {
         u64 startAddress = reader.begin().getAddress();
         u64 endAddress = reader.end().getAddress();
 
-        u64 progress = 0;
+        u64 progress = progressOffset;
         for (u8 byte : reader) {
             bool validChar =
                 (settings.lowerCaseLetters    && std::islower(byte))  ||
@@ -242,7 +245,7 @@ namespace hex::plugin::builtin {
 
                 startAddress += countedCharacters + 1;
                 countedCharacters = 0;
-                progress = startAddress - searchRegion.getStartAddress();
+                progress = progressOffset + (startAddress - searchRegion.getStartAddress());
 
             }
         }
@@ -250,7 +253,7 @@ namespace hex::plugin::builtin {
         return results;
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Sequence &settings) {
+    std::vector<ViewFind::Occurrence> ViewFind::searchSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, u64 progressOffset, const SearchSettings::Sequence &settings) {
         std::vector<Occurrence> results;
 
         auto reader = prv::ProviderReader(provider);
@@ -263,7 +266,7 @@ namespace hex::plugin::builtin {
             return { };
 
         auto occurrence = reader.begin();
-        u64 progress = 0;
+        u64 progress = progressOffset;
         while (true) {
             task.update(progress);
 
@@ -274,14 +277,14 @@ namespace hex::plugin::builtin {
             auto address = occurrence.getAddress();
             reader.seek(address + 1);
             results.push_back(Occurrence{ Region { address, bytes.size() }, Occurrence::DecodeType::Binary, std::endian::native, false });
-            progress = address - searchRegion.getStartAddress();
+            progress = progressOffset + (address - searchRegion.getStartAddress());
         }
 
         return results;
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchRegex(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Regex &settings) {
-        auto stringOccurrences = searchStrings(task, provider, searchRegion, SearchSettings::Strings {
+    std::vector<ViewFind::Occurrence> ViewFind::searchRegex(Task &task, prv::Provider *provider, hex::Region searchRegion, u64 progressOffset, const SearchSettings::Regex &settings) {
+        auto stringOccurrences = searchStrings(task, provider, searchRegion, progressOffset, SearchSettings::Strings {
             .minLength          = settings.minLength,
             .nullTermination    = settings.nullTermination,
             .type               = settings.type,
@@ -314,7 +317,7 @@ namespace hex::plugin::builtin {
         return result;
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::BinaryPattern &settings) {
+    std::vector<ViewFind::Occurrence> ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, u64 progressOffset, const SearchSettings::BinaryPattern &settings) {
         std::vector<Occurrence> results;
 
         auto reader = prv::ProviderReader(provider);
@@ -328,7 +331,7 @@ namespace hex::plugin::builtin {
             for (auto it = reader.begin(); it < reader.end(); it += 1) {
                 auto byte = *it;
 
-                task.update(it.getAddress());
+                task.update(progressOffset + (it.getAddress() - searchRegion.getStartAddress()));
                 if (settings.pattern.matchesByte(byte, matchedBytes)) {
                     matchedBytes++;
                     if (matchedBytes == settings.pattern.getSize()) {
@@ -349,7 +352,7 @@ namespace hex::plugin::builtin {
             for (u64 address = searchRegion.getStartAddress(); address < searchRegion.getEndAddress(); address += settings.alignment) {
                 reader.read(address, data.data(), data.size());
 
-                task.update(address);
+                task.update(progressOffset + (address - searchRegion.getStartAddress()));
 
                 bool match = true;
                 for (u32 i = 0; i < patternSize; i++) {
@@ -367,7 +370,7 @@ namespace hex::plugin::builtin {
         return results;
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchValue(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Value &settings) {
+    std::vector<ViewFind::Occurrence> ViewFind::searchValue(Task &task, prv::Provider *provider, Region searchRegion, u64 progressOffset, const SearchSettings::Value &settings) {
         std::vector<Occurrence> results;
 
         auto reader = prv::ProviderReader(provider);
@@ -391,7 +394,7 @@ namespace hex::plugin::builtin {
         const auto advance = settings.aligned ? size : 1;
 
         for (u64 address = searchRegion.getStartAddress(); address < searchRegion.getEndAddress(); address += advance) {
-            task.update(address);
+            task.update(progressOffset + (address - searchRegion.getStartAddress()));
 
             auto result = std::visit([&](auto tag) {
                 using T = std::remove_cvref_t<std::decay_t<decltype(tag)>>;
@@ -438,6 +441,104 @@ namespace hex::plugin::builtin {
         return results;
     }
 
+    std::optional<u64> ViewFind::getZeroRunMargin(const SearchSettings &settings) {
+        switch (settings.mode) {
+            using enum SearchSettings::Mode;
+            case Strings:
+            case Regex:
+                // Zero bytes only ever show up in strings as part of a UTF-16 character or as a terminator
+                return 2;
+            case Sequence: {
+                const auto bytes = hex::decodeByteString(settings.bytes.sequence);
+                if (bytes.empty() || std::all_of(bytes.begin(), bytes.end(), [](u8 byte) { return byte == 0x00; }))
+                    return std::nullopt;
+
+                return bytes.size() - 1;
+            }
+            case BinaryPattern: {
+                const auto &pattern = settings.binaryPattern.pattern;
+                if (pattern.getSize() == 0)
+                    return std::nullopt;
+
+                for (u32 i = 0; i < pattern.getSize(); i++) {
+                    if (!pattern.matchesByte(0x00, i))
+                        return pattern.getSize() - 1;
+                }
+
+                return std::nullopt;
+            }
+            case Value: {
+                auto inputMax = settings.value.inputMax.empty() ? settings.value.inputMin : settings.value.inputMax;
+
+                const auto [validMin, min, sizeMin] = parseNumericValueInput(settings.value.inputMin, settings.value.type);
+                const auto [validMax, max, sizeMax] = parseNumericValueInput(inputMax, settings.value.type);
+                if (!validMin || !validMax || sizeMin != sizeMax)
+                    return std::nullopt;
+
+                const bool zeroMatches = std::visit([&](auto minValue) {
+                    using T = decltype(minValue);
+                    return T(0) >= minValue && T(0) <= std::get<T>(max);
+                }, min);
+
+                if (zeroMatches)
+                    return std::nullopt;
+
+                return sizeMin - 1;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::vector<Region> ViewFind::getValidRegions(prv::Provider *provider, Region searchRegion, u64 alignment) {
+        if (searchRegion.getSize() == 0)
+            return { searchRegion };
+
+        alignment = std::max<u64>(alignment, 1);
+
+        std::vector<Region> result;
+        std::optional<u64> validStart;
+        u64 address = searchRegion.getStartAddress();
+
+        while (true) {
+            auto [region, valid] = provider->getRegionValidity(address);
+
+            // Providers that can't tell which parts are valid get searched entirely
+            if (region.getSize() == 0 || region.getStartAddress() > address) {
+                if (!validStart.has_value())
+                    validStart = address;
+                break;
+            }
+
+            const u64 runEnd = std::min(region.getEndAddress(), searchRegion.getEndAddress());
+
+            if (valid) {
+                if (!validStart.has_value()) {
+                    // Stay on the grid of aligned addresses the search started on
+                    u64 start = address;
+                    if (const auto misalignment = (start - searchRegion.getStartAddress()) % alignment; misalignment != 0)
+                        start += alignment - misalignment;
+
+                    if (start <= runEnd)
+                        validStart = start;
+                }
+            } else if (validStart.has_value()) {
+                result.push_back(Region { *validStart, address - *validStart });
+                validStart.reset();
+            }
+
+            if (runEnd >= searchRegion.getEndAddress())
+                break;
+
+            address = runEnd + 1;
+        }
+
+        if (validStart.has_value())
+            result.push_back(Region { *validStart, (searchRegion.getEndAddress() - *validStart) + 1 });
+
+        return result;
+    }
+
     void ViewFind::runSearch() {
         Region searchRegion = this->m_searchSettings.region;
 
@@ -455,23 +556,54 @@ namespace hex::plugin::builtin {
         this->m_searchTask = TaskManager::createTask("hex.builtin.view.find.searching", searchRegion.getSize(), [this, settings = this->m_searchSettings, searchRegion](auto &task) {
             auto provider = ImHexApi::Provider::get();
 
-            switch (settings.mode) {
-                using enum SearchSettings::Mode;
-                case Strings:
-                    this->m_foundOccurrences.get(provider) = searchStrings(task, provider, searchRegion, settings.strings);
-                    break;
-                case Sequence:
-                    this->m_foundOccurrences.get(provider) = searchSequence(task, provider, searchRegion, settings.bytes);
-                    break;
-                case Regex:
-                    this->m_foundOccurrences.get(provider) = searchRegex(task, provider, searchRegion, settings.regex);
-                    break;
-                case BinaryPattern:
-                    this->m_foundOccurrences.get(provider) = searchBinaryPattern(task, provider, searchRegion, settings.binaryPattern);
-                    break;
-                case Value:
-                    this->m_foundOccurrences.get(provider) = searchValue(task, provider, searchRegion, settings.value);
-                    break;
+            u64 alignment = 1;
+            if (settings.mode == SearchSettings::Mode::BinaryPattern)
+                alignment = settings.binaryPattern.alignment;
+            else if (settings.mode == SearchSettings::Mode::Value && settings.value.aligned)
+                alignment = std::get<2>(parseNumericValueInput(settings.value.inputMin, settings.value.type));
+
+            // Address space the provider has nothing mapped at, e.g. unmapped memory of a process, never contains any matches
+            std::vector<Region> regions = getValidRegions(provider, searchRegion, alignment);
+
+            // Runs of bytes known to be zero, e.g. holes in sparse files, are skipped if the search can't match them anyway
+            if (auto margin = getZeroRunMargin(settings); margin.has_value()) {
+                std::vector<Region> searchableRegions;
+                for (const auto &region : regions) {
+                    auto parts = prv::getSearchableRegions(provider, region, *margin, alignment);
+                    std::move(parts.begin(), parts.end(), std::back_inserter(searchableRegions));
+                }
+
+                regions = std::move(searchableRegions);
+            }
+
+            auto &occurrences = this->m_foundOccurrences.get(provider);
+            occurrences.clear();
+
+            for (const auto &region : regions) {
+                // Skipped parts of the search region count as searched already
+                const u64 progressOffset = region.getStartAddress() - searchRegion.getStartAddress();
+
+                std::vector<Occurrence> results;
+                switch (settings.mode) {
+                    using enum SearchSettings::Mode;
+                    case Strings:
+                        results = searchStrings(task, provider, region, progressOffset, settings.strings);
+                        break;
+                    case Sequence:
+                        results = searchSequence(task, provider, region, progressOffset, settings.bytes);
+                        break;
+                    case Regex:
+                        results = searchRegex(task, provider, region, progressOffset, settings.regex);
+                        break;
+                    case BinaryPattern:
+                        results = searchBinaryPattern(task, provider, region, progressOffset, settings.binaryPattern);
+                        break;
+                    case Value:
+                        results = searchValue(task, provider, region, progressOffset, settings.value);
+                        break;
+                }
+
+                std::move(results.begin(), results.end(), std::back_inserter(occurrences));
             }
 
             this->m_sortedOccurrences.get(provider) = this->m_foundOccurrences.get(provider);
@@ -538,13 +538,24 @@ namespace hex::plugin::builtin {
             if (bytes.empty())
                 return;
 
+            // Only gather the fill's data in the task. The provider gets modified on the main thread once it's done,
+            // and not at all if the task was interrupted or the provider was closed in the meantime
             auto provider = ImHexApi::Provider::get();
-            for (u64 i = 0; i < size; i += bytes.size()) {
-                auto remainingSize = std::min<size_t>(size - i, bytes.size());
-                provider->write(provider->getBaseAddress() + address + i, bytes.data(), remainingSize);
-            }
+            TaskManager::createTask("hex.builtin.view.hex_editor.menu.edit.fill", size, [provider, providerId = provider->getID(), address, size, bytes = std::move(bytes)](Task &task) {
+                auto preparedFill = provider->prepareFill(provider->getBaseAddress() + address, size, bytes, [&task](u64 processed) {
+                    task.update(processed);
+                });
+
+                TaskManager::doLater([providerId, preparedFill = std::move(preparedFill)] {
+                    auto provider = ImHexApi::Provider::getById(providerId);
+                    if (provider == nullptr)
+                        return;
 
-            AchievementManager::unlockAchievement("hex.builtin.achievement.hex_editor", "hex.builtin.achievement.hex_editor.fill.name");
+                    provider->fill(preparedFill);
+
+                    AchievementManager::unlockAchievement("hex.builtin.achievement.hex_editor", "hex.builtin.achievement.hex_editor.fill.name");
+                });
+            });
         }
 
     private:
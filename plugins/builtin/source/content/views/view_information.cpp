@@ -114,14 +114,41 @@ namespace hex::plugin::builtin {
 
                 // Loop over each byte of the [part of the] file and update each analysis 
                 // one byte at the time in order to process the file only once
-                for (u8 byte : reader) {
-                    this->m_byteDistribution.update(byte);
-                    this->m_byteTypesDistribution.update(byte);
-                    this->m_chunkBasedEntropy.update(byte);
-                    this->m_layeredDistribution.update(byte);
-                    this->m_digram.update(byte);
-                    ++count;
-                    task.update(count);
+                u64 address = this->m_analysisRegion.getStartAddress();
+                while (address <= this->m_analysisRegion.getEndAddress()) {
+                    auto [zeroRegion, zero] = provider->getZeroRegion(address);
+                    const u64 runEnd = zeroRegion.getSize() == 0 ? this->m_analysisRegion.getEndAddress() : std::min(zeroRegion.getEndAddress(), this->m_analysisRegion.getEndAddress());
+
+                    // Bytes known to be zero, e.g. holes in sparse files, don't need to be read
+                    if (zero) {
+                        const u64 runSize = (runEnd - address) + 1;
+
+                        this->m_byteDistribution.update(0x00, runSize);
+                        this->m_byteTypesDistribution.update(0x00, runSize);
+                        this->m_chunkBasedEntropy.update(0x00, runSize);
+                        this->m_layeredDistribution.update(0x00, runSize);
+                        this->m_digram.update(0x00, runSize);
+                        count += runSize;
+                        task.update(count);
+                    } else {
+                        reader.setEndAddress(runEnd);
+                        reader.seek(address);
+
+                        for (u8 byte : reader) {
+                            this->m_byteDistribution.update(byte);
+                            this->m_byteTypesDistribution.update(byte);
+                            this->m_chunkBasedEntropy.update(byte);
+                            this->m_layeredDistribution.update(byte);
+                            this->m_digram.update(byte);
+                            ++count;
+                            task.update(count);
+                        }
+                    }
+
+                    if (runEnd == this->m_analysisRegion.getEndAddress())
+                        break;
+
+                    address = runEnd + 1;
                 }
 
                 this->m_averageEntropy = this->m_chunkBasedEntropy.calculateEntropy(this->m_byteDistribution.get(), this->m_analyzedRegion.getSize());
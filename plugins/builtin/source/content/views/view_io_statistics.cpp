@@ -0,0 +1,143 @@
+#include "content/views/view_io_statistics.hpp"
+
+#include <hex/api/localization.hpp>
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/fs.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <wolv/io/file.hpp>
+#include <wolv/utils/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace hex::plugin::builtin {
+
+    using prv::IoStatistics;
+
+    namespace {
+
+        std::string getCallerName(const std::string &caller) {
+            if (caller.empty())
+                return "hex.builtin.view.io_statistics.other"_lang;
+            else
+                return LangEntry(caller);
+        }
+
+        std::string formatDuration(std::chrono::nanoseconds duration) {
+            const auto nanoseconds = duration.count();
+
+            if (nanoseconds < 1'000)
+                return hex::format("{} ns", nanoseconds);
+            else if (nanoseconds < 1'000'000)
+                return hex::format("{:.1f} µs", nanoseconds / 1'000.0);
+            else
+                return hex::format("{:.2f} ms", nanoseconds / 1'000'000.0);
+        }
+
+    }
+
+    ViewIoStatistics::ViewIoStatistics() : View("hex.builtin.view.io_statistics.name") { }
+
+    void ViewIoStatistics::drawContent() {
+        if (ImGui::Begin(View::toWindowName("hex.builtin.view.io_statistics.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            bool enabled = IoStatistics::isEnabled();
+            if (ImGui::Checkbox("hex.builtin.view.io_statistics.enabled"_lang, &enabled))
+                IoStatistics::setEnabled(enabled);
+
+            ImGui::SameLine();
+
+            bool tracing = IoStatistics::isTracingEnabled();
+            if (ImGui::Checkbox("hex.builtin.view.io_statistics.tracing"_lang, &tracing))
+                IoStatistics::setTracingEnabled(tracing);
+
+            auto provider = ImHexApi::Provider::get();
+            if (ImHexApi::Provider::isValid()) {
+                auto &ioStatistics = provider->getIoStatistics();
+
+                ImGui::SameLine();
+                if (ImGui::Button("hex.builtin.view.io_statistics.reset"_lang))
+                    ioStatistics.reset();
+
+                ImGui::SameLine();
+                if (ImGui::Button("hex.builtin.view.io_statistics.export_trace"_lang))
+                    this->exportTrace(provider);
+
+                // Show the callers doing the most reads first
+                auto callerStatistics = ioStatistics.getCallerStatistics();
+                std::vector<std::pair<std::string, IoStatistics::CallerStatistics>> callers(callerStatistics.begin(), callerStatistics.end());
+                std::sort(callers.begin(), callers.end(), [](const auto &a, const auto &b) {
+                    return a.second.calls > b.second.calls;
+                });
+
+                const auto histogramHeight = 100_scaled;
+                if (ImGui::BeginTable("##callers", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY, ImVec2(0, ImGui::GetContentRegionAvail().y - histogramHeight - ImGui::GetStyle().ItemSpacing.y))) {
+                    ImGui::TableSetupScrollFreeze(0, 1);
+                    ImGui::TableSetupColumn("hex.builtin.view.io_statistics.caller"_lang);
+                    ImGui::TableSetupColumn("hex.builtin.view.io_statistics.calls"_lang);
+                    ImGui::TableSetupColumn("hex.builtin.view.io_statistics.bytes"_lang);
+                    ImGui::TableSetupColumn("hex.builtin.view.io_statistics.average_latency"_lang);
+                    ImGui::TableSetupColumn("hex.builtin.view.io_statistics.cache_hits"_lang);
+                    ImGui::TableSetupColumn("hex.builtin.view.io_statistics.cache_misses"_lang);
+
+                    ImGui::TableHeadersRow();
+
+                    for (const auto &[caller, statistics] : callers) {
+                        ImGui::PushID(caller.c_str());
+
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        if (ImGui::Selectable(getCallerName(caller).c_str(), this->m_selectedCaller == caller, ImGuiSelectableFlags_SpanAllColumns))
+                            this->m_selectedCaller = caller;
+                        ImGui::TableNextColumn();
+                        ImGui::TextFormatted("{}", statistics.calls);
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(hex::toByteString(statistics.bytes).c_str());
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(formatDuration(statistics.totalDuration / std::max<u64>(statistics.calls, 1)).c_str());
+                        ImGui::TableNextColumn();
+                        ImGui::TextFormatted("{}", statistics.cacheHits);
+                        ImGui::TableNextColumn();
+                        ImGui::TextFormatted("{}", statistics.cacheMisses);
+
+                        ImGui::PopID();
+                    }
+
+                    ImGui::EndTable();
+                }
+
+                // Latency distribution of the selected caller. Bucket n holds reads taking less than 2^n µs
+                if (auto selected = callerStatistics.find(this->m_selectedCaller); selected != callerStatistics.end()) {
+                    std::array<float, IoStatistics::LatencyBucketCount> buckets = { };
+                    std::transform(selected->second.latencyHistogram.begin(), selected->second.latencyHistogram.end(), buckets.begin(), [](u64 count) { return float(count); });
+
+                    const auto label = hex::format("hex.builtin.view.io_statistics.latency"_lang, getCallerName(selected->first));
+                    ImGui::PlotHistogram("##latency", buckets.data(), int(buckets.size()), 0, label.c_str(), 0.0F, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, histogramHeight));
+                }
+            }
+        }
+        ImGui::End();
+    }
+
+    void ViewIoStatistics::exportTrace(prv::Provider *provider) {
+        auto trace = provider->getIoStatistics().getTrace();
+
+        fs::openFileBrowser(fs::DialogMode::Save, { { "CSV", "csv" } }, [trace = std::move(trace)](const std::fs::path &path) {
+            wolv::io::File file(path, wolv::io::File::Mode::Create);
+            if (!file.isValid()) {
+                log::error("Failed to create {}", wolv::util::toUTF8String(path));
+                return;
+            }
+
+            file.writeString("time,offset,size,duration_ns,caller\n");
+            for (const auto &entry : trace) {
+                const auto time = std::chrono::duration_cast<std::chrono::microseconds>(entry.time.time_since_epoch()).count();
+                file.writeString(hex::format("{},0x{:X},{},{},\"{}\"\n", time, entry.offset, entry.size, entry.duration.count(), entry.caller));
+            }
+        });
+    }
+
+}
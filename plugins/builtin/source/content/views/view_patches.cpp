@@ -5,6 +5,7 @@
 #include <hex/api/project_file_manager.hpp>
 #include <nlohmann/json.hpp>
 
+#include <limits>
 #include <string>
 
 using namespace std::literals::string_literals;
@@ -18,7 +19,7 @@ namespace hex::plugin::builtin {
             .required = false,
             .load = [](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) {
                 auto json = nlohmann::json::parse(tar.readString(basePath));
-                provider->getPatches() = json.at("patches").get<std::map<u64, u8>>();
+                provider->getPatches() = json.at("patches").get<prv::PatchStore>();
                 return true;
             },
             .store = [](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) {
@@ -41,8 +42,8 @@ namespace hex::plugin::builtin {
             u8 byte = 0x00;
             provider->read(offset, &byte, sizeof(u8), false);
 
-            const auto &patches = provider->getPatches();
-            if (patches.contains(offset) && patches.at(offset) != byte)
+            const auto patch = provider->getPatches().get(offset);
+            if (patch.has_value() && *patch != byte)
                 return ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarRed);
             else
                 return std::nullopt;
@@ -72,14 +73,19 @@ namespace hex::plugin::builtin {
 
                     ImGuiListClipper clipper;
 
-                    clipper.Begin(patches.size());
+                    clipper.Begin(int(std::min<size_t>(patches.size(), std::numeric_limits<int>::max())));
                     while (clipper.Step()) {
+                        // Find the patched run that contains the first visible byte
                         auto iter = patches.begin();
-                        for (auto i = 0; i < clipper.DisplayStart; i++)
+                        u64 iterOffset = clipper.DisplayStart;
+                        while (iter != patches.end() && iterOffset >= iter->second.size()) {
+                            iterOffset -= iter->second.size();
                             iter++;
+                        }
 
-                        for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                            const auto &[address, patch] = *iter;
+                        for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd && iter != patches.end(); i++) {
+                            const auto address = iter->first + iterOffset;
+                            const auto patch   = iter->second[iterOffset];
 
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
@@ -103,13 +109,20 @@ namespace hex::plugin::builtin {
                             ImGui::TextFormatted("0x{0:02X}", patch);
                             index += 1;
 
-                            iter++;
+                            iterOffset++;
+                            if (iterOffset >= iter->second.size()) {
+                                iterOffset = 0;
+                                iter++;
+                            }
                         }
                     }
 
                     if (ImGui::BeginPopup("PatchContextMenu")) {
                         if (ImGui::MenuItem("hex.builtin.view.patches.remove"_lang)) {
-                            patches.erase(this->m_selectedPatch);
+                            // Writing back the original value removes the patch while keeping it undoable
+                            u8 originalValue = 0x00;
+                            provider->readRaw(this->m_selectedPatch - provider->getBaseAddress(), &originalValue, sizeof(u8));
+                            provider->addPatch(this->m_selectedPatch, &originalValue, sizeof(u8), true);
                         }
                         ImGui::EndPopup();
                     }
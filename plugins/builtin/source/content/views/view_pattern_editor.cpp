@@ -145,6 +145,7 @@ namespace hex::plugin::builtin {
         EventManager::unsubscribe<EventFileLoaded>(this);
         EventManager::unsubscribe<EventProviderChanged>(this);
         EventManager::unsubscribe<EventProviderClosed>(this);
+        EventManager::unsubscribe<EventProviderDataReloaded>(this);
     }
 
     void ViewPatternEditor::drawContent() {
@@ -521,10 +522,8 @@ namespace hex::plugin::builtin {
                     ImGui::TextFormatted("{} | 0x{:02X}", hex::toByteString(section.data.size()), section.data.size());
                     ImGui::TableNextColumn();
                     if (ImGui::IconButton(ICON_VS_OPEN_PREVIEW, ImGui::GetStyleColorVec4(ImGuiCol_Text))) {
-                        auto dataProvider = std::make_unique<MemoryFileProvider>();
-                        dataProvider->resize(section.data.size());
-                        dataProvider->writeRaw(0x00, section.data.data(), section.data.size());
-                        dataProvider->setReadOnly(true);
+                        // The section data stays alive until the pattern gets evaluated again, which closes this window first
+                        auto dataProvider = std::make_unique<BufferProvider>(section.data);
 
                         auto hexEditor = auto(this->m_sectionHexEditor);
 
@@ -1043,6 +1042,10 @@ namespace hex::plugin::builtin {
             this->m_envVarEntries->push_back({ 0, "", 0, EnvVarType::Integer });
         });
 
+        EventManager::subscribe<EventProviderDataReloaded>(this, [this](prv::Provider *provider) {
+            this->m_shouldAnalyze.get(provider) = true;
+        });
+
         EventManager::subscribe<EventProviderChanged>(this, [this](prv::Provider *oldProvider, prv::Provider *newProvider) {
             if (!this->m_syncPatternSourceCode) {
                 if (oldProvider != nullptr)
@@ -1059,7 +1062,9 @@ namespace hex::plugin::builtin {
             }
         });
 
-        EventManager::subscribe<EventProviderClosed>(this, [this](prv::Provider *) {
+        EventManager::subscribe<EventProviderClosed>(this, [this](prv::Provider *provider) {
+            this->m_sectionWindowDrawer.erase(provider);
+
             if (this->m_syncPatternSourceCode && ImHexApi::Provider::getProviders().empty()) {
                 this->m_textEditor.SetText("");
             }
@@ -341,15 +341,13 @@ namespace hex::plugin::builtin {
                     auto &context = *static_cast<ScanContext *>(block->context);
                     auto provider = ImHexApi::Provider::get();
 
-                    context.buffer.resize(context.currBlock.size);
-
-                    if (context.buffer.empty())
+                    if (context.currBlock.size == 0)
                         return nullptr;
 
                     block->size = context.currBlock.size;
-                    provider->read(context.currBlock.base + provider->getBaseAddress(), context.buffer.data(), context.buffer.size());
 
-                    return context.buffer.data();
+                    // Scan directly in the provider's memory if possible instead of copying every block
+                    return provider->readSpan(context.currBlock.base + provider->getBaseAddress(), context.currBlock.size, context.buffer).data();
                 };
                 iterator.file_size = [](auto *iterator) -> u64 {
                     hex::unused(iterator);
@@ -373,6 +371,7 @@ namespace hex::plugin::builtin {
 
                     u64 address = context.currBlock.base + context.currBlock.size;
 
+                    // Holes of sparse files are handed to YARA like any other data. Rules may match zeros or read values inside them
                     iterator->last_error      = ERROR_SUCCESS;
                     context.currBlock.base    = address;
                     context.currBlock.size    = std::min<size_t>(ImHexApi::Provider::get()->getActualSize() - address, 10_MiB);
@@ -4,6 +4,7 @@
 #include <hex/api/localization.hpp>
 
 #include <hex/helpers/encoding_file.hpp>
+#include <hex/helpers/memory_arena.hpp>
 #include <hex/helpers/utils.hpp>
 
 namespace hex::plugin::builtin::ui {
@@ -124,7 +125,8 @@ namespace hex::plugin::builtin::ui {
 
         size_t size = std::min<size_t>(longestSequence, provider->getActualSize() - address);
 
-        std::vector<u8> buffer(size);
+        auto buffer = FrameArena::createVector<u8>(size);
+        buffer.resize(size);
         provider->read(address, buffer.data(), size);
 
         const auto [decoded, advance] = encodingFile.getEncodingFor(buffer);
@@ -167,8 +169,8 @@ namespace hex::plugin::builtin::ui {
 
         if (this->m_editingAddress != address || this->m_editingCellType != cellType) {
             if (cellType == CellType::Hex) {
-                std::vector<u8> buffer(size);
-                std::memcpy(buffer.data(), data, size);
+                auto buffer = FrameArena::createVector<u8>(size);
+                buffer.assign(data, data + size);
 
                 if (this->m_dataVisualizerEndianness != std::endian::native)
                     std::reverse(buffer.begin(), buffer.end());
@@ -342,8 +344,48 @@ namespace hex::plugin::builtin::ui {
                 while (clipper.Step()) {
                     this->m_visibleRowCount = clipper.DisplayEnd - clipper.DisplayStart;
 
+                    // Read the data of all visible rows in one batch
+                    const u64 firstRow = u64(clipper.DisplayStart);
+                    const u64 lastRow  = std::max(firstRow, std::min(numRows, u64(clipper.DisplayEnd)));
+
+                    // Everything allocated while drawing the rows only lives until the end of the frame
+                    const auto visibleBytesSize = (lastRow - firstRow) * this->m_bytesPerRow;
+                    auto visibleBytes = FrameArena::createVector<u8>(visibleBytesSize);
+                    visibleBytes.resize(visibleBytesSize, 0x00);
+
+                    // Slow providers load data in the background. Until it arrived, placeholders are drawn instead of blocking the UI
+                    const u64 rowsStartAddress = this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
+                    const u64 visibleSize      = std::min<u64>(lastRow * this->m_bytesPerRow, this->m_provider->getSize()) - std::min<u64>(firstRow * this->m_bytesPerRow, this->m_provider->getSize());
+                    const bool dataAvailable   = this->m_provider->isDataAvailable(rowsStartAddress + firstRow * this->m_bytesPerRow, visibleSize);
+
+                    {
+                        // Also request the rows right above and below the visible ones so scrolling doesn't have to wait for them
+                        const u64 prefetchRows  = std::max<u64>(lastRow - firstRow, 1);
+                        const u64 prefetchStart = std::min<u64>((firstRow - std::min(firstRow, prefetchRows)) * this->m_bytesPerRow, this->m_provider->getSize());
+                        const u64 prefetchEnd   = std::min<u64>((lastRow + prefetchRows) * this->m_bytesPerRow, this->m_provider->getSize());
+
+                        if (prefetchStart < prefetchEnd)
+                            this->m_provider->prefetch(Region { rowsStartAddress + prefetchStart, prefetchEnd - prefetchStart });
+
+                        // Requested last so it gets loaded first
+                        if (!dataAvailable)
+                            this->m_provider->prefetch(Region { rowsStartAddress + firstRow * this->m_bytesPerRow, visibleSize });
+                    }
+
+                    if (dataAvailable) {
+                        auto rowReads = FrameArena::createVector<prv::Provider::ReadRequest>(lastRow - firstRow);
+                        for (u64 y = firstRow; y < lastRow; y++) {
+                            rowReads.push_back({
+                                y * this->m_bytesPerRow + rowsStartAddress,
+                                std::min<u64>(this->m_bytesPerRow, this->m_provider->getSize() - y * this->m_bytesPerRow),
+                                visibleBytes.data() + (y - firstRow) * this->m_bytesPerRow
+                            });
+                        }
+                        this->m_provider->readv(rowReads);
+                    }
+
                     // Loop over rows
-                    for (u64 y = u64(clipper.DisplayStart); y < std::min(numRows, u64(clipper.DisplayEnd)); y++) {
+                    for (u64 y = firstRow; y < lastRow; y++) {
                         // Draw address column
                         ImGui::TableNextRow();
                         ImGui::TableNextColumn();
@@ -352,10 +394,9 @@ namespace hex::plugin::builtin::ui {
 
                         const u8 validBytes = std::min<u64>(this->m_bytesPerRow, this->m_provider->getSize() - y * this->m_bytesPerRow);
 
-                        std::vector<u8> bytes(this->m_bytesPerRow, 0x00);
-                        this->m_provider->read(y * this->m_bytesPerRow + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress(), bytes.data(), validBytes);
+                        const std::span<u8> bytes(visibleBytes.data() + (y - firstRow) * this->m_bytesPerRow, this->m_bytesPerRow);
 
-                        std::vector<std::tuple<std::optional<color_t>, std::optional<color_t>>> cellColors;
+                        auto cellColors = FrameArena::createVector<std::tuple<std::optional<color_t>, std::optional<color_t>>>(columnCount);
                         {
                             for (u64 x = 0; x <  std::ceil(float(validBytes) / bytesPerCell); x++) {
                                 const u64 byteAddress = y * this->m_bytesPerRow + x * bytesPerCell + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
@@ -444,7 +485,7 @@ namespace hex::plugin::builtin::ui {
                                 // Draw cell content
                                 ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
                                 ImGui::PushItemWidth((CharacterSize * maxCharsPerCell).x);
-                                if (isCurrRegionValid(byteAddress))
+                                if (dataAvailable && isCurrRegionValid(byteAddress))
                                     this->drawCell(byteAddress, &bytes[x * bytesPerCell], bytesPerCell, cellHovered, CellType::Hex);
                                 else
                                     ImGui::TextFormatted("{}", std::string(maxCharsPerCell, '?'));
@@ -499,7 +540,7 @@ namespace hex::plugin::builtin::ui {
                                         ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (this->m_characterCellPadding * 1_scaled) / 2);
                                         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
                                         ImGui::PushItemWidth(CharacterSize.x);
-                                        if (!isCurrRegionValid(byteAddress))
+                                        if (!dataAvailable || !isCurrRegionValid(byteAddress))
                                             ImGui::TextFormattedDisabled("{}", this->m_unknownDataCharacter);
                                         else
                                             this->drawCell(byteAddress, &bytes[x], 1, cellHovered, CellType::ASCII);
@@ -518,7 +559,7 @@ namespace hex::plugin::builtin::ui {
 
                         // Draw Custom encoding column
                         if (this->m_showCustomEncoding && this->m_currCustomEncoding.has_value()) {
-                            std::vector<std::pair<u64, CustomEncodingData>> encodingData;
+                            auto encodingData = FrameArena::createVector<std::pair<u64, CustomEncodingData>>(this->m_bytesPerRow);
 
                             if (this->m_encodingLineStartAddresses.empty()) {
                                 this->m_encodingLineStartAddresses.push_back(0);
@@ -29,7 +29,11 @@ namespace hex::plugin::windows {
         [[nodiscard]] bool isSavable() const override { return false; }
         [[nodiscard]] bool isDumpable() const override { return false; }
 
-        void read(u64 address, void *buffer, size_t size, bool) override { this->readRaw(address, buffer, size); }
+        void read(u64 address, void *buffer, size_t size, bool) override {
+            prv::IoStatistics::ReadScope readScope(this, address, size);
+
+            this->readRaw(address, buffer, size);
+        }
         void write(u64 address, const void *buffer, size_t size) override { this->writeRaw(address, buffer, size); }
 
         void readRaw(u64 address, void *buffer, size_t size) override;
@@ -0,0 +1,125 @@
+#include <hex/test/tests.hpp>
+
+#include <hex/providers/io_ring.hpp>
+
+#include <wolv/io/file.hpp>
+#include <wolv/utils/guards.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <vector>
+
+#if defined(OS_LINUX)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr size_t BenchmarkFileSize = 0x1000'0000;
+    constexpr size_t ReadSize          = 0x10'0000;
+
+    /**
+     * @brief Reads an entire file in chunks the same way ProviderReader driven scans do and returns the throughput in MiB/s
+     */
+    [[maybe_unused]] double measureThroughput(int fd, u64 fileSize, u64 &checksum, const std::function<bool(u64, u8 *, size_t)> &readFunction) {
+        #if defined(OS_LINUX)
+            // Make sure every run has to actually go to the disk. Dirty pages can't be dropped, so they have to be written back first
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        #endif
+
+        std::vector<u8> buffer(ReadSize);
+        checksum = 0;
+
+        // Only the reads themselves are timed, the checksum is just there to compare the data read by both paths
+        double duration = 0;
+        for (u64 offset = 0; offset < fileSize; offset += ReadSize) {
+            const auto size = std::min<u64>(ReadSize, fileSize - offset);
+
+            const auto start = std::chrono::steady_clock::now();
+            if (!readFunction(offset, buffer.data(), size))
+                return 0;
+            duration += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            for (size_t i = 0; i < size; i++)
+                checksum = std::rotl(checksum, 5) ^ buffer[i];
+        }
+
+        return (double(fileSize) / 0x10'0000) / std::max(duration, 1E-9);
+    }
+
+}
+
+TEST_SEQUENCE("IoRingThroughput") {
+    #if defined(OS_LINUX)
+        // A large file that's already on disk can be used instead of a generated one to get more realistic numbers
+        std::fs::path path;
+        bool generated = false;
+        ON_SCOPE_EXIT {
+            if (generated) {
+                std::error_code error;
+                std::fs::remove(path, error);
+            }
+        };
+
+        if (auto environmentPath = std::getenv("IMHEX_BENCHMARK_FILE"); environmentPath != nullptr) {
+            path = environmentPath;
+        } else {
+            path = std::fs::current_path() / "io_ring_benchmark.bin";
+            generated = true;
+
+            wolv::io::File file(path, wolv::io::File::Mode::Create);
+            TEST_ASSERT(file.isValid());
+
+            std::mt19937_64 random(0x1337);
+            std::vector<u8> block(ReadSize);
+            for (size_t offset = 0; offset < BenchmarkFileSize; offset += block.size()) {
+                std::generate(block.begin(), block.end(), [&] { return u8(random()); });
+                file.writeBuffer(block.data(), block.size());
+            }
+        }
+
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        TEST_ASSERT(fd != -1, "{}", path.string());
+        ON_SCOPE_EXIT { ::close(fd); };
+
+        const u64 fileSize = ::lseek(fd, 0, SEEK_END);
+
+        u64 syncChecksum = 0, ringChecksum = 0;
+
+        const auto syncThroughput = measureThroughput(fd, fileSize, syncChecksum, [fd](u64 offset, u8 *buffer, size_t size) {
+            while (size > 0) {
+                const auto bytesRead = ::pread(fd, buffer, size, offset);
+                if (bytesRead <= 0)
+                    return false;
+
+                buffer += bytesRead;
+                offset += bytesRead;
+                size   -= bytesRead;
+            }
+
+            return true;
+        });
+        hex::log::info("Blocking reads: {:.1f} MiB/s", syncThroughput);
+
+        hex::prv::IoRing ring;
+        if (ring.isValid()) {
+            const auto ringThroughput = measureThroughput(fd, fileSize, ringChecksum, [fd, &ring](u64 offset, u8 *buffer, size_t size) {
+                return ring.read(fd, offset, buffer, size);
+            });
+            hex::log::info("io_uring with queue depth {}: {:.1f} MiB/s", ring.getQueueDepth(), ringThroughput);
+
+            TEST_ASSERT(ringChecksum == syncChecksum);
+        } else {
+            hex::log::info("io_uring is not available on this system");
+        }
+    #endif
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,154 @@
+#include <hex/test/tests.hpp>
+#include <hex/test/test_provider.hpp>
+
+#include <hex/helpers/memory_arena.hpp>
+
+#include <ui/hex_editor.hpp>
+
+#include <imgui.h>
+
+#include <wolv/utils/guards.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <vector>
+
+namespace hex::plugin::builtin {
+
+    void registerDataVisualizers();
+
+}
+
+namespace {
+
+    std::atomic<u64> s_heapAllocationCount = 0;
+
+}
+
+// Counts every heap allocation made by the benchmark
+void *operator new(size_t size) {
+    s_heapAllocationCount += 1;
+
+    if (auto pointer = std::malloc(std::max<size_t>(size, 1)); pointer != nullptr)
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+    constexpr u32 FrameCount       = 1'000;
+    constexpr u32 WarmupFrameCount = 10;
+
+    /**
+     * @brief Provider whose data is valid everywhere, so the hex editor draws all of its cells
+     */
+    class ValidTestProvider : public hex::test::TestProvider {
+    public:
+        using TestProvider::TestProvider;
+
+        [[nodiscard]] std::pair<hex::Region, bool> getRegionValidity(u64 address) const override {
+            if (address >= this->getActualSize())
+                return { hex::Region::Invalid(), false };
+
+            return { hex::Region { address, this->getActualSize() - address }, true };
+        }
+    };
+
+    /**
+     * @brief Draws frames of the hex editor into an ImGui context without any window behind it
+     * @param hexEditor Hex editor to draw
+     * @param rowCount Number of rows the hex editor gets space for
+     * @return Number of heap allocations per frame
+     */
+    double measureFrameAllocations(hex::plugin::builtin::ui::HexEditor &hexEditor, u32 rowCount) {
+        const auto drawFrame = [&] {
+            auto &io = ImGui::GetIO();
+            io.DisplaySize = ImVec2(1920, 2160);
+            io.DeltaTime   = 1.0F / 60.0F;
+
+            ImGui::NewFrame();
+
+            ImGui::SetNextWindowPos(ImVec2(0, 0));
+            ImGui::SetNextWindowSize(io.DisplaySize);
+            if (ImGui::Begin("##hex_editor", nullptr, ImGuiWindowFlags_NoDecoration)) {
+                const auto rowHeight    = ImGui::CalcTextSize("0").y;
+                const auto footerHeight = ImGui::GetTextLineHeightWithSpacing() * 3.6F;
+
+                // Two more rows for the header of the table
+                hexEditor.draw((rowCount + 2) * rowHeight + footerHeight);
+            }
+            ImGui::End();
+
+            ImGui::Render();
+
+            // Same as at the end of every frame of the main window
+            hex::FrameArena::reset();
+        };
+
+        // The arena and ImGui's own buffers grow during the first frames
+        for (u32 frame = 0; frame < WarmupFrameCount; frame++)
+            drawFrame();
+
+        const auto allocationsBefore = s_heapAllocationCount.load();
+        const auto start = std::chrono::steady_clock::now();
+
+        for (u32 frame = 0; frame < FrameCount; frame++)
+            drawFrame();
+
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto allocations = double(s_heapAllocationCount.load() - allocationsBefore) / FrameCount;
+
+        hex::log::info("{} rows:", rowCount);
+        hex::log::info("  {:.2f} µs per frame", duration * 1'000'000 / FrameCount);
+        hex::log::info("  {:.1f} heap allocations per frame", allocations);
+
+        return allocations;
+    }
+
+}
+
+TEST_SEQUENCE("HexEditorFrameAllocations") {
+    hex::plugin::builtin::registerDataVisualizers();
+
+    ImGui::CreateContext();
+    ON_SCOPE_EXIT { ImGui::DestroyContext(); };
+
+    auto &io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+
+    // Builds the default font. Nothing is ever uploaded as there's no renderer
+    unsigned char *pixels = nullptr;
+    int width = 0, height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    std::vector<u8> data(0x10'0000);
+    std::iota(data.begin(), data.end(), 0x00);
+    ValidTestProvider provider(&data);
+
+    hex::plugin::builtin::ui::HexEditor hexEditor(&provider);
+
+    constexpr u32 FewRows = 8, ManyRows = 80;
+    const auto fewRowsAllocations  = measureFrameAllocations(hexEditor, FewRows);
+    const auto manyRowsAllocations = measureFrameAllocations(hexEditor, ManyRows);
+
+    const auto allocationsPerRow = (manyRowsAllocations - fewRowsAllocations) / (ManyRows - FewRows);
+    hex::log::info("{:.2f} heap allocations per additional row", allocationsPerRow);
+
+    // Temporary data of the rows and cells comes from the frame arena, so drawing more rows must not allocate more
+    TEST_ASSERT(allocationsPerRow < 0.5, "{}", allocationsPerRow);
+
+    TEST_SUCCESS();
+};
@@ -1,9 +1,28 @@
 #include <hex/test/tests.hpp>
 #include <hex/test/test_provider.hpp>
 
+#include <hex/api/event.hpp>
+#include <hex/api/task.hpp>
+
 #include <hex/helpers/crypto.hpp>
+#include <hex/providers/gap_buffer.hpp>
+#include <hex/providers/io_statistics.hpp>
+#include <hex/providers/piece_table.hpp>
+#include <hex/providers/provider_cache.hpp>
+#include <hex/providers/snapshot.hpp>
+#include <hex/providers/zero_regions.hpp>
+
+#include <wolv/utils/guards.hpp>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 TEST_SEQUENCE("TestSucceeding") {
@@ -43,6 +62,31 @@ TEST_SEQUENCE("TestProvider_read") {
     TEST_SUCCESS();
 };
 
+TEST_SEQUENCE("TestProvider_readv") {
+    std::vector<u8> data { 0xde, 0xad, 0xbe, 0xef, 0x42, 0x2a, 0x00, 0xff };
+    hex::test::TestProvider provider(&data);
+    hex::prv::Provider *provider2 = &provider;
+
+    u8 buff[1024];
+
+    std::fill(std::begin(buff), std::end(buff), 22);
+    const hex::prv::Provider::ReadRequest requests[] = {
+        { 4, 2, buff + 10 },
+        { 0, 2, buff },
+        { 1, 2, buff + 20 },    // overlapping requests are allowed
+    };
+    provider2->readv(requests);
+    TEST_ASSERT(buff[0] == 0xde);
+    TEST_ASSERT(buff[1] == 0xad);
+    TEST_ASSERT(buff[2] == 22);    // should be unchanged
+    TEST_ASSERT(buff[10] == 0x42);
+    TEST_ASSERT(buff[11] == 0x2a);
+    TEST_ASSERT(buff[20] == 0xad);
+    TEST_ASSERT(buff[21] == 0xbe);
+
+    TEST_SUCCESS();
+};
+
 TEST_SEQUENCE("TestProvider_write") {
     std::vector<u8> buff(8);
     hex::test::TestProvider provider(&buff);
@@ -81,3 +125,591 @@ TEST_SEQUENCE("TestProvider_write") {
 
     TEST_SUCCESS();
 };
+
+TEST_SEQUENCE("TestProvider_patches") {
+    std::vector<u8> buff(16, 0x00);
+    hex::test::TestProvider provider(&buff);
+    hex::prv::Provider *provider2 = &provider;
+
+    u8 data[] = { 0xde, 0xad, 0xbe, 0xef };
+
+    provider2->addPatch(2, data, 2);
+    provider2->addPatch(4, data + 2, 2);
+    TEST_ASSERT(provider2->getPatches().size() == 4);
+    TEST_ASSERT(provider2->getPatches().getExtents().size() == 1);    // adjacent patches should be merged
+
+    u8 read[8] = { };
+    provider2->read(0, read, sizeof(read));
+    TEST_ASSERT(read[1] == 0x00);
+    TEST_ASSERT(read[2] == 0xde);
+    TEST_ASSERT(read[5] == 0xef);
+    TEST_ASSERT(read[6] == 0x00);
+
+    u8 zero = 0x00;
+    provider2->addPatch(3, &zero, 1);    // writing the original value removes the patch
+    TEST_ASSERT(provider2->getPatches().size() == 3);
+    TEST_ASSERT(provider2->getPatches().getExtents().size() == 2);
+    TEST_ASSERT(!provider2->getPatches().contains(3));
+    TEST_ASSERT(provider2->getPatches().get(4) == 0xbe);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_undo") {
+    std::vector<u8> buff(16, 0x00);
+    hex::test::TestProvider provider(&buff);
+    hex::prv::Provider *provider2 = &provider;
+
+    u8 data[] = { 0xde, 0xad, 0xbe, 0xef };
+
+    provider2->addPatch(0, data, 4, true);
+    provider2->addPatch(2, data, 2, true);
+    TEST_ASSERT(provider2->getPatches().get(2) == 0xde);
+
+    provider2->undo();
+    TEST_ASSERT(provider2->getPatches().get(2) == 0xbe);
+    TEST_ASSERT(provider2->canRedo());
+
+    provider2->undo();
+    TEST_ASSERT(provider2->getPatches().empty());
+    TEST_ASSERT(!provider2->canUndo());
+
+    provider2->redo();
+    provider2->redo();
+    TEST_ASSERT(provider2->getPatches().get(2) == 0xde);
+    TEST_ASSERT(provider2->getPatches().get(3) == 0xad);
+    TEST_ASSERT(!provider2->canRedo());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_fill") {
+    std::vector<u8> buff(0x10'0000, 0x00);
+    hex::test::TestProvider provider(&buff);
+    hex::prv::Provider *provider2 = &provider;
+
+    const std::vector<u8> pattern = { 0xaa, 0xbb, 0xcc };
+    provider2->addFillPatch(0x10, 0x8'0000, pattern, true);
+    TEST_ASSERT(provider2->getPatches().size() == 0x8'0000);
+    TEST_ASSERT(provider2->getPatches().getExtents().size() == 1);
+    TEST_ASSERT(provider2->getPatches().getStoredSize() == pattern.size());    // the pattern is not expanded
+
+    u8 read[4] = { };
+    provider2->read(0x10 + 0x4'0000, read, sizeof(read));
+    TEST_ASSERT(read[0] == pattern[0x4'0000 % 3]);
+    TEST_ASSERT(read[1] == pattern[0x4'0001 % 3]);
+
+    u8 value = 0x42;
+    provider2->addPatch(0x20, &value, sizeof(value), true);    // writing into the fill splits it up
+    TEST_ASSERT(provider2->getPatches().get(0x20) == 0x42);
+    TEST_ASSERT(provider2->getPatches().get(0x21) == pattern[0x11 % 3]);
+
+    provider2->undo();
+    provider2->undo();
+    TEST_ASSERT(provider2->getPatches().empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_fill_interrupted") {
+    // Stores fills as patches like the file provider does
+    class FillTestProvider : public hex::test::TestProvider {
+    public:
+        using TestProvider::TestProvider;
+
+        PreparedFill prepareFill(u64 offset, size_t size, const std::vector<u8> &pattern, const std::function<void(u64)> &progressCallback) override {
+            return this->preparePatchFill(offset, size, pattern, progressCallback);
+        }
+
+        void fill(const PreparedFill &fill) override {
+            this->addFillPatch(fill, true);
+        }
+    };
+
+    std::vector<u8> buff(0x40'0000, 0x11);
+    FillTestProvider provider(&buff);
+    hex::prv::Provider *provider2 = &provider;
+
+    u64 patchEvents = 0;
+    bool originalValuesValid = true;
+    auto token = hex::EventManager::subscribe<hex::EventPatchRangeCreated>([&](u64, std::span<const u8> originalValues, std::span<const u8> newValues) {
+        originalValuesValid = originalValuesValid && std::all_of(originalValues.begin(), originalValues.end(), [](u8 value) { return value == 0x11; });
+        patchEvents += newValues.size();
+    });
+    ON_SCOPE_EXIT { hex::EventManager::unsubscribe(token); };
+
+    const std::vector<u8> pattern = { 0xaa, 0xbb };
+
+    // Interrupting the task while the fill is being prepared must leave the provider untouched
+    hex::Task task("Fill", buff.size(), false, [](hex::Task &) { });
+    u64 progress = 0;
+    bool interrupted = false;
+    try {
+        auto fill = provider2->prepareFill(0x00, buff.size(), pattern, [&](u64 processed) {
+            progress = processed;
+            if (processed >= buff.size() / 2)
+                task.interrupt();
+
+            task.update(processed);
+        });
+
+        provider2->fill(fill);
+    } catch (...) {
+        interrupted = true;
+    }
+
+    TEST_ASSERT(interrupted);
+    TEST_ASSERT(progress < buff.size());
+    TEST_ASSERT(provider2->getPatches().empty());
+    TEST_ASSERT(!provider2->canUndo());
+    TEST_ASSERT(!provider2->isDirty());
+    TEST_ASSERT(patchEvents == 0);
+
+    // An uninterrupted fill gets applied as a single undo point
+    auto fill = provider2->prepareFill(0x00, buff.size(), pattern);
+    TEST_ASSERT(provider2->getPatches().empty());    // preparing doesn't modify anything
+    TEST_ASSERT(fill.originalValues.size() == buff.size());
+
+    provider2->fill(fill);
+    TEST_ASSERT(provider2->getPatches().size() == buff.size());
+    TEST_ASSERT(patchEvents == buff.size());
+    TEST_ASSERT(originalValuesValid);
+
+    provider2->undo();
+    TEST_ASSERT(provider2->getPatches().empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_overlays") {
+    std::vector<u8> buff(16, 0x00);
+    hex::test::TestProvider provider(&buff);
+    hex::prv::Provider *provider2 = &provider;
+
+    auto lower = provider2->newOverlay();
+    lower->setAddress(2);
+    lower->setData(std::vector<u8> { 0x11, 0x11, 0x11, 0x11 });
+
+    auto upper = provider2->newOverlay();
+    upper->setAddress(4);
+    upper->setData(std::vector<u8> { 0x22, 0x22 });
+
+    u8 read[8] = { };
+    provider2->read(0, read, sizeof(read));
+    TEST_ASSERT(read[1] == 0x00);
+    TEST_ASSERT(read[2] == 0x11);
+    TEST_ASSERT(read[4] == 0x22);    // overlays added later are applied on top
+    TEST_ASSERT(read[6] == 0x00);
+
+    upper->setAddress(8);
+    provider2->read(0, read, sizeof(read));
+    TEST_ASSERT(read[4] == 0x11);
+
+    auto [region, valid] = provider2->getRegionValidity(6);
+    TEST_ASSERT(!valid && region.getEndAddress() == 7);
+
+    provider2->deleteOverlay(lower);
+    provider2->read(0, read, sizeof(read));
+    TEST_ASSERT(read[2] == 0x00);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ProviderCache") {
+    std::vector<u8> data(0x4000);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = u8(i * 7);
+
+    std::atomic<u32> backendReads = 0;
+    const auto readFunction = [&](u64 offset, void *buffer, size_t size) {
+        backendReads++;
+        std::memcpy(buffer, data.data() + offset, size);
+    };
+
+    hex::prv::ProviderCache cache(0x100, 0x10000);
+
+    std::vector<u8> buffer(0x180);
+    cache.read(0x80, buffer.data(), buffer.size(), data.size(), readFunction);
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.end(), data.begin() + 0x80));
+    TEST_ASSERT(backendReads == 1);    // both missing blocks should be fetched with a single read
+
+    cache.read(0x100, buffer.data(), 0x100, data.size(), readFunction);
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.begin() + 0x100, data.begin() + 0x100));
+    TEST_ASSERT(backendReads == 1);
+    TEST_ASSERT(cache.getStatistics().hits == 1);
+
+    data[0x120] = 0xAA;
+    cache.invalidate(0x120, 1);
+    cache.read(0x120, buffer.data(), 1, data.size(), readFunction);
+    TEST_ASSERT(buffer[0] == 0xAA);
+    TEST_ASSERT(backendReads == 2);
+
+    // Prefetched data gets loaded on a background thread, reading it afterwards doesn't need the backend anymore
+    using namespace std::chrono_literals;
+    cache.prefetch(0x1000, 0x200, data.size(), readFunction);
+    for (u32 i = 0; i < 1000 && !cache.contains(0x1000, 0x200, data.size()); i++)
+        std::this_thread::sleep_for(1ms);
+
+    TEST_ASSERT(cache.contains(0x1000, 0x200, data.size()));
+    TEST_ASSERT(backendReads == 3);
+
+    cache.read(0x1000, buffer.data(), 0x100, data.size(), readFunction);
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.begin() + 0x100, data.begin() + 0x1000));
+    TEST_ASSERT(backendReads == 3);
+
+    // Blocks missing from several requests are all handed to the backend with a single call
+    u32 backendCalls = 0;
+    const auto readvFunction = [&](std::span<const hex::prv::ProviderCache::ReadRequest> requests) {
+        backendCalls++;
+        for (const auto &request : requests)
+            std::memcpy(request.buffer, data.data() + request.offset, request.size);
+    };
+
+    std::vector<u8> buffer2(0x80);
+    const std::array<hex::prv::ProviderCache::ReadRequest, 2> requests = {{
+        { 0x2010, 0x180, buffer.data() },
+        { 0x3040, buffer2.size(), buffer2.data() }
+    }};
+
+    cache.readv(requests, data.size(), readvFunction);
+    TEST_ASSERT(backendCalls == 1);
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.end(), data.begin() + 0x2010));
+    TEST_ASSERT(std::equal(buffer2.begin(), buffer2.end(), data.begin() + 0x3040));
+
+    cache.readv(requests, data.size(), readvFunction);
+    TEST_ASSERT(backendCalls == 1);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("PieceTable") {
+    std::vector<u8> original { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+    const auto readOriginal = [&](u64 offset, u8 *buffer, u64 size) {
+        std::memcpy(buffer, original.data() + offset, size);
+    };
+
+    hex::prv::PieceTable pieceTable(original.size());
+    TEST_ASSERT(!pieceTable.isModified());
+
+    pieceTable.insert(2, 3);
+    pieceTable.remove(7, 2);
+    TEST_ASSERT(pieceTable.isModified());
+    TEST_ASSERT(pieceTable.getSize() == 9);
+
+    std::vector<u8> buffer(pieceTable.getSize());
+    pieceTable.read(0, buffer.data(), buffer.size(), readOriginal);
+    TEST_ASSERT(buffer == std::vector<u8>({ 0x00, 0x11, 0x00, 0x00, 0x00, 0x22, 0x33, 0x66, 0x77 }));
+
+    const u8 value = 0xAA;
+    pieceTable.write(3, &value, 1, [](u64, const u8 *, u64) { });
+    pieceTable.read(0, buffer.data(), buffer.size(), readOriginal);
+    TEST_ASSERT(buffer[3] == 0xAA);
+    TEST_ASSERT(pieceTable.findOriginalAddress(7, 2) == 6);
+    TEST_ASSERT(!pieceTable.findOriginalAddress(1, 2).has_value());    // spans original and inserted bytes
+
+    pieceTable.remove(2, 3);
+    pieceTable.insert(5, 2);
+    pieceTable.remove(5, 2);
+    pieceTable.insert(5, 2);    // make sure removing inserted bytes again leaves the original data behind
+    pieceTable.remove(5, 2);
+    TEST_ASSERT(pieceTable.getPieces().size() == 2);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("GapBuffer") {
+    std::mt19937 random(0x1337);
+    std::vector<u8> expected(0x2'0000);
+    std::generate(expected.begin(), expected.end(), [&] { return u8(random()); });
+
+    hex::prv::GapBuffer gapBuffer(expected);
+
+    // Apply the same random edits to the gap buffer and a plain vector and make sure they always hold the same data
+    std::vector<u8> buffer;
+    for (u32 i = 0; i < 1000; i++) {
+        const u64 offset = random() % (expected.size() + 1);
+        const size_t size = random() % 0x2000;
+
+        switch (random() % 3) {
+            case 0:
+                gapBuffer.insert(offset, size);
+                expected.insert(expected.begin() + offset, size, 0x00);
+                break;
+            case 1:
+                gapBuffer.remove(offset, size);
+                expected.erase(expected.begin() + offset, expected.begin() + std::min<u64>(offset + size, expected.size()));
+                break;
+            case 2: {
+                const size_t writeSize = std::min<u64>(size, expected.size() - offset);
+                buffer.resize(writeSize);
+                std::generate(buffer.begin(), buffer.end(), [&] { return u8(random()); });
+
+                gapBuffer.write(offset, buffer.data(), buffer.size());
+                std::copy(buffer.begin(), buffer.end(), expected.begin() + offset);
+                break;
+            }
+        }
+
+        TEST_ASSERT(gapBuffer.getSize() == expected.size());
+
+        const size_t readSize = std::min<u64>(0x100, expected.size() - std::min<u64>(offset, expected.size()));
+        buffer.resize(readSize);
+        gapBuffer.read(offset, buffer.data(), readSize);
+        TEST_ASSERT(std::equal(buffer.begin(), buffer.end(), expected.begin() + offset));
+    }
+
+    TEST_ASSERT(gapBuffer.toVector() == expected);
+
+    gapBuffer.resize(0x10);
+    expected.resize(0x10);
+    TEST_ASSERT(gapBuffer.toVector() == expected);
+    TEST_ASSERT(gapBuffer.getSpan(0, 0x10).has_value());
+
+    TEST_SUCCESS();
+};
+
+namespace {
+
+    class StableTestProvider : public hex::test::TestProvider {
+    public:
+        using TestProvider::TestProvider;
+
+        [[nodiscard]] bool isDataStable() const override { return true; }
+    };
+
+}
+
+TEST_SEQUENCE("ProviderSnapshot") {
+    using hex::prv::Snapshot;
+    constexpr static auto BlockSize = Snapshot::BlockSize;
+
+    std::mt19937 random(0x1337);
+    std::vector<u8> data(4 * BlockSize);
+    std::generate(data.begin(), data.end(), [&] { return u8(random()); });
+    std::fill_n(data.begin() + 2 * BlockSize, BlockSize, 0x00);
+    const auto original = data;
+
+    std::vector<u8> buffer(data.size());
+
+    // Data that may change behind the provider's back gets copied right away
+    {
+        hex::test::TestProvider provider(&data);
+
+        Snapshot first(&provider);
+        TEST_ASSERT(first.getSource() == nullptr);
+        TEST_ASSERT(first.getStoredSize() == 3 * BlockSize);
+
+        data[BlockSize + 5] ^= 0xFF;
+        first.read(0, buffer.data(), buffer.size());
+        TEST_ASSERT(buffer == original);
+
+        // Only the modified block is stored again
+        Snapshot second(&provider, &first);
+        second.read(0, buffer.data(), buffer.size());
+        TEST_ASSERT(buffer == data);
+        TEST_ASSERT(second.getSharedSize(first, 0) == BlockSize);
+        TEST_ASSERT(second.getSharedSize(first, BlockSize) == 0);
+        TEST_ASSERT(second.getSharedSize(first, 2 * BlockSize) == 2 * BlockSize);
+
+        auto [zeroRegion, zero] = second.getZeroRegion(2 * BlockSize + 1);
+        TEST_ASSERT(zero && zeroRegion.getSize() == BlockSize - 1);
+    }
+
+    data = original;
+
+    // Data that only changes through the provider is only copied right before it gets modified
+    {
+        StableTestProvider provider(&data);
+        hex::prv::Provider *provider2 = &provider;
+
+        auto first = std::make_unique<Snapshot>(provider2);
+        TEST_ASSERT(first->getSource() == provider2);
+        TEST_ASSERT(first->getStoredSize() == 0);
+        TEST_ASSERT(first->getSourceBackedSize(0) == data.size());
+
+        u8 patch[] = { 0xde, 0xad, 0xbe, 0xef };
+        provider2->addPatch(BlockSize + 1, patch, sizeof(patch), true);
+        TEST_ASSERT(first->getSourceBackedSize(0) == BlockSize);
+        TEST_ASSERT(first->getSourceBackedSize(2 * BlockSize) == 2 * BlockSize);
+        first->read(0, buffer.data(), buffer.size());
+        TEST_ASSERT(buffer == original);
+
+        auto second = std::make_unique<Snapshot>(provider2);
+        TEST_ASSERT(second->getSharedSize(*first, 0) == BlockSize);
+        TEST_ASSERT(second->getSharedSize(*first, 2 * BlockSize) == 2 * BlockSize);
+
+        provider2->undo();
+        second->read(BlockSize + 1, buffer.data(), sizeof(patch));
+        TEST_ASSERT(std::equal(patch, patch + sizeof(patch), buffer.begin()));
+
+        // Closing the provider copies everything that's still shared with it
+        second.reset();
+        provider2->write(0, patch, sizeof(patch));
+        provider2->detachSnapshots();
+        TEST_ASSERT(first->getSource() == nullptr);
+
+        data = std::vector<u8>(data.size(), 0xAA);
+        first->read(0, buffer.data(), buffer.size());
+        TEST_ASSERT(buffer == original);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ProviderIoStatistics") {
+    using hex::prv::IoStatistics;
+
+    std::vector<u8> data(0x1000, 0xAA);
+    hex::test::TestProvider provider(&data);
+    hex::prv::Provider *provider2 = &provider;
+    auto &ioStatistics = provider2->getIoStatistics();
+
+    u8 buffer[0x10];
+
+    // Nothing gets collected unless it's enabled
+    provider2->read(0, buffer, sizeof(buffer));
+    TEST_ASSERT(ioStatistics.getCallerStatistics().empty());
+
+    IoStatistics::setEnabled(true);
+    IoStatistics::setTracingEnabled(true);
+    {
+        IoStatistics::CallerScope caller("Test");
+
+        provider2->read(0x10, buffer, sizeof(buffer));
+
+        // Requests merged into a single read only count once
+        u8 buffer2[0x10];
+        std::vector<hex::prv::Provider::ReadRequest> requests = { { 0x100, sizeof(buffer), buffer }, { 0x110, sizeof(buffer2), buffer2 } };
+        provider2->readv(requests);
+
+        // Cache accesses are counted towards the read they're part of
+        hex::prv::ProviderCache cache(0x10);
+        {
+            IoStatistics::ReadScope readScope(provider2, 0, 0x20);
+            for (u32 i = 0; i < 2; i++) {
+                cache.read(0, buffer, sizeof(buffer), data.size(), [&](u64 offset, void *readBuffer, size_t size) {
+                    std::memcpy(readBuffer, data.data() + offset, size);
+                });
+            }
+        }
+    }
+    provider2->read(0, buffer, sizeof(buffer));
+    IoStatistics::setEnabled(false);
+    IoStatistics::setTracingEnabled(false);
+
+    auto callers = ioStatistics.getCallerStatistics();
+    TEST_ASSERT(callers.size() == 2);
+    TEST_ASSERT(callers[""].calls == 1);
+
+    const auto &statistics = callers["Test"];
+    TEST_ASSERT(statistics.calls == 3);
+    TEST_ASSERT(statistics.bytes == 0x50);
+    TEST_ASSERT(statistics.cacheHits == 1 && statistics.cacheMisses == 1);
+    TEST_ASSERT(std::accumulate(statistics.latencyHistogram.begin(), statistics.latencyHistogram.end(), u64(0)) == 3);
+
+    auto trace = ioStatistics.getTrace();
+    TEST_ASSERT(trace.size() == 4);
+    TEST_ASSERT(trace[1].offset == 0x100 && trace[1].size == 0x20 && trace[1].caller == "Test");
+
+    ioStatistics.reset();
+    TEST_ASSERT(ioStatistics.getCallerStatistics().empty() && ioStatistics.getTrace().empty());
+
+    TEST_SUCCESS();
+};
+
+namespace {
+
+    class SparseTestProvider : public hex::test::TestProvider {
+    public:
+        SparseTestProvider(std::vector<u8> *data, std::vector<hex::Region> holes) : TestProvider(data), m_holes(std::move(holes)) { }
+
+        [[nodiscard]] std::pair<hex::Region, bool> getZeroRegion(u64 address) const override {
+            if (address >= this->getActualSize())
+                return { hex::Region::Invalid(), false };
+
+            hex::Region region = { address, this->getActualSize() - address };
+            bool zero = false;
+            for (const auto &hole : this->m_holes) {
+                if (address >= hole.getStartAddress() && address <= hole.getEndAddress()) {
+                    region.size = (hole.getEndAddress() - address) + 1;
+                    zero = true;
+                    break;
+                } else if (hole.getStartAddress() > address) {
+                    region.size = std::min<u64>(region.size, hole.getStartAddress() - address);
+                }
+            }
+
+            if (zero) {
+                if (auto modification = this->findFirstModification(region); modification.has_value()) {
+                    if (*modification == address)
+                        zero = false;
+                    else
+                        region.size = *modification - address;
+                }
+            }
+
+            return { region, zero };
+        }
+
+    private:
+        std::vector<hex::Region> m_holes;
+    };
+
+}
+
+TEST_SEQUENCE("ProviderZeroRegions") {
+    using hex::Region;
+    using Regions = std::vector<Region>;
+
+    std::vector<u8> data(0x1000, 0xAA);
+    std::fill_n(data.begin() + 0x100, 0x400, 0x00);
+    std::fill_n(data.begin() + 0x800, 0x10, 0x00);
+
+    // Providers without any knowledge about their data never report zero bytes
+    {
+        hex::test::TestProvider provider(&data);
+
+        auto [region, zero] = provider.getZeroRegion(0x10);
+        TEST_ASSERT(!zero && region == (Region { 0x10, 0xFF0 }));
+
+        std::tie(region, zero) = provider.getZeroRegion(0x1000);
+        TEST_ASSERT(!zero && region == Region::Invalid());
+
+        TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0, 0x1000 }, 4, 1) == Regions({ { 0, 0x1000 } }));
+    }
+
+    SparseTestProvider provider(&data, { { 0x100, 0x400 }, { 0x800, 0x10 } });
+
+    auto [region, zero] = provider.getZeroRegion(0x00);
+    TEST_ASSERT(!zero && region == (Region { 0x00, 0x100 }));
+    std::tie(region, zero) = provider.getZeroRegion(0x180);
+    TEST_ASSERT(zero && region == (Region { 0x180, 0x380 }));
+    std::tie(region, zero) = provider.getZeroRegion(0x500);
+    TEST_ASSERT(!zero && region == (Region { 0x500, 0x300 }));
+
+    // The edges of runs are still searched, small runs aren't skipped at all
+    TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0, 0x1000 }, 4, 1) == Regions({ { 0, 0x104 }, { 0x4FC, 0x308 }, { 0x80C, 0x7F4 } }));
+    TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0, 0x1000 }, 8, 1) == Regions({ { 0, 0x108 }, { 0x4F8, 0xB08 } }));
+
+    // Searching continues on the same grid of aligned addresses after a run
+    TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0, 0x1000 }, 4, 8) == Regions({ { 0, 0x104 }, { 0x4F8, 0xB08 } }));
+
+    // Regions lying entirely inside of a run only keep their edges
+    TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0x200, 0x100 }, 4, 1) == Regions({ { 0x200, 0x04 }, { 0x2FC, 0x04 } }));
+    TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0x200, 0x00 }, 4, 1) == Regions({ { 0x200, 0x00 } }));
+
+    // Patches put data into runs, so the runs end right before them
+    u8 value = 0x42;
+    provider.addPatch(0x300, &value, sizeof(value));
+
+    std::tie(region, zero) = provider.getZeroRegion(0x100);
+    TEST_ASSERT(zero && region == (Region { 0x100, 0x200 }));
+    std::tie(region, zero) = provider.getZeroRegion(0x300);
+    TEST_ASSERT(!zero);
+    std::tie(region, zero) = provider.getZeroRegion(0x301);
+    TEST_ASSERT(zero && region == (Region { 0x301, 0x1FF }));
+
+    TEST_ASSERT(hex::prv::getSearchableRegions(&provider, { 0, 0x1000 }, 4, 1) == Regions({ { 0, 0x104 }, { 0x2FC, 0x508 }, { 0x80C, 0x7F4 } }));
+
+    TEST_SUCCESS();
+};
@@ -4,6 +4,22 @@
 #include <hex/helpers/http_requests.hpp>
 #include <wolv/io/file.hpp>
 #include <hex/helpers/fs.hpp>
+#include <hex/helpers/gdb.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
+
+#if defined(OS_LINUX) || defined(OS_MACOS)
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
 
 using namespace std::literals::string_literals;
 
@@ -52,4 +68,267 @@ TEST_SEQUENCE("ContentAPI") {
         TEST_FAIL();
 
     TEST_SUCCESS();
-};
\ No newline at end of file
+};
+
+#if defined(OS_LINUX) || defined(OS_MACOS)
+
+namespace {
+
+    /**
+     * @brief Minimal GDB stub on a local port that serves reads and writes of a block of memory
+     *
+     * Like real stubs, binary replies are cut short once they would exceed the advertised packet size
+     * and hex encoded replies use run length encoding. The reply to reads of corruptedAddress gets a wrong checksum
+     */
+    class GDBStub {
+    public:
+        GDBStub(std::vector<u8> memory, std::string features, size_t packetSize, std::optional<u64> corruptedAddress = std::nullopt)
+            : m_memory(std::move(memory)), m_features(std::move(features)), m_packetSize(packetSize), m_corruptedAddress(corruptedAddress) {
+            this->m_listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+            sockaddr_in address = { };
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port        = 0;
+
+            socklen_t addressSize = sizeof(address);
+            ::bind(this->m_listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+            ::listen(this->m_listenFd, 1);
+            ::getsockname(this->m_listenFd, reinterpret_cast<sockaddr *>(&address), &addressSize);
+            this->m_port = ntohs(address.sin_port);
+
+            this->m_thread = std::thread([this] {
+                const int connection = ::accept(this->m_listenFd, nullptr, nullptr);
+                if (connection < 0)
+                    return;
+
+                this->serve(connection);
+                ::close(connection);
+            });
+        }
+
+        ~GDBStub() {
+            ::shutdown(this->m_listenFd, SHUT_RDWR);
+            ::close(this->m_listenFd);
+            this->m_thread.join();
+        }
+
+        [[nodiscard]] u16 getPort() const { return this->m_port; }
+
+    private:
+        static u8 checksum(const std::string &data) {
+            u8 result = 0;
+            for (char c : data)
+                result += u8(c);
+
+            return result;
+        }
+
+        static std::string encodeRunLength(const std::string &data) {
+            std::string result;
+            for (size_t i = 0; i < data.size();) {
+                size_t count = 1;
+                while (i + count < data.size() && data[i + count] == data[i] && count < 97)
+                    count++;
+
+                // Repeat counts that would turn into a '#' or '$' aren't allowed
+                const size_t repeats = count - 1;
+                result += data[i];
+                if (repeats >= 3 && repeats + 29 != '#' && repeats + 29 != '$') {
+                    result += '*';
+                    result += char(repeats + 29);
+                } else {
+                    result.append(repeats, data[i]);
+                }
+
+                i += count;
+            }
+
+            return result;
+        }
+
+        void reply(int connection, const std::string &payload, bool corrupted) const {
+            const auto packet = hex::format("${}#{:02x}", payload, u8(checksum(payload) + (corrupted ? 1 : 0)));
+            ::send(connection, packet.data(), packet.size(), 0);
+        }
+
+        [[nodiscard]] bool isCorruptedRead(const std::string &packet) const {
+            if (!this->m_corruptedAddress.has_value() || packet.empty() || (packet[0] != 'm' && packet[0] != 'x'))
+                return false;
+
+            u64 address = 0;
+            std::from_chars(packet.data() + 1, packet.data() + packet.size(), address, 16);
+
+            return address == *this->m_corruptedAddress;
+        }
+
+        std::string handle(const std::string &packet) {
+            if (packet.starts_with("qSupported"))
+                return this->m_features;
+            if (packet == "QStartNoAckMode")
+                return "OK";
+
+            u64 address = 0, size = 0;
+            const auto separator = packet.find(',');
+            if (packet.size() < 2 || separator == std::string::npos)
+                return "";
+
+            std::from_chars(packet.data() + 1, packet.data() + separator, address, 16);
+            std::from_chars(packet.data() + separator + 1, packet.data() + packet.size(), size, 16);
+            if (address + size > this->m_memory.size())
+                return "E01";
+
+            if (packet[0] == 'm') {
+                std::string data;
+                for (u64 i = 0; i < size; i++)
+                    data += hex::format("{:02x}", this->m_memory[address + i]);
+
+                return encodeRunLength(data);
+            } else if (packet[0] == 'x') {
+                std::string data = "b";
+                for (u64 i = 0; i < size; i++) {
+                    const char c = char(this->m_memory[address + i]);
+                    const bool escape = c == '#' || c == '$' || c == '}' || c == '*';
+                    if (data.size() + (escape ? 2 : 1) > this->m_packetSize)
+                        break;
+
+                    if (escape) {
+                        data += '}';
+                        data += char(c ^ 0x20);
+                    } else {
+                        data += c;
+                    }
+                }
+
+                // Like gdbserver, run length encode the data after it was escaped
+                return encodeRunLength(data);
+            } else if (packet[0] == 'M') {
+                const auto bytes = hex::parseHexString(packet.substr(packet.find(':') + 1));
+                std::copy(bytes.begin(), bytes.end(), this->m_memory.begin() + address);
+
+                return "OK";
+            }
+
+            return "";
+        }
+
+        void serve(int connection) {
+            bool noAckMode = false;
+
+            std::string buffer;
+            while (true) {
+                char data[0x1000];
+                const auto received = ::recv(connection, data, sizeof(data), 0);
+                if (received <= 0)
+                    return;
+
+                buffer.append(data, received);
+
+                // Requests are handled one after another, no matter how many of them were sent at once
+                while (true) {
+                    const auto start = buffer.find('$');
+                    const auto end   = buffer.find('#', start);
+                    if (start == std::string::npos || end == std::string::npos || end + 2 >= buffer.size())
+                        break;
+
+                    const auto packet = buffer.substr(start + 1, end - start - 1);
+                    buffer.erase(0, end + 3);
+
+                    if (!noAckMode)
+                        ::send(connection, "+", 1, 0);
+
+                    // Resuming the target doesn't get a reply until it stops again
+                    if (packet == "vCont;c")
+                        continue;
+
+                    this->reply(connection, this->handle(packet), this->isCorruptedRead(packet));
+                    if (packet == "QStartNoAckMode")
+                        noAckMode = true;
+                }
+            }
+        }
+
+        std::vector<u8> m_memory;
+        std::string m_features;
+        size_t m_packetSize;
+        std::optional<u64> m_corruptedAddress;
+
+        int m_listenFd = -1;
+        u16 m_port = 0;
+        std::thread m_thread;
+    };
+
+}
+
+#endif
+
+TEST_SEQUENCE("GDBClient") {
+    #if defined(OS_LINUX) || defined(OS_MACOS)
+        constexpr static size_t PacketSize = 0x1000;
+
+        std::mt19937 random(0x1337);
+        std::vector<u8> memory(0x10'0000);
+        std::generate(memory.begin(), memory.end(), [&] { return u8(random()); });
+
+        // Long runs of the same byte get run length encoded
+        std::fill_n(memory.begin() + 0x2000, 0x1000, 0x00);
+
+        // In binary replies, a run may directly follow an escaped byte. Here a '}' gets escaped to "}]" and the following ']' bytes
+        // extend that run. Runs of bytes that need escaping can't be run length encoded at all
+        memory[0x3000] = '}';
+        std::fill_n(memory.begin() + 0x3001, 0x40, ']');
+        std::fill_n(memory.begin() + 0x3041, 0x40, '*');
+
+        for (bool binary : { false, true }) {
+            GDBStub stub(memory, hex::format("PacketSize={:x};QStartNoAckMode+{}", PacketSize, binary ? ";binary-upload+" : ""), PacketSize);
+
+            hex::gdb::Client client;
+            TEST_ASSERT(client.connect("127.0.0.1", stub.getPort()));
+            TEST_ASSERT(client.getPacketSize() == PacketSize);
+            TEST_ASSERT(client.isBinaryUploadSupported() == binary);
+            client.continueExecution();
+
+            // Needs many pipelined requests, some of which return less data than requested
+            auto data = client.readMemory(0x123, 0x8'0000);
+            TEST_ASSERT(std::equal(data.begin(), data.end(), memory.begin() + 0x123, memory.begin() + 0x123 + 0x8'0000) && data.size() == 0x8'0000);
+
+            std::vector<u8> written(0x3000);
+            std::iota(written.begin(), written.end(), 0x00);
+            TEST_ASSERT(client.writeMemory(0x4567, written.data(), written.size()));
+            TEST_ASSERT(client.readMemory(0x4567, written.size()) == written);
+
+            // Failed reads must not leave any replies behind that would be mistaken for the reply to the next request
+            TEST_ASSERT(client.readMemory(memory.size() - 0x10'000, 0x20'000).empty());
+            TEST_ASSERT(client.readMemory(0x10, 0x10) == std::vector<u8>(memory.begin() + 0x10, memory.begin() + 0x20));
+
+            // Ranges of a batch are all pipelined together. A failing range must not affect the ones after it
+            const std::array<hex::gdb::Client::MemoryRange, 3> ranges = {{
+                { 0x10, 0x2000 },
+                { memory.size() - 0x10, 0x20 },
+                { 0x5'0000, 0x3000 }
+            }};
+            auto batch = client.readMemory(ranges);
+            TEST_ASSERT(batch.size() == ranges.size());
+            TEST_ASSERT(batch[0] == std::vector<u8>(memory.begin() + 0x10, memory.begin() + 0x2010));
+            TEST_ASSERT(batch[1].empty());
+            TEST_ASSERT(batch[2] == std::vector<u8>(memory.begin() + 0x5'0000, memory.begin() + 0x5'3000));
+
+            client.disconnect();
+        }
+
+        // The stub never sends a packet again once acknowledgements are turned off. If the client kept using the connection
+        // after a reply with a wrong checksum, every following reply would be taken as the reply to the wrong request
+        {
+            GDBStub stub(memory, hex::format("PacketSize={:x};QStartNoAckMode+", PacketSize), PacketSize, 0x1000);
+
+            hex::gdb::Client client;
+            TEST_ASSERT(client.connect("127.0.0.1", stub.getPort()));
+            TEST_ASSERT(client.readMemory(0x10, 0x10) == std::vector<u8>(memory.begin() + 0x10, memory.begin() + 0x20));
+
+            TEST_ASSERT(client.readMemory(0x1000, 0x4000).empty());
+            TEST_ASSERT(!client.isConnected());
+        }
+    #endif
+
+    TEST_SUCCESS();
+};
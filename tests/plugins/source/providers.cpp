@@ -0,0 +1,303 @@
+#include <hex/test/tests.hpp>
+#include <hex/test/test_provider.hpp>
+
+#include <hex/helpers/utils.hpp>
+
+#include <content/providers/elf_core_provider.hpp>
+#include <content/providers/view_provider.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <wolv/io/file.hpp>
+#include <wolv/utils/guards.hpp>
+#include <wolv/utils/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+    class WritableTestProvider : public hex::test::TestProvider {
+    public:
+        using TestProvider::TestProvider;
+
+        [[nodiscard]] bool isWritable() const override { return true; }
+    };
+
+    /**
+     * @brief Program header of a 64 bit ELF file
+     */
+    struct ProgramHeader {
+        u32 type;
+        u32 flags;
+        u64 offset;
+        u64 address;
+        u64 fileSize;
+        u64 memorySize;
+    };
+
+    template<typename T>
+    void writeField(std::vector<u8> &data, u64 offset, T value) {
+        value = hex::changeEndianess(value, std::endian::little);
+        std::memcpy(data.data() + offset, &value, sizeof(value));
+    }
+
+    /**
+     * @brief Builds a little endian 64 bit ELF core file with the program headers directly following the ELF header
+     * @param headers Program headers to add
+     * @param size Size of the file. Segment data has to be filled in by the caller
+     */
+    std::vector<u8> buildElfCore(const std::vector<ProgramHeader> &headers, size_t size) {
+        constexpr static u64 ElfHeaderSize = 0x40, ProgramHeaderSize = 0x38;
+
+        std::vector<u8> data(std::max<size_t>(size, ElfHeaderSize + headers.size() * ProgramHeaderSize));
+
+        std::memcpy(data.data(), "\x7F" "ELF", 4);
+        data[0x04] = 2;    // 64 bit
+        data[0x05] = 1;    // Little endian
+        data[0x06] = 1;    // Version
+
+        writeField<u16>(data, 0x10, 4);    // Core file
+        writeField<u16>(data, 0x12, 0x3E);
+        writeField<u32>(data, 0x14, 1);
+        writeField<u64>(data, 0x20, ElfHeaderSize);
+        writeField<u16>(data, 0x34, ElfHeaderSize);
+        writeField<u16>(data, 0x36, ProgramHeaderSize);
+        writeField<u16>(data, 0x38, headers.size());
+
+        for (size_t i = 0; i < headers.size(); i++) {
+            const u64 header = ElfHeaderSize + i * ProgramHeaderSize;
+            writeField<u32>(data, header + 0x00, headers[i].type);
+            writeField<u32>(data, header + 0x04, headers[i].flags);
+            writeField<u64>(data, header + 0x08, headers[i].offset);
+            writeField<u64>(data, header + 0x10, headers[i].address);
+            writeField<u64>(data, header + 0x20, headers[i].fileSize);
+            writeField<u64>(data, header + 0x28, headers[i].memorySize);
+        }
+
+        return data;
+    }
+
+}
+
+TEST_SEQUENCE("ViewProvider") {
+    using hex::Region;
+
+    std::vector<u8> data(0x100);
+    std::iota(data.begin(), data.end(), 0x00);
+
+    WritableTestProvider parent(&data);
+
+    hex::plugin::builtin::ViewProvider view;
+    view.setProvider(0x10, 0x40, &parent);
+
+    std::array<u8, 0x40> buffer = { };
+
+    // Reads are forwarded to the window of the parent
+    view.read(0x00, buffer.data(), buffer.size());
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.end(), data.begin() + 0x10));
+
+    std::fill(buffer.begin(), buffer.end(), 0xCC);
+    const hex::prv::Provider::ReadRequest requests[] = {
+        { 0x08, 4, buffer.data() },
+        { 0x3C, 4, buffer.data() + 4 },
+        { 0x3E, 4, buffer.data() + 8 },    // reaches past the end of the view
+    };
+    view.readv(requests, true);
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.begin() + 4, data.begin() + 0x18));
+    TEST_ASSERT(std::equal(buffer.begin() + 4, buffer.begin() + 8, data.begin() + 0x4C));
+    TEST_ASSERT(std::all_of(buffer.begin() + 8, buffer.end(), [](u8 value) { return value == 0xCC; }));
+
+    // Parents without any information about their validity are valid up to their end
+    auto [region, valid] = view.getRegionValidity(0x08);
+    TEST_ASSERT(valid && region == (Region { 0x08, 0x38 }));
+
+    view.resize(0x100);
+    std::tie(region, valid) = view.getRegionValidity(0x08);
+    TEST_ASSERT(valid && region == (Region { 0x08, 0xE8 }));
+    std::tie(region, valid) = view.getRegionValidity(0xF0);
+    TEST_ASSERT(!valid && region == Region::Invalid());
+    view.resize(0x40);
+
+    // Patches of the parent show up in the view, patches of the view are layered on top of them without reaching the parent
+    u8 value = 0xAA;
+    parent.addPatch(0x20, &value, sizeof(value));
+
+    value = 0x55;
+    view.write(0x05, &value, sizeof(value));
+    value = 0xBB;
+    view.write(0x10, &value, sizeof(value));
+    view.write(0x3F, buffer.data(), 2);    // reaches past the end of the view
+
+    view.read(0x00, buffer.data(), buffer.size());
+    TEST_ASSERT(buffer[0x05] == 0x55);
+    TEST_ASSERT(buffer[0x10] == 0xBB);
+    TEST_ASSERT(buffer[0x3F] == 0x4F);
+
+    parent.read(0x10, buffer.data(), buffer.size());
+    TEST_ASSERT(buffer[0x05] == 0x15);
+    TEST_ASSERT(buffer[0x10] == 0xAA);
+    TEST_ASSERT(data[0x15] == 0x15 && data[0x20] == 0x20);
+    TEST_ASSERT(view.isSavable());
+
+    // Saving writes the patches of the view through to the parent
+    view.save();
+    TEST_ASSERT(view.getPatches().empty());
+    TEST_ASSERT(data[0x15] == 0x55 && data[0x20] == 0xBB);
+    TEST_ASSERT(data[0x4F] == 0x4F && data[0x50] == 0x50);
+
+    // The patch of the parent still takes precedence over what got written into its data
+    view.read(0x00, buffer.data(), buffer.size());
+    TEST_ASSERT(buffer[0x05] == 0x55);
+    TEST_ASSERT(buffer[0x10] == 0xAA);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ElfCoreProvider") {
+    using hex::Region;
+    using hex::plugin::builtin::ElfCoreProvider;
+
+    constexpr static u32 TypeLoad = 1, TypeNote = 4;
+
+    const auto CorePath = std::fs::current_path() / "core.elf";
+    ON_SCOPE_EXIT { std::fs::remove(CorePath); };
+
+    const auto openCore = [&](const std::vector<u8> &data, ElfCoreProvider &provider) {
+        {
+            wolv::io::File file(CorePath, wolv::io::File::Mode::Create);
+            file.writeBuffer(data.data(), data.size());
+        }
+
+        provider.loadSettings({ { "path", wolv::util::toUTF8String(CorePath) }, { "baseAddress", 0 }, { "currPage", 0 } });
+        return provider.open();
+    };
+
+    // Segments are listed out of order, the note segment isn't part of the address space
+    const std::vector<ProgramHeader> headers = {
+        { TypeNote, 0, 0xE8,  0x0000, 0x00, 0x00 },
+        { TypeLoad, 6, 0x120, 0x2000, 0x10, 0x10 },
+        { TypeLoad, 5, 0x100, 0x1000, 0x20, 0x40 },    // Only the first half of the segment is stored in the file
+    };
+
+    auto core = buildElfCore(headers, 0x130);
+    std::iota(core.begin() + 0x100, core.begin() + 0x120, 0x80);
+    std::fill(core.begin() + 0x120, core.begin() + 0x130, 0x22);
+
+    std::vector<u8> buffer(0x40);
+
+    {
+        ElfCoreProvider provider;
+        TEST_ASSERT(openCore(core, provider));
+        TEST_ASSERT(provider.isAvailable());
+        TEST_ASSERT(provider.getActualSize() == 0x2010);
+
+        // Segments are mapped to their virtual address, the parts that aren't in the file read as zero
+        provider.read(0x1000, buffer.data(), 0x40);
+        TEST_ASSERT(std::equal(buffer.begin(), buffer.begin() + 0x20, core.begin() + 0x100));
+        TEST_ASSERT(std::all_of(buffer.begin() + 0x20, buffer.end(), [](u8 value) { return value == 0x00; }));
+
+        std::fill(buffer.begin(), buffer.end(), 0xCC);
+        provider.read(0x1FF8, buffer.data(), 0x10);
+        TEST_ASSERT(std::all_of(buffer.begin(), buffer.begin() + 0x08, [](u8 value) { return value == 0x00; }));
+        TEST_ASSERT(std::all_of(buffer.begin() + 0x08, buffer.begin() + 0x10, [](u8 value) { return value == 0x22; }));
+
+        // Only addresses covered by segments are valid
+        auto [region, valid] = provider.getRegionValidity(0x0000);
+        TEST_ASSERT(!valid && region == (Region { 0x0000, 0x1000 }));
+        std::tie(region, valid) = provider.getRegionValidity(0x1010);
+        TEST_ASSERT(valid && region == (Region { 0x1010, 0x30 }));
+        std::tie(region, valid) = provider.getRegionValidity(0x1040);
+        TEST_ASSERT(!valid && region == (Region { 0x1040, 0xFC0 }));
+        std::tie(region, valid) = provider.getRegionValidity(0x2000);
+        TEST_ASSERT(valid && region == (Region { 0x2000, 0x10 }));
+        std::tie(region, valid) = provider.getRegionValidity(0x2010);
+        TEST_ASSERT(!valid && region == Region::Invalid());
+
+        // Gaps between segments and segment data that isn't in the file are known to be zero
+        auto [zeroRegion, zero] = provider.getZeroRegion(0x1000);
+        TEST_ASSERT(!zero && zeroRegion == (Region { 0x1000, 0x20 }));
+        std::tie(zeroRegion, zero) = provider.getZeroRegion(0x1020);
+        TEST_ASSERT(zero && zeroRegion == (Region { 0x1020, 0x20 }));
+        std::tie(zeroRegion, zero) = provider.getZeroRegion(0x1040);
+        TEST_ASSERT(zero && zeroRegion == (Region { 0x1040, 0xFC0 }));
+        std::tie(zeroRegion, zero) = provider.getZeroRegion(0x2000);
+        TEST_ASSERT(!zero && zeroRegion == (Region { 0x2000, 0x10 }));
+    }
+
+    // Truncated core dumps keep the address space of their segments, the missing data reads as zero
+    {
+        auto truncated = core;
+        truncated.resize(0x128);
+
+        ElfCoreProvider provider;
+        TEST_ASSERT(openCore(truncated, provider));
+        TEST_ASSERT(provider.getActualSize() == 0x2010);
+
+        std::fill(buffer.begin(), buffer.end(), 0xCC);
+        provider.read(0x2000, buffer.data(), 0x10);
+        TEST_ASSERT(std::all_of(buffer.begin(), buffer.begin() + 0x08, [](u8 value) { return value == 0x22; }));
+        TEST_ASSERT(std::all_of(buffer.begin() + 0x08, buffer.begin() + 0x10, [](u8 value) { return value == 0x00; }));
+
+        auto [zeroRegion, zero] = provider.getZeroRegion(0x2008);
+        TEST_ASSERT(zero && zeroRegion == (Region { 0x2008, 0x08 }));
+
+        auto [region, valid] = provider.getRegionValidity(0x2008);
+        TEST_ASSERT(valid && region == (Region { 0x2008, 0x08 }));
+    }
+
+    // Overlapping segments are cut back so the one starting at the lower address takes precedence
+    {
+        auto overlapping = headers;
+        overlapping.push_back({ TypeLoad, 4, 0x100, 0x1020, 0x20, 0x40 });
+
+        ElfCoreProvider provider;
+        TEST_ASSERT(openCore(buildElfCore(overlapping, 0x130), provider));
+        TEST_ASSERT(provider.getActualSize() == 0x2010);
+
+        auto [region, valid] = provider.getRegionValidity(0x1000);
+        TEST_ASSERT(valid && region == (Region { 0x1000, 0x40 }));
+        std::tie(region, valid) = provider.getRegionValidity(0x1040);
+        TEST_ASSERT(valid && region == (Region { 0x1040, 0x20 }));
+        std::tie(region, valid) = provider.getRegionValidity(0x1060);
+        TEST_ASSERT(!valid && region == (Region { 0x1060, 0xFA0 }));
+    }
+
+    // Files whose headers are cut off or broken get rejected
+    {
+        const auto modified = [&](const std::function<void(std::vector<u8> &)> &modify) {
+            auto data = core;
+            modify(data);
+            return data;
+        };
+
+        const std::vector<std::vector<u8>> brokenCores = {
+            modified([](auto &data) { data.resize(0x08); }),                           // Smaller than the identification
+            modified([](auto &data) { data.resize(0x30); }),                           // Cut off ELF header
+            modified([](auto &data) { data.resize(0x90); }),                           // Cut off program headers
+            modified([](auto &data) { data[0x00] = 0x00; }),                           // Wrong magic
+            modified([](auto &data) { data[0x04] = 3; }),                              // Unknown class
+            modified([](auto &data) { data[0x05] = 3; }),                              // Unknown byte order
+            modified([](auto &data) { writeField<u16>(data, 0x10, 2); }),              // Executable instead of a core file
+            modified([](auto &data) { writeField<u16>(data, 0x36, 0x20); }),           // Program headers too small for a 64 bit file
+            modified([](auto &data) { writeField<u64>(data, 0x20, ~u64(0)); }),        // Program headers past the end of the file
+            modified([](auto &data) { writeField<u16>(data, 0x38, 0xFFFE); }),         // More program headers than the file holds
+            buildElfCore({ headers[0] }, 0x130),                                        // No loadable segments
+        };
+
+        for (const auto &brokenCore : brokenCores) {
+            ElfCoreProvider provider;
+            TEST_ASSERT(!openCore(brokenCore, provider));
+            TEST_ASSERT(!provider.isAvailable());
+            TEST_ASSERT(!provider.getErrorMessage().empty());
+        }
+    }
+
+    TEST_SUCCESS();
+};